@@ -0,0 +1,166 @@
+#include "ABScheduler.h"
+
+#include <cmath>
+#include <format>
+#include <iostream>
+
+ABScheduler::ABScheduler(const std::string& candidateA, const std::string& candidateB, const std::vector<std::string>& pool, Mutable<SeedGenerator>& seeder, int budget, double margin)
+    :candidateA{ candidateA }, candidateB{ candidateB }, seeder{ seeder }, budget{ budget }, margin{ margin }, issued{ 0 }, units{ 0 },
+    complete{ 0 }, dropped{ 0 }, sum{ 0.0 }, sumSquares{ 0.0 }, sideSum{ 0.0, 0.0 }, sideSquares{ 0.0, 0.0 }, decision{ 0 }, llr{ 0.0 } {
+    for (const std::string& cmd : pool) {
+        Opponent opponent;
+        opponent.cmd = cmd;
+        opponents.push_back(opponent);
+    }
+}
+
+void ABScheduler::startUnit() {
+    int unit = units++;
+    int opponent = unit % (int)opponents.size();
+    open[unit].opponent = opponent;
+
+    //getSeed hands the same seed out once per seat, counting the seats, the same as -s
+    for (int seat = 0; seat < 2; ++seat) {
+        std::vector<int> seedRotate = seeder.get().getSeed(2);
+        for (int side = 0; side < 2; ++side) {
+            GameOrder order;
+            order.players = { side == 0 ? candidateA : candidateB, opponents[opponent].cmd };
+            order.seed = seedRotate[0];
+            order.rotation = seedRotate[1] % 2;
+            order.tag = unit * 2 + side;
+            queue.push_back(order);
+        }
+    }
+}
+
+bool ABScheduler::next(GameOrder& order) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (decision != 0 || opponents.empty()) return false;
+
+    //a unit is only worth starting if all four of its games fit in the budget
+    if (queue.empty()) {
+        if (issued + 4 > budget) return false;
+        startUnit();
+    }
+
+    order = queue.front();
+    queue.pop_front();
+    issued++;
+    order.game = issued;
+    return true;
+}
+
+void ABScheduler::report(const GameOrder& order, const std::vector<int>& scores) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto found = open.find(order.tag / 2);
+    if (found == open.end()) return;
+    Unit& unit = found->second;
+    int side = order.tag % 2;
+
+    unit.reported++;
+    if (scores.size() < 2) {
+        unit.failed = true;
+    }
+    else {
+        double points = scores[0] > scores[1] ? 1.0 : (scores[0] < scores[1] ? 0.0 : 0.5);
+        if (side == 0) unit.a += points;
+        else unit.b += points;
+    }
+    if (unit.reported < 4) return;
+
+    if (unit.failed) {
+        dropped++;
+    }
+    else {
+        //B - A in points per game, the seed and seat luck is in both and cancels out
+        double difference = (unit.b - unit.a) / 2.0;
+        complete++;
+        sum += difference;
+        sumSquares += difference * difference;
+
+        //the same games counted as if they were two separate runs, for the comparison at the end
+        sideSum[0] += unit.a;
+        sideSum[1] += unit.b;
+        sideSquares[0] += unit.a * unit.a;
+        sideSquares[1] += unit.b * unit.b;
+
+        Opponent& opponent = opponents[unit.opponent];
+        opponent.a += unit.a;
+        opponent.b += unit.b;
+        opponent.units++;
+
+        test();
+    }
+    open.erase(found);
+}
+
+void ABScheduler::test() {
+    if (margin <= 0.0 || complete < MIN_UNITS) return;
+
+    double n = (double)complete;
+    double mean = sum / n;
+    double variance = (sumSquares - n * mean * mean) / (n - 1.0);
+    if (variance <= 0.0) return;
+
+    //Wald's test on normal differences, H0 mean 0 against H1 mean margin
+    llr = margin / variance * (sum - n * margin / 2.0);
+    double bound = std::log((1.0 - 0.05) / 0.05);
+    if (llr >= bound) decision = 1;
+    else if (llr <= -bound) decision = -1;
+}
+
+void ABScheduler::print() {
+    /*
+    +----------------------+-------+---------+---------+----------+
+    | Opponent             | Units | A score | B score | B - A    |
+    +----------------------+-------+---------+---------+----------+
+    | bot_v12.exe          | 25    | 52.00%  | 58.00%  | +6.00%   |
+    +----------------------+-------+---------+---------+----------+
+    */
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::string separator = "+----------------------+-------+---------+---------+----------+";
+    std::cout << "A/B comparison, A: " << candidateA << ", B: " << candidateB << std::endl;
+    std::cout << separator << std::endl;
+    std::cout << "| Opponent             | Units | A score | B score | B - A    |" << std::endl;
+    std::cout << separator << std::endl;
+    for (const Opponent& opponent : opponents) {
+        std::string name = opponent.cmd.size() > 20 ? "..." + opponent.cmd.substr(opponent.cmd.size() - 17) : opponent.cmd;
+        std::cout << std::format("| {:<21}| {:<6}|", name, opponent.units);
+        if (opponent.units > 0) {
+            double games = 2.0 * opponent.units;
+            std::cout << std::format(" {:<8}| {:<8}| {:<9}|", std::format("{:.2f}%", 100.0 * opponent.a / games), std::format("{:.2f}%", 100.0 * opponent.b / games),
+                std::format("{:+.2f}%", 100.0 * (opponent.b - opponent.a) / games));
+        }
+        else {
+            std::cout << std::format(" {:<8}| {:<8}| {:<9}|", "-", "-", "-");
+        }
+        std::cout << std::endl;
+        std::cout << separator << std::endl;
+    }
+
+    if (complete >= 2) {
+        double n = (double)complete;
+        double mean = sum / n;
+        double paired = (sumSquares - n * mean * mean) / (n - 1.0);
+        std::cout << std::format("{} units of 4 games, B - A: {:+.2f}% +/- {:.2f}% (95%).", complete, 100.0 * mean, 100.0 * 1.96 * std::sqrt(paired / n)) << std::endl;
+
+        //two separate runs: the unit difference would be the difference of independent unit scores
+        double unpaired = 0.0;
+        for (int side = 0; side < 2; ++side) {
+            double sideMean = sideSum[side] / n;
+            unpaired += (sideSquares[side] - n * sideMean * sideMean) / (n - 1.0) / 4.0;
+        }
+        if (paired > 0.0) {
+            std::cout << std::format("Two separate runs would need about {:.1f} times as many games for the same interval.", unpaired / paired) << std::endl;
+        }
+    }
+
+    if (margin > 0.0) {
+        std::string verdict = decision > 0 ? "B is better." : (decision < 0 ? "B is no better." : "undecided.");
+        std::cout << std::format("SPRT B - A = 0 against B - A = {:.2f}%: LLR {:.2f}, bounds +/- {:.2f}, ", 100.0 * margin, llr, std::log(0.95 / 0.05)) << verdict << std::endl;
+    }
+    if (dropped > 0) {
+        std::cout << dropped << " units were dropped, one of their games gave no result." << std::endl;
+    }
+}
@@ -0,0 +1,99 @@
+#ifndef ABSCHEDULER_H
+#define ABSCHEDULER_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <mutex>
+#include "Scheduler.h"
+#include "SeedGenerator.h"
+#include "Mutable.h"
+
+/*
+ * @brief Class describing a paired A/B comparison: two candidates playing the very same games against a pool of opponents.
+ *
+ * Games go out in units of four: one seed from SeedGenerator::getSeed(), played from both seats like with -s, once by A
+ * and once by B against the same opponent. The unit's result is B's points minus A's, so the luck of the seed and
+ * the seat cancels out and far fewer games are needed than with two separate runs.
+ *
+ * With a SPRT margin set, the run stops as soon as the sequential test decides between "B is no better" (delta 0) and
+ * "B is better by the margin", at 5% error each way.
+ */
+class ABScheduler : public Scheduler {
+private:
+    /*
+     * @brief Struct describing one unit of four games.
+     */
+    struct Unit {
+        int opponent = 0;           //< the opponent index
+        double a = 0.0;             //< A's points, a draw counting 0.5
+        double b = 0.0;             //< B's points
+        int reported = 0;           //< games reported so far
+        bool failed = false;        //< a game gave no result, the unit is dropped
+    };
+
+    /*
+     * @brief Struct describing the totals against one opponent.
+     */
+    struct Opponent {
+        std::string cmd;            //< the command line
+        double a = 0.0;             //< A's points
+        double b = 0.0;             //< B's points
+        int units = 0;              //< complete units
+    };
+
+    std::string candidateA;                 //< the A command line
+    std::string candidateB;                 //< the B command line
+    std::vector<Opponent> opponents;        //< the pool
+    Mutable<SeedGenerator>& seeder;         //< Shared rng seeder.
+    int budget;                             //< the most games to hand out
+    double margin;                          //< the SPRT alternative, B - A in points per game, 0 for no test
+    int issued;                             //< games handed out so far
+    int units;                              //< units started so far
+
+    std::deque<GameOrder> queue;            //< games of the started units not handed out yet
+    std::map<int, Unit> open;               //< units not complete yet, by unit number
+
+    int complete;                           //< complete units
+    int dropped;                            //< units with a failed game
+    double sum;                             //< sum of the unit differences
+    double sumSquares;                      //< sum of the squared unit differences
+    double sideSum[2];                      //< A's and B's points per complete unit, summed
+    double sideSquares[2];                  //< and summed squared, for the variance of two separate runs
+
+    int decision;                           //< the SPRT decision, 0 running, 1 B is better, -1 B is no better
+    double llr;                             //< the SPRT log likelihood ratio
+    std::mutex m_mutex;                     //< Mutex protecting everything above.
+
+    const static int MIN_UNITS = 10;        //< units before the SPRT may decide, the variance needs a few
+
+    /*
+     * @brief Starts the next unit, queueing its four games.
+     */
+    void startUnit();
+
+    /*
+     * @brief Updates the SPRT after a complete unit.
+     */
+    void test();
+
+public:
+    /*
+     * @brief Constructs an ABScheduler object.
+     *
+     * @param candidateA the A command line.
+     * @param candidateB the B command line.
+     * @param pool the opponents command lines.
+     * @param seeder the shared rng seeder.
+     * @param budget the most games to play.
+     * @param margin the SPRT alternative, B - A in points per game, ex. 0.05. 0 to play the whole budget.
+     */
+    ABScheduler(const std::string& candidateA, const std::string& candidateB, const std::vector<std::string>& pool, Mutable<SeedGenerator>& seeder, int budget, double margin);
+
+    bool next(GameOrder& order) override;
+    void report(const GameOrder& order, const std::vector<int>& scores) override;
+    void print() override;
+};
+
+#endif
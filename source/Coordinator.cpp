@@ -0,0 +1,232 @@
+//select() on windows takes at most FD_SETSIZE sockets, 64 by default, one farm may have more workers
+#define FD_SETSIZE 1024
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include "Coordinator.h"
+
+#include <sstream>
+#include <algorithm>
+
+#pragma comment(lib, "ws2_32.lib")
+
+Coordinator::Coordinator(Scheduler& scheduler, Mutable<PlayerStats>& playerStats, int playersCount, const std::string& token, Level verbose)
+    :Threadable{ }, scheduler{ scheduler }, playerStats{ playerStats }, playersCount{ playersCount }, token{ token }, logger{ Logger(verbose) },
+    listener{ INVALID_SOCKET }, exhausted{ false }, completed{ 0 } {}
+
+Coordinator::~Coordinator() {
+    for (Worker& worker : workers) {
+        closesocket((SOCKET)worker.socket);
+    }
+    if ((SOCKET)listener != INVALID_SOCKET) {
+        closesocket((SOCKET)listener);
+        WSACleanup();
+    }
+}
+
+Logger& Coordinator::getLog() { return logger; }
+
+bool Coordinator::listen(const std::string& address, int port) {
+    sockaddr_in local = {};
+    local.sin_family = AF_INET;
+    local.sin_port = htons((u_short)port);
+    if (inet_pton(AF_INET, address.c_str(), &local.sin_addr) != 1) return false;
+
+    WSADATA data;
+    if (WSAStartup(MAKEWORD(2, 2), &data) != 0) return false;
+
+    SOCKET s = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (s == INVALID_SOCKET) {
+        WSACleanup();
+        return false;
+    }
+
+    if (bind(s, (sockaddr*)&local, sizeof(local)) == SOCKET_ERROR || ::listen(s, SOMAXCONN) == SOCKET_ERROR) {
+        closesocket(s);
+        WSACleanup();
+        return false;
+    }
+
+    listener = (std::uintptr_t)s;
+    return true;
+}
+
+bool Coordinator::send(Worker& worker, const std::string& text) {
+    size_t sent = 0;
+    while (sent < text.size()) {
+        int written = ::send((SOCKET)worker.socket, text.data() + sent, (int)(text.size() - sent), 0);
+        if (written == SOCKET_ERROR) return false;
+        sent += written;
+    }
+    return true;
+}
+
+bool Coordinator::isPending() const {
+    for (const Worker& worker : workers) {
+        if (!worker.units.empty()) return true;
+    }
+    return false;
+}
+
+void Coordinator::drop(Worker& worker) {
+    closesocket((SOCKET)worker.socket);
+    worker.socket = (std::uintptr_t)INVALID_SOCKET;
+
+    for (auto& unit : worker.units) {
+        reclaimed.push_back(unit.second);
+    }
+    std::string logString = "Worker " + worker.address + " dropped after " + std::to_string(worker.played) + " games, ";
+    logString += std::to_string(worker.units.size()) + " games it held go to the other workers.";
+    logger.addLog(worker.units.empty() ? Level::INFO : Level::WARN, logString);
+    worker.units.clear();
+}
+
+bool Coordinator::handle(Worker& worker, const std::string& line) {
+    if (!worker.trusted) {
+        //every character is compared, so the time taken tells nothing about the token
+        std::string given = line.rfind("hello ", 0) == 0 ? line.substr(6) : "";
+        unsigned char difference = given.size() == token.size() ? 0 : 1;
+        for (size_t i = 0; i < given.size() && i < token.size(); ++i) difference |= given[i] ^ token[i];
+        worker.trusted = difference == 0 && !token.empty();
+        return worker.trusted;
+    }
+
+    std::istringstream fields(line);
+    std::string type;
+    fields >> type;
+
+    if (type == "next") {
+        GameOrder order;
+        bool found = false;
+        if (!reclaimed.empty()) {
+            order = reclaimed.front();
+            reclaimed.pop_front();
+            found = true;
+        }
+        else if (!exhausted) {
+            found = scheduler.next(order);
+            exhausted = !found;
+        }
+
+        if (!found) {
+            //a game still out may come back if its worker drops
+            return send(worker, isPending() ? "wait\n" : "done\n");
+        }
+
+        std::string message = "game " + std::to_string(order.game) + " " + std::to_string(order.seed) + " ";
+        message += std::to_string(order.rotation) + " " + std::to_string(order.tag) + " " + std::to_string(order.players.size()) + "\n";
+        for (const std::string& player : order.players) {
+            message += player + "\n";
+        }
+        worker.units[order.game] = order;
+        logger.addLog(Level::VERBOSE, "Game " + std::to_string(order.game) + " handed to worker " + worker.address + ".");
+        return send(worker, message);
+    }
+
+    if (type == "result") {
+        int game = 0;
+        int count = 0;
+        fields >> game >> count;
+        std::vector<int> scores;
+        for (int score = 0; fields >> score;) {
+            scores.push_back(score);
+        }
+        auto found = worker.units.find(game);
+        if (fields.bad() || found == worker.units.end() || (int)scores.size() != count) return false;
+
+        //the workers keep their own PlayerStats, the run's table is added up here
+        if (!scores.empty()) playerStats.get().add(scores);
+        scheduler.report(found->second, scores);
+        worker.units.erase(found);
+        worker.played++;
+        completed++;
+
+        std::string logString = "Game " + std::to_string(game) + " from worker " + worker.address;
+        logString += scores.empty() ? " failed." : ", " + std::to_string(completed) + " results in.";
+        logger.addLog(Level::INFO, logString);
+        return true;
+    }
+
+    return false;
+}
+
+void Coordinator::run() {
+    char buffer[4096];
+
+    while (!shouldStop()) {
+        //over once the scheduler is out of games and nothing is held by a worker
+        if (exhausted && reclaimed.empty() && !isPending()) break;
+
+        fd_set readable;
+        FD_ZERO(&readable);
+        FD_SET((SOCKET)listener, &readable);
+        for (const Worker& worker : workers) {
+            FD_SET((SOCKET)worker.socket, &readable);
+        }
+        timeval timeout = { 0, 200000 };
+        if (select(0, &readable, NULL, NULL, &timeout) == SOCKET_ERROR) {
+            logger.addLog(Level::ERR, "Coordinator select failed: " + std::to_string(WSAGetLastError()) + ".");
+            break;
+        }
+
+        if (FD_ISSET((SOCKET)listener, &readable)) {
+            sockaddr_in address = {};
+            int length = sizeof(address);
+            SOCKET s = accept((SOCKET)listener, (sockaddr*)&address, &length);
+            if (s != INVALID_SOCKET && (int)workers.size() < FD_SETSIZE - 1) {
+                //the units are small and latency bound
+                BOOL noDelay = TRUE;
+                setsockopt(s, IPPROTO_TCP, TCP_NODELAY, (const char*)&noDelay, sizeof(noDelay));
+
+                char name[INET_ADDRSTRLEN] = "";
+                inet_ntop(AF_INET, &address.sin_addr, name, sizeof(name));
+                Worker worker;
+                worker.socket = (std::uintptr_t)s;
+                worker.address = std::string(name) + ":" + std::to_string(ntohs(address.sin_port));
+                if (send(worker, "hello " + std::to_string(playersCount) + "\n")) {
+                    logger.addLog(Level::INFO, "Worker " + worker.address + " connected.");
+                    workers.push_back(worker);
+                }
+                else {
+                    closesocket(s);
+                }
+            }
+            else if (s != INVALID_SOCKET) {
+                closesocket(s);
+            }
+        }
+
+        for (Worker& worker : workers) {
+            if (!FD_ISSET((SOCKET)worker.socket, &readable)) continue;
+
+            int received = recv((SOCKET)worker.socket, buffer, sizeof(buffer), 0);
+            if (received <= 0) {
+                drop(worker);
+                continue;
+            }
+            worker.input.append(buffer, received);
+
+            size_t end;
+            while ((end = worker.input.find('\n')) != std::string::npos) {
+                std::string line = worker.input.substr(0, end);
+                worker.input.erase(0, end + 1);
+                if (!line.empty() && line.back() == '\r') line.pop_back();
+                bool trusted = worker.trusted;
+                if (!handle(worker, line)) {
+                    logger.addLog(Level::WARN, "Worker " + worker.address + (trusted ? " sent \"" + line + "\"" : " did not give the run's token") + ", dropping it.");
+                    drop(worker);
+                    break;
+                }
+            }
+        }
+        workers.erase(std::remove_if(workers.begin(), workers.end(), [](const Worker& worker) { return (SOCKET)worker.socket == INVALID_SOCKET; }), workers.end());
+    }
+
+    //the workers still asking learn the run is over from the closed connection
+    for (Worker& worker : workers) {
+        closesocket((SOCKET)worker.socket);
+    }
+    workers.clear();
+    logger.addLog(Level::INFO, "Coordinator done, " + std::to_string(completed) + " results from the workers.");
+
+    setFinished();
+}
@@ -0,0 +1,133 @@
+#ifndef COORDINATOR_H
+#define COORDINATOR_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <cstdint>
+#include "Threadable.h"
+#include "Scheduler.h"
+#include "PlayerStats.h"
+#include "Mutable.h"
+#include "Logger.h"
+
+/*
+ * @brief Class describing the Coordinator, handing a Scheduler's games out to worker processes over TCP instead of to local game threads.
+ *
+ * A worker is this program started with -worker host:port. It runs its own game threads, asks for one game at a time per
+ * thread and sends each result back. The protocol is plain text, one message per line:
+ *
+ *   coordinator: hello <players>                          once, right after the worker connects
+ *   worker:      hello <token>                            once, nothing is handed out before the run's token
+ *   worker:      next
+ *   coordinator: game <game> <seed> <rotation> <tag> <count>, then one player command line per line
+ *                wait                                     nothing to hand out until another worker reports or drops
+ *                done                                     the run is over
+ *   worker:      result <game> <count> <score>...         count 0 if the game failed
+ *
+ * When a worker drops, the games it held go to the next workers asking, before anything new from the Scheduler. A worker
+ * giving a wrong token, or anything else first, is dropped.
+ */
+class Coordinator : public Threadable {
+private:
+    /*
+     * @brief Struct describing one connected worker.
+     */
+    struct Worker {
+        std::uintptr_t socket;              //< the SOCKET, kept out of this header so it does not pull in winsock2.h after windows.h
+        std::string address;                //< the worker's address, for the logs
+        std::string input;                  //< received, not a whole line yet
+        std::map<int, GameOrder> units;     //< the games handed out, not reported yet, by game number
+        int played = 0;                     //< results received
+        bool trusted = false;               //< the worker gave the run's token
+    };
+
+    Scheduler& scheduler;                   //< The scheduler picking the games.
+    Mutable<PlayerStats>& playerStats;      //< Shared Player Stats.
+    int playersCount;                       //< the players per game
+    std::string token;                      //< the token the workers must give before getting any game
+    Logger logger;                          //< The log object.
+
+    std::uintptr_t listener;                //< the listening SOCKET
+    std::vector<Worker> workers;            //< the connected workers
+    std::deque<GameOrder> reclaimed;        //< games of dropped workers, handed out first
+    bool exhausted;                         //< the scheduler has nothing more
+    int completed;                          //< results received from all workers
+
+    /*
+     * @brief Handles one line from a worker.
+     *
+     * @param worker the worker.
+     * @param line the line.
+     *
+     * @return false if the worker broke the protocol or cannot be written to.
+     */
+    bool handle(Worker& worker, const std::string& line);
+
+    /*
+     * @brief Sends text to a worker, all of it.
+     *
+     * @param worker the worker.
+     * @param text the text.
+     *
+     * @return success true or false.
+     */
+    bool send(Worker& worker, const std::string& text);
+
+    /*
+     * @brief Closes a worker's connection and takes its games back.
+     *
+     * @param worker the worker.
+     */
+    void drop(Worker& worker);
+
+    /*
+     * @brief Checks if there is anything out with a worker.
+     *
+     * @return true if a worker holds a game.
+     */
+    bool isPending() const;
+
+protected:
+    /*
+     * @brief The run method from the Threadable base class we must overide.
+     */
+    void run() override;
+
+public:
+    /*
+     * @brief Constructs a Coordinator object.
+     *
+     * @param scheduler the scheduler picking the games.
+     * @param playerStats the shared player stats, the results are added to it.
+     * @param playersCount the players per game.
+     * @param token the token the workers must give, see RemoteScheduler::connect.
+     * @param verbose The verbosity to use for the logs.
+     */
+    Coordinator(Scheduler& scheduler, Mutable<PlayerStats>& playerStats, int playersCount, const std::string& token, Level verbose);
+
+    /*
+     * @brief Destructs the Coordinator object.
+     */
+    ~Coordinator();
+
+    /*
+     * @brief Starts listening for workers. Call before start().
+     *
+     * @param address the IPv4 address of the interface to listen on, ex. 127.0.0.1 for this machine only or 0.0.0.0 for all.
+     * @param port the TCP port.
+     *
+     * @return success true or false, false if the address is not an IPv4 address.
+     */
+    bool listen(const std::string& address, int port);
+
+    /*
+     * @brief Gets the log.
+     *
+     * @return the log.
+     */
+    Logger& getLog();
+};
+
+#endif
@@ -0,0 +1,258 @@
+#include "Daemon.h"
+
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include <sddl.h>
+
+#pragma comment(lib, "advapi32.lib")
+
+namespace {
+    /*
+     * @brief Reads one line from a pipe.
+     *
+     * @param pipe the pipe.
+     * @param input received, not read as a line yet, kept between calls.
+     * @param line Set to the line, without the line feed.
+     *
+     * @return success true or false, false if the pipe is closed.
+     */
+    bool readLine(HANDLE pipe, std::string& input, std::string& line) {
+        size_t end;
+        while ((end = input.find('\n')) == std::string::npos) {
+            char buffer[4096];
+            DWORD read = 0;
+            if (!ReadFile(pipe, buffer, sizeof(buffer), &read, NULL) || read == 0) return false;
+            input.append(buffer, read);
+        }
+        line = input.substr(0, end);
+        input.erase(0, end + 1);
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        return true;
+    }
+
+    /*
+     * @brief Writes all of a text to a pipe.
+     *
+     * @param pipe the pipe.
+     * @param text the text.
+     *
+     * @return success true or false.
+     */
+    bool writeText(HANDLE pipe, const std::string& text) {
+        DWORD written = 0;
+        return WriteFile(pipe, text.data(), (DWORD)text.size(), &written, NULL) && written == text.size();
+    }
+
+    /*
+     * @brief Makes a security descriptor only letting the current user open the pipe.
+     *
+     * @return the descriptor, to free with LocalFree, NULL on error.
+     */
+    PSECURITY_DESCRIPTOR currentUserOnly() {
+        HANDLE token = NULL;
+        if (!OpenProcessToken(GetCurrentProcess(), TOKEN_QUERY, &token)) return NULL;
+
+        DWORD size = 0;
+        GetTokenInformation(token, TokenUser, NULL, 0, &size);
+        std::vector<char> user(size);
+        char* sid = NULL;
+        PSECURITY_DESCRIPTOR descriptor = NULL;
+        if (size > 0 && GetTokenInformation(token, TokenUser, user.data(), size, &size) && ConvertSidToStringSidA(((TOKEN_USER*)user.data())->User.Sid, &sid)) {
+            //a protected DACL with a single entry, nothing is inherited, not even the administrators get in
+            std::string sddl = "D:P(A;;GA;;;" + std::string(sid) + ")";
+            ConvertStringSecurityDescriptorToSecurityDescriptorA(sddl.c_str(), SDDL_REVISION_1, &descriptor, NULL);
+            LocalFree(sid);
+        }
+        CloseHandle(token);
+        return descriptor;
+    }
+}
+
+Daemon::Daemon(JobScheduler& jobs, const std::string& name, int playersCount, bool fixedReferee, Level verbose)
+    :Threadable{ }, jobs{ jobs }, cache{ NULL }, pipeName{ "\\\\.\\pipe\\" + name }, playersCount{ playersCount }, fixedReferee{ fixedReferee },
+    accepted{ 0 }, logger{ Logger(verbose) } {}
+
+void Daemon::setResultCache(ResultCache* cache) {
+    this->cache = cache;
+}
+
+Logger& Daemon::getLog() { return logger; }
+
+void Daemon::run() {
+    //the jobs run their referee and players as this user, so only this user may submit them, and only from this machine
+    PSECURITY_DESCRIPTOR descriptor = currentUserOnly();
+    if (descriptor == NULL) {
+        logger.addLog(Level::ERR, "Cannot restrict the pipe " + pipeName + " to the current user, error " + std::to_string(GetLastError()) + ".");
+    }
+    SECURITY_ATTRIBUTES security = { sizeof(SECURITY_ATTRIBUTES), descriptor, FALSE };
+
+    while (descriptor != NULL && !shouldStop()) {
+        HANDLE client = CreateNamedPipeA(pipeName.c_str(), PIPE_ACCESS_DUPLEX, PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS,
+            PIPE_UNLIMITED_INSTANCES, 4096, 4096, 0, &security);
+        if (client == INVALID_HANDLE_VALUE) {
+            logger.addLog(Level::ERR, "Cannot create the pipe " + pipeName + ", error " + std::to_string(GetLastError()) + ".");
+            break;
+        }
+
+        //a client may connect between CreateNamedPipe and ConnectNamedPipe
+        if (!ConnectNamedPipe(client, NULL) && GetLastError() != ERROR_PIPE_CONNECTED) {
+            CloseHandle(client);
+            continue;
+        }
+        if (!serve(client)) break;
+    }
+    if (descriptor != NULL) LocalFree(descriptor);
+
+    //the jobs in progress still finish, then the game threads end
+    jobs.shutdown();
+    logger.addLog(Level::INFO, "Daemon stopped after " + std::to_string(accepted) + " jobs.");
+    setFinished();
+}
+
+bool Daemon::serve(HANDLE client) {
+    std::string input;
+    std::string line;
+    std::string error;
+    Job job;
+    bool complete = false;
+
+    while (error.empty() && !complete && readLine(client, input, line)) {
+        std::istringstream fields(line);
+        std::string type;
+        fields >> type;
+        std::string rest = line.size() > type.size() + 1 ? line.substr(type.size() + 1) : "";
+
+        if (type == "shutdown") {
+            writeText(client, "done 0\n");
+            FlushFileBuffers(client);
+            DisconnectNamedPipe(client);
+            CloseHandle(client);
+            logger.addLog(Level::INFO, "Daemon shutdown asked by a client.");
+            return false;
+        }
+        else if (type == "referee") job.referee = rest;
+        else if (type == "player") job.players.push_back(rest);
+        else if (type == "swap") job.swap = true;
+        else if (type == "run") complete = true;
+        else if (type == "games") {
+            if (!(fields >> job.n) || job.n < 0) error = "the number of games is not valid";
+        }
+        else if (type == "seed") {
+            if (!(fields >> job.seed)) error = "the seed is not valid";
+            job.seeded = true;
+        }
+        else {
+            error = "unknown line " + line;
+        }
+    }
+
+    if (error.empty() && complete) {
+        if ((int)job.players.size() != playersCount) {
+            error = "the daemon plays " + std::to_string(playersCount) + " player games, the job has " + std::to_string(job.players.size()) + " players";
+        }
+        else if (job.referee.empty() && !fixedReferee) {
+            error = "the job has no referee";
+        }
+    }
+
+    if (!complete || !error.empty()) {
+        if (!error.empty()) {
+            writeText(client, "error " + error + "\n");
+            FlushFileBuffers(client);
+            logger.addLog(Level::WARN, "Job refused: " + error + ".");
+        }
+        DisconnectNamedPipe(client);
+        CloseHandle(client);
+        return true;
+    }
+
+    //the plugin referees every game, the cache must not key the games by a referee that does not play them
+    if (fixedReferee) job.referee = "";
+
+    //a bot may have been rebuilt since the last job
+    if (cache != NULL) cache->refresh();
+
+    int id = jobs.submit(job, client);
+    accepted++;
+    std::string logString = "Job " + std::to_string(id) + ": " + std::to_string(job.n) + " games of";
+    for (const std::string& player : job.players) {
+        logString += " " + player;
+    }
+    logger.addLog(Level::INFO, logString + ".");
+    return true;
+}
+
+bool Daemon::submit(const std::string& name, const Job* job, PlayerStats& stats, Logger& logger) {
+    std::string pipeName = "\\\\.\\pipe\\" + name;
+    HANDLE pipe = INVALID_HANDLE_VALUE;
+    for (int attempt = 0; attempt < 10 && pipe == INVALID_HANDLE_VALUE; ++attempt) {
+        pipe = CreateFileA(pipeName.c_str(), GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_EXISTING, 0, NULL);
+        //every instance busy with another client for a moment
+        if (pipe == INVALID_HANDLE_VALUE && (GetLastError() != ERROR_PIPE_BUSY || !WaitNamedPipeA(pipeName.c_str(), 1000))) break;
+    }
+    if (pipe == INVALID_HANDLE_VALUE) {
+        logger.addLog(Level::FATAL, "Cannot reach the daemon at " + pipeName + ".");
+        return false;
+    }
+
+    std::string request;
+    if (job == NULL) {
+        request = "shutdown\n";
+    }
+    else {
+        request = "referee " + job->referee + "\n";
+        for (const std::string& player : job->players) {
+            request += "player " + player + "\n";
+        }
+        request += "games " + std::to_string(job->n) + "\n";
+        if (job->swap) request += "swap\n";
+        if (job->seeded) request += "seed " + std::to_string(job->seed) + "\n";
+        request += "run\n";
+    }
+    if (!writeText(pipe, request)) {
+        CloseHandle(pipe);
+        logger.addLog(Level::FATAL, "Cannot send the job to the daemon.");
+        return false;
+    }
+
+    std::string input;
+    std::string line;
+    bool done = false;
+    while (!done && readLine(pipe, input, line)) {
+        std::istringstream fields(line);
+        std::string type;
+        int number = 0;
+        fields >> type >> number;
+
+        if (type == "accepted") {
+            int ahead = 0;
+            fields >> ahead;
+            logger.addLog(Level::INFO, "Job " + std::to_string(number) + " accepted, sharing the daemon with " + std::to_string(ahead) + " other jobs.");
+        }
+        else if (type == "result") {
+            std::vector<int> scores;
+            for (int score = 0; fields >> score;) {
+                scores.push_back(score);
+            }
+            stats.add(scores);
+            logger.addLog(Level::INFO, "End of game " + std::to_string(number) + "\t" + stats.toString());
+        }
+        else if (type == "failed") {
+            logger.addLog(Level::WARN, "Game " + std::to_string(number) + " gave no result.");
+        }
+        else if (type == "done") {
+            done = true;
+        }
+        else if (type == "error") {
+            logger.addLog(Level::FATAL, "The daemon refused the job: " + line.substr(std::min(line.size(), (size_t)6)) + ".");
+            break;
+        }
+    }
+    CloseHandle(pipe);
+
+    if (!done && job != NULL) {
+        logger.addLog(Level::ERR, "Lost the daemon before the end of the job.");
+    }
+    return done;
+}
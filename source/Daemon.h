@@ -0,0 +1,94 @@
+#ifndef DAEMON_H
+#define DAEMON_H
+
+#include <string>
+#include <windows.h>
+#include "Threadable.h"
+#include "JobScheduler.h"
+#include "ResultCache.h"
+#include "PlayerStats.h"
+#include "Logger.h"
+
+/*
+ * @brief Class describing the Daemon, taking jobs from clients over a named pipe for game threads that stay up between jobs.
+ *
+ * A client is this program started with -job <name>. It sends its job as lines, then reads the progress until done:
+ *
+ *   client: referee <command line>
+ *           player <command line>                one per player, in player order
+ *           games <n>
+ *           swap                                 optional, rotate the seats
+ *           seed <seed>                          optional, the first seed
+ *           run                                  or shutdown instead of all the above, to stop the daemon
+ *   daemon: accepted <job> <jobs ahead>          or error <reason>
+ *           result <game> <score>...             one per game, the job's own game numbers, in the order they end
+ *           failed <game>
+ *           done <games>
+ *
+ * The mode, the limits, the threads and the cache are the daemon's, a job only brings its bots and its seeds.
+ */
+class Daemon : public Threadable {
+private:
+    JobScheduler& jobs;                     //< The scheduler the jobs go to.
+    ResultCache* cache;                     //< Shared result cache, NULL if not used.
+    std::string pipeName;                   //< the full pipe name, \\.\pipe\<name>
+    int playersCount;                       //< the players per game of the game threads
+    bool fixedReferee;                      //< the threads have their referee built in, ex. a plugin, a job's referee is ignored
+    int accepted;                           //< jobs accepted
+    Logger logger;                          //< The log object.
+
+    /*
+     * @brief Reads a client's job and submits it, or answers the error.
+     *
+     * @param client the client's pipe, handed to the JobScheduler with the job.
+     *
+     * @return false if the client asked for a shutdown.
+     */
+    bool serve(HANDLE client);
+
+protected:
+    /*
+     * @brief The run method from the Threadable base class we must overide.
+     */
+    void run() override;
+
+public:
+    /*
+     * @brief Constructs a Daemon object.
+     *
+     * @param jobs the scheduler the jobs go to.
+     * @param name the pipe name, without \\.\pipe\.
+     * @param playersCount the players per game of the game threads.
+     * @param fixedReferee the threads ignore the job's referee.
+     * @param verbose The verbosity to use for the logs.
+     */
+    Daemon(JobScheduler& jobs, const std::string& name, int playersCount, bool fixedReferee, Level verbose);
+
+    /*
+     * @brief Sets the result cache, its hashes are refreshed for every job so a rebuilt bot gets fresh games.
+     *
+     * @param cache the shared result cache, NULL if not used.
+     */
+    void setResultCache(ResultCache* cache);
+
+    /*
+     * @brief Gets the log.
+     *
+     * @return the log.
+     */
+    Logger& getLog();
+
+    /*
+     * @brief Sends a job to a daemon and adds up its results as they come in.
+     *
+     * @param name the pipe name, without \\.\pipe\.
+     * @param job the job, or NULL to shut the daemon down.
+     * @param stats Filled with the job's results.
+     * @param logger Gets the progress.
+     *
+     * @return success true or false.
+     */
+    static bool submit(const std::string& name, const Job* job, PlayerStats& stats, Logger& logger);
+};
+
+#endif
@@ -0,0 +1,11 @@
+#include "ExePath.h"
+
+#include <windows.h>
+
+std::filesystem::path ExePath::directory() {
+    wchar_t path_exe[MAX_PATH];
+    GetModuleFileName(NULL, path_exe, MAX_PATH);
+    return std::filesystem::path(path_exe).parent_path();
+}
+
+std::filesystem::path ExePath::resolve(const std::filesystem::path& path) { return directory() / path; }
@@ -0,0 +1,29 @@
+#ifndef EXEPATH_H
+#define EXEPATH_H
+
+#include <filesystem>
+
+/*
+ * @brief Class describing where the tester finds its files. Process::start runs the executables from next to the
+ * tester, and the logs, the journal and the other outputs go next to it too, whatever the working directory.
+ */
+class ExePath {
+public:
+    /*
+     * @brief Gets the directory of the tester's executable.
+     *
+     * @return the directory.
+     */
+    static std::filesystem::path directory();
+
+    /*
+     * @brief Resolves a path next to the tester's executable. An absolute path is kept as it is.
+     *
+     * @param path the path, ex. the log directory.
+     *
+     * @return the resolved path.
+     */
+    static std::filesystem::path resolve(const std::filesystem::path& path);
+};
+
+#endif
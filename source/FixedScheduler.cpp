@@ -0,0 +1,32 @@
+#include "FixedScheduler.h"
+
+FixedScheduler::FixedScheduler(const std::vector<std::string>& playersCmd, Mutable<SeedGenerator>& seeder, int n, bool swap)
+    :playersCmd{ playersCmd }, seeder{ seeder }, n{ n }, swap{ swap }, issued{ 0 } {}
+
+bool FixedScheduler::next(GameOrder& order) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (issued >= n) return false;
+
+    int playersCount = (int)playersCmd.size();
+    order.players = playersCmd;
+    order.tag = 0;
+    if (swap) {
+        std::vector<int> seedRotate = seeder.get().getSeed(playersCount);
+        order.seed = seedRotate[0];
+        order.rotation = seedRotate[1] % playersCount;
+    }
+    else {
+        order.seed = seeder.get().nextSeed();
+        order.rotation = 0;
+    }
+
+    issued++;
+    order.game = issued;
+    return true;
+}
+
+void FixedScheduler::report(const GameOrder& order, const std::vector<int>& scores) {
+    //the game threads add the scores to PlayerStats, there is nothing to pick from them
+}
+
+void FixedScheduler::print() {}
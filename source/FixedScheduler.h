@@ -0,0 +1,43 @@
+#ifndef FIXEDSCHEDULER_H
+#define FIXEDSCHEDULER_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include "Scheduler.h"
+#include "SeedGenerator.h"
+#include "Mutable.h"
+
+/*
+ * @brief Class describing the plain run as a Scheduler: the one lineup n times, seated the way the game threads seat it.
+ *
+ * The game threads do this on their own when they have no scheduler. The coordinator needs every game as a work unit
+ * it can hand out and hand out again, so it uses this instead. Every game gets an explicit seed, so a unit played
+ * twice is the same game.
+ */
+class FixedScheduler : public Scheduler {
+private:
+    std::vector<std::string> playersCmd;    //< the lineup
+    Mutable<SeedGenerator>& seeder;         //< Shared rng seeder.
+    int n;                                  //< the number of games
+    bool swap;                              //< rotate the seats, one seed played from each
+    int issued;                             //< games handed out so far
+    std::mutex m_mutex;                     //< Mutex protecting everything above.
+
+public:
+    /*
+     * @brief Constructs a FixedScheduler object.
+     *
+     * @param playersCmd the players command lines.
+     * @param seeder the shared rng seeder.
+     * @param n the number of games.
+     * @param swap rotate the seats like -s.
+     */
+    FixedScheduler(const std::vector<std::string>& playersCmd, Mutable<SeedGenerator>& seeder, int n, bool swap);
+
+    bool next(GameOrder& order) override;
+    void report(const GameOrder& order, const std::vector<int>& scores) override;
+    void print() override;
+};
+
+#endif
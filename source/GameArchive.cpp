@@ -0,0 +1,241 @@
+#include "GameArchive.h"
+#include "LzCodec.h"
+#include "ExePath.h"
+
+namespace {
+    void put(std::string& out, std::uint64_t value, int bytes) {
+        for (int i = 0; i < bytes; ++i) out += (char)((value >> (8 * i)) & 0xFF);
+    }
+
+    std::uint64_t get(const char* p, int bytes) {
+        std::uint64_t value = 0;
+        for (int i = 0; i < bytes; ++i) value |= (std::uint64_t)(unsigned char)p[i] << (8 * i);
+        return value;
+    }
+
+    //reads exactly size bytes at an offset, false past the end
+    bool readAt(std::ifstream& in, std::uint64_t offset, char* buffer, size_t size) {
+        in.clear();
+        in.seekg((std::streamoff)offset);
+        in.read(buffer, (std::streamsize)size);
+        return (size_t)in.gcount() == size;
+    }
+
+    const int SEGMENT_HEADER = 4 + 4;       //magic, the run's first segment
+    const int BLOCK_HEADER = 4 + 4 + 2;     //magic, game, name length
+    const int TRAILER = 8 + 4 + 4;          //index offset, block count, magic
+    const int INDEX_ENTRY = 4 + 8;          //game, offset
+}
+
+GameArchive::GameArchive() : segment{ 0 }, first{ 0 }, offset{ 0 }, raw{ 0 }, compressed{ 0 } {}
+
+GameArchive::~GameArchive() { close(); }
+
+std::filesystem::path GameArchive::segmentPath(const std::filesystem::path& dir, int segment) {
+    return dir / ("Games" + std::to_string(segment) + ".archive");
+}
+
+bool GameArchive::open(const std::string& dir) {
+    this->dir = ExePath::resolve(dir);
+
+    //append only, the segments of the runs before are kept as they are
+    std::error_code error;
+    segment = 0;
+    while (std::filesystem::exists(segmentPath(this->dir, segment + 1), error)) ++segment;
+    first = segment + 1;
+    return openSegment();
+}
+
+bool GameArchive::isOpen() const { return out.is_open(); }
+
+bool GameArchive::openSegment() {
+    ++segment;
+    index.clear();
+    out.open(segmentPath(dir, segment), std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+
+    std::string header = "BTS1";
+    put(header, (std::uint32_t)first, 4);
+    out.write(header.data(), header.size());
+    offset = header.size();
+    compressed += header.size();
+    return !out.fail();
+}
+
+void GameArchive::closeSegment() {
+    if (!out.is_open()) return;
+
+    std::string footer;
+    for (const Entry& entry : index) {
+        put(footer, (std::uint32_t)entry.game, 4);
+        put(footer, entry.offset, 8);
+    }
+    put(footer, offset, 8);
+    put(footer, index.size(), 4);
+    footer += "BTI1";
+    out.write(footer.data(), footer.size());
+    compressed += footer.size();
+    out.close();
+}
+
+void GameArchive::close() { closeSegment(); }
+
+bool GameArchive::add(int game, std::string_view name, std::string_view data) {
+    if (!out.is_open()) return false;
+
+    std::string block = "BTB1";
+    put(block, (std::uint32_t)game, 4);
+    put(block, name.size(), 2);
+    block += name;
+    std::string packed = LzCodec::compress(data);
+    put(block, data.size(), 4);
+    put(block, packed.size(), 4);
+    block += packed;
+
+    out.write(block.data(), block.size());
+    //flushed so a crashed run keeps every finished game, the footer is rebuilt by walking the blocks
+    out.flush();
+    if (out.fail()) return false;
+
+    index.push_back({ game, offset });
+    offset += block.size();
+    raw += data.size();
+    compressed += block.size();
+
+    if (offset >= SEGMENT_SIZE) {
+        closeSegment();
+        return openSegment();
+    }
+    return true;
+}
+
+double GameArchive::getRatio() const { return compressed == 0 ? 0.0 : (double)raw / compressed; }
+
+std::uint64_t GameArchive::readHeader(std::ifstream& in, int segment, int& first) {
+    char header[SEGMENT_HEADER];
+    if (readAt(in, 0, header, SEGMENT_HEADER) && std::string_view(header, 4) == "BTS1") {
+        first = (int)get(header + 4, 4);
+        return SEGMENT_HEADER;
+    }
+    //no header, the segment is its own run
+    first = segment;
+    return 0;
+}
+
+std::vector<std::uint64_t> GameArchive::findBlocks(std::ifstream& in, std::uint64_t start, int game) {
+    std::vector<std::uint64_t> offsets;
+    in.clear();
+    in.seekg(0, std::ios::end);
+    std::uint64_t size = (std::uint64_t)in.tellg();
+
+    //the footer's index when the segment was closed
+    char trailer[TRAILER];
+    if (size >= TRAILER && readAt(in, size - TRAILER, trailer, TRAILER) && std::string_view(trailer + 12, 4) == "BTI1") {
+        std::uint64_t indexOffset = get(trailer, 8);
+        std::uint64_t count = get(trailer + 8, 4);
+        if (indexOffset + count * INDEX_ENTRY + TRAILER == size) {
+            std::string entries(count * INDEX_ENTRY, '\0');
+            if (readAt(in, indexOffset, entries.data(), entries.size())) {
+                for (std::uint64_t i = 0; i < count; ++i) {
+                    if ((std::int32_t)get(entries.data() + i * INDEX_ENTRY, 4) == game) {
+                        offsets.push_back(get(entries.data() + i * INDEX_ENTRY + 4, 8));
+                    }
+                }
+                return offsets;
+            }
+        }
+    }
+
+    //no footer, walk the blocks up to the first broken one
+    std::uint64_t position = start;
+    char header[BLOCK_HEADER];
+    while (readAt(in, position, header, BLOCK_HEADER) && std::string_view(header, 4) == "BTB1") {
+        std::uint64_t nameLength = get(header + 8, 2);
+        char sizes[8];
+        if (!readAt(in, position + BLOCK_HEADER + nameLength, sizes, 8)) break;
+        std::uint64_t next = position + BLOCK_HEADER + nameLength + 8 + get(sizes + 4, 4);
+        if (next > size) break;
+
+        if ((std::int32_t)get(header + 4, 4) == game) offsets.push_back(position);
+        position = next;
+    }
+    return offsets;
+}
+
+int GameArchive::extract(const std::string& dir, int game, Logger& logger) {
+    std::filesystem::path path = ExePath::resolve(dir);
+
+    std::error_code error;
+    int last = 0;
+    while (std::filesystem::exists(segmentPath(path, last + 1), error)) ++last;
+
+    //game numbers start over every run, the newest segment holding the game tells which run
+    int newest = 0;
+    int run = 0;
+    for (int k = last; k >= 1 && newest == 0; --k) {
+        std::ifstream in(segmentPath(path, k), std::ifstream::in | std::ifstream::binary);
+        if (in.fail()) continue;
+
+        int first;
+        std::uint64_t start = readHeader(in, k, first);
+        if (!findBlocks(in, start, game).empty()) {
+            newest = k;
+            run = first;
+        }
+    }
+    if (newest == 0) return 0;
+
+    //the game's files may be spread over the segments of its run, the older ones first
+    int written = 0;
+    for (int k = run; k <= newest; ++k) {
+        std::ifstream in(segmentPath(path, k), std::ifstream::in | std::ifstream::binary);
+        if (in.fail()) continue;
+
+        int first;
+        std::uint64_t start = readHeader(in, k, first);
+        if (first != run) continue;
+
+        for (std::uint64_t position : findBlocks(in, start, game)) {
+            if (extractBlock(in, position, path, logger)) {
+                ++written;
+            }
+            else {
+                logger.addLog(Level::ERR, "A block of game " + std::to_string(game) + " is corrupt in " + segmentPath(path, k).filename().string() + ".");
+            }
+        }
+    }
+    return written;
+}
+
+bool GameArchive::extractBlock(std::ifstream& in, std::uint64_t position, const std::filesystem::path& dir, Logger& logger) {
+    in.clear();
+    in.seekg(0, std::ios::end);
+    std::uint64_t size = (std::uint64_t)in.tellg();
+
+    char header[BLOCK_HEADER];
+    char sizes[8];
+    if (!readAt(in, position, header, BLOCK_HEADER)) return false;
+    std::uint64_t nameLength = get(header + 8, 2);
+    std::uint64_t dataStart = position + BLOCK_HEADER + nameLength + 8;
+    if (dataStart > size || !readAt(in, dataStart - 8, sizes, 8)) return false;
+
+    //a corrupt size never gets allocated, the data must fit in the segment, and LzCodec checks the decompressed size
+    std::uint64_t packedSize = get(sizes + 4, 4);
+    if (packedSize > size - dataStart) return false;
+
+    std::string name(nameLength, '\0');
+    std::string packed(packedSize, '\0');
+    std::string data;
+    if (!readAt(in, position + BLOCK_HEADER, name.data(), name.size()) || !readAt(in, dataStart, packed.data(), packed.size())) return false;
+    if (!LzCodec::decompress(packed, get(sizes, 4), data)) return false;
+
+    //only a file name, a block never writes outside the log directory
+    std::filesystem::path file = dir / std::filesystem::path(name).filename();
+    std::ofstream out(file, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+    out.write(data.data(), data.size());
+    if (out.fail()) {
+        logger.addLog(Level::ERR, "Cannot write " + file.string() + ".");
+        return false;
+    }
+    logger.addLog(Level::INFO, "Extracted " + file.string() + ".");
+    return true;
+}
@@ -0,0 +1,166 @@
+#ifndef GAMEARCHIVE_H
+#define GAMEARCHIVE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fstream>
+#include <filesystem>
+#include <cstdint>
+#include "Logger.h"
+
+/*
+ * @brief Class describing the game archive, append only segments in the log directory holding each game's files as
+ * compressed blocks, in place of one file per game. Only the thread writing the game logs uses it.
+ *
+ * A segment, Games<k>.archive, starts with its header, "BTS1" and the number of its run's first segment (uint32), then
+ * a run of blocks:
+ *   "BTB1", game (int32), name length (uint16), name, size (uint32), compressed size (uint32), the LzCodec block
+ * Once it passes SEGMENT_SIZE, or when the archive closes, the segment gets its index footer:
+ *   per block game (int32) and offset (uint64), then the index offset (uint64), the block count (uint32) and "BTI1"
+ * Numbers are little endian. A segment without its footer, ex. after a crash, is read by walking its blocks.
+ * Every run starts a new segment, so the archive of an older run is never touched. A game's files may end up in
+ * several segments of its run, ex. its log before a rollover and its replay after it.
+ */
+class GameArchive {
+private:
+    /*
+     * @brief Struct describing an index entry.
+     */
+    struct Entry {
+        std::int32_t game;          //< the game number
+        std::uint64_t offset;       //< where its block starts in the segment
+    };
+
+    std::filesystem::path dir;                  //< the log directory, resolved
+    std::ofstream out;                          //< the open segment
+    int segment;                                //< the open segment's number
+    int first;                                  //< the number of this run's first segment
+    std::uint64_t offset;                       //< bytes written to the open segment
+    std::vector<Entry> index;                   //< the open segment's blocks
+
+    std::uint64_t raw;                          //< bytes handed over
+    std::uint64_t compressed;                   //< bytes written, headers included
+
+    const static std::uint64_t SEGMENT_SIZE = 256ull * 1024 * 1024;    //< segment size before the next one starts
+
+    /*
+     * @brief Writes the open segment's index footer and closes it.
+     */
+    void closeSegment();
+
+    /*
+     * @brief Starts the next segment.
+     *
+     * @return success true or false.
+     */
+    bool openSegment();
+
+    /*
+     * @brief Gets the path of a segment.
+     *
+     * @param dir the resolved log directory.
+     * @param segment the segment number.
+     *
+     * @return the path.
+     */
+    static std::filesystem::path segmentPath(const std::filesystem::path& dir, int segment);
+
+    /*
+     * @brief Reads a segment's header.
+     *
+     * @param in the segment.
+     * @param segment the segment number.
+     * @param first Set to the number of the first segment of the run that wrote it.
+     *
+     * @return where its blocks start.
+     */
+    static std::uint64_t readHeader(std::ifstream& in, int segment, int& first);
+
+    /*
+     * @brief Gets the offsets of a game's blocks in a segment, from its footer or by walking its blocks.
+     *
+     * @param in the segment.
+     * @param start where its blocks start.
+     * @param game the game number.
+     *
+     * @return the offsets.
+     */
+    static std::vector<std::uint64_t> findBlocks(std::ifstream& in, std::uint64_t start, int game);
+
+    /*
+     * @brief Writes a block back to the log directory. Its sizes are checked against the segment before anything is
+     * allocated.
+     *
+     * @param in the segment.
+     * @param position where the block starts.
+     * @param dir the resolved log directory.
+     * @param logger the log to report to.
+     *
+     * @return true if the file was written.
+     */
+    static bool extractBlock(std::ifstream& in, std::uint64_t position, const std::filesystem::path& dir, Logger& logger);
+
+public:
+    /*
+     * @brief Constructs a closed GameArchive object.
+     */
+    GameArchive();
+
+    /*
+     * @brief Destructs the GameArchive object, closing the open segment.
+     */
+    ~GameArchive();
+
+    /*
+     * @brief Opens the archive, starting a segment after the ones already in the directory. Relative directories are
+     * resolved next to the executable, like the logs.
+     *
+     * @param dir The log directory.
+     * @return true if the segment was created, false otherwise.
+     */
+    bool open(const std::string& dir);
+
+    /*
+     * @brief Checks if the archive is open.
+     *
+     * @return true or false.
+     */
+    bool isOpen() const;
+
+    /*
+     * @brief Compresses a game's file into the archive.
+     *
+     * @param game the game number.
+     * @param name the file name, ex. Game12.log, what extract() writes it back as.
+     * @param data the file content.
+     *
+     * @return success true or false.
+     */
+    bool add(int game, std::string_view name, std::string_view data);
+
+    /*
+     * @brief Closes the open segment, index footer included.
+     */
+    void close();
+
+    /*
+     * @brief Gets the compression ratio so far.
+     *
+     * @return the bytes handed over per byte written, 0 if nothing was.
+     */
+    double getRatio() const;
+
+    /*
+     * @brief Writes a game's files back to the log directory, from the segments of the newest run holding it.
+     *
+     * @param dir The log directory.
+     * @param game the game number.
+     * @param logger the log to report to.
+     *
+     * @return the number of files written, 0 if the game is not in the archive.
+     */
+    static int extract(const std::string& dir, int game, Logger& logger);
+};
+
+#endif
@@ -0,0 +1,192 @@
+#include "GameLogWriter.h"
+#include "ExePath.h"
+
+#include <vector>
+#include <format>
+
+GameLogWriter::GameLogWriter(size_t cap, Level verbose)
+    :Threadable{ }, cap{ cap }, logger{ Logger(verbose) }, queued{ 0 }, files{ 0 }, failed{ 0 }, truncated{ 0 }, archive{ NULL } {}
+
+Logger& GameLogWriter::getLog() { return logger; }
+
+void GameLogWriter::setArchive(GameArchive* archive) { this->archive = archive; }
+
+bool GameLogWriter::open(const std::string& dir) {
+    this->dir = ExePath::resolve(dir);
+
+    std::error_code error;
+    return std::filesystem::is_directory(this->dir, error);
+}
+
+void GameLogWriter::write(int game, const std::string& line) {
+    std::unique_lock<std::mutex> lock(m_queue);
+
+    //over the cap the line is only counted, it never takes any memory
+    Shard& shard = shards[game];
+    if (shard.written + line.size() + 1 > cap) {
+        shard.dropped++;
+        shard.droppedBytes += line.size() + 1;
+        return;
+    }
+    shard.written += line.size() + 1;
+
+    m_space.wait(lock, [this] { return queued < QUEUE_CAP || shouldStop(); });
+    queue.push_back({ game, false, line + "\n", "" });
+    queued += line.size() + 1;
+    lock.unlock();
+    m_cv.notify_one();
+}
+
+void GameLogWriter::close(int game) {
+    {
+        std::lock_guard<std::mutex> lock(m_queue);
+        auto it = shards.find(game);
+        if (it == shards.end()) return;
+
+        std::string text;
+        if (it->second.dropped > 0) {
+            text = "[Log truncated at " + std::to_string(cap / 1024) + " KB: " + std::to_string(it->second.dropped) + " lines, ";
+            text += std::to_string(it->second.droppedBytes) + " bytes dropped.]\n";
+            truncated++;
+        }
+        shards.erase(it);
+
+        //the end of a log always goes in, the thread is then sure to close the file
+        queue.push_back({ game, true, text, "" });
+        queued += text.size();
+    }
+    m_cv.notify_one();
+}
+
+void GameLogWriter::writeFile(int game, const std::string& name, std::string data) {
+    std::unique_lock<std::mutex> lock(m_queue);
+    m_space.wait(lock, [this] { return queued < QUEUE_CAP || shouldStop(); });
+    queued += data.size();
+    queue.push_back({ game, false, std::move(data), name });
+    lock.unlock();
+    m_cv.notify_one();
+}
+
+bool GameLogWriter::hasArchive() const { return archive != NULL; }
+
+void GameLogWriter::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(m_queue);
+        setStop();
+    }
+    m_cv.notify_one();
+    m_space.notify_all();
+}
+
+void GameLogWriter::flush(std::deque<Entry>& batch, std::unordered_map<int, std::ofstream>& open) {
+    for (Entry& entry : batch) {
+        if (!entry.name.empty()) {
+            writeWhole(entry);
+            continue;
+        }
+        if (archive != NULL) {
+            //the lines are capped like a file, a game is at most cap bytes here
+            std::string& text = pending[entry.game];
+            text += entry.text;
+            if (entry.last) {
+                archiveGame(entry.game, text);
+                pending.erase(entry.game);
+            }
+            continue;
+        }
+
+        auto it = open.find(entry.game);
+        if (it == open.end()) {
+            //a game's file is truncated when it starts, like the master log
+            std::ofstream& out = open[entry.game];
+            out.open(dir / ("Game" + std::to_string(entry.game) + ".log"), std::ofstream::out | std::ofstream::trunc);
+            if (out.fail()) {
+                failed++;
+                logger.addLog(Level::WARN, "Cannot open the log of game " + std::to_string(entry.game) + ", its lines are lost.");
+            }
+            else {
+                files++;
+            }
+            it = open.find(entry.game);
+        }
+
+        if (it->second.is_open()) it->second << entry.text;
+        if (entry.last) {
+            it->second.close();
+            open.erase(it);
+        }
+    }
+
+    //flushed so a crashed run keeps what the games logged so far
+    for (auto& [game, out] : open) {
+        if (out.is_open()) out.flush();
+    }
+}
+
+void GameLogWriter::writeWhole(const Entry& entry) {
+    if (archive != NULL) {
+        if (!archive->add(entry.game, entry.name, entry.text)) {
+            failed++;
+            logger.addLog(Level::WARN, "Cannot archive " + entry.name + ", it is lost.");
+        }
+        return;
+    }
+
+    std::ofstream out(dir / entry.name, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+    out.write(entry.text.data(), entry.text.size());
+    if (out.fail()) {
+        failed++;
+        logger.addLog(Level::WARN, "Cannot write " + entry.name + ", it is lost.");
+    }
+}
+
+void GameLogWriter::archiveGame(int game, const std::string& text) {
+    if (archive->add(game, "Game" + std::to_string(game) + ".log", text)) {
+        files++;
+    }
+    else {
+        failed++;
+        logger.addLog(Level::WARN, "Cannot archive the log of game " + std::to_string(game) + ", its lines are lost.");
+    }
+}
+
+void GameLogWriter::run() {
+    std::unordered_map<int, std::ofstream> open;
+    std::deque<Entry> batch;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_queue);
+            m_cv.wait(lock, [this] { return !queue.empty() || shouldStop(); });
+            if (queue.empty() && shouldStop()) break;
+            batch.swap(queue);
+        }
+
+        flush(batch, open);
+        batch.clear();
+
+        //the batch counts until it is on disk, so the memory stays under the cap while the disk is slow
+        {
+            std::lock_guard<std::mutex> lock(m_queue);
+            queued = 0;
+            for (const Entry& entry : queue) queued += entry.text.size();
+        }
+        m_space.notify_all();
+    }
+
+    //games that never closed their log, ex. a thread that stopped on a fatal error
+    for (auto& [game, out] : open) {
+        if (out.is_open()) out.close();
+    }
+    for (auto& [game, text] : pending) {
+        archiveGame(game, text);
+    }
+    pending.clear();
+
+    std::string logString = "Game logs: " + std::to_string(files) + " written, " + std::to_string(truncated) + " truncated";
+    if (failed > 0) logString += ", " + std::to_string(failed) + " could not be " + (archive != NULL ? "archived" : "opened");
+    if (archive != NULL) logString += ", compressed " + std::format("{:.1f}", archive->getRatio()) + " fold";
+    logger.addLog(Level::INFO, logString + ".");
+
+    setFinished();
+}
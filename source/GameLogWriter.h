@@ -0,0 +1,165 @@
+#ifndef GAMELOGWRITER_H
+#define GAMELOGWRITER_H
+
+#include <deque>
+#include <string>
+#include <fstream>
+#include <filesystem>
+#include <unordered_map>
+#include <mutex>
+#include <condition_variable>
+#include "Threadable.h"
+#include "Logger.h"
+#include "GameArchive.h"
+
+/*
+ * @brief Class describing the game log writer, the one thread writing the logs of every game to their own file,
+ * Game<n>.log in the log directory, while the games are played.
+ *
+ * The game threads' Loggers hand it their lines with write() instead of keeping them, and close() once a game is over.
+ * Each game's log is capped, the lines over the cap are dropped and counted at the end of its file. The lines waiting
+ * for the disk are capped too, a game thread waits in write() when the disk falls behind, so the memory used does not
+ * grow with the length of the run.
+ *
+ * With an archive, a game's lines wait until the game is over and go in the archive as one compressed block instead.
+ */
+class GameLogWriter : public Threadable {
+private:
+    /*
+     * @brief Struct describing a line waiting to be written, the end of a game's log, or a whole file.
+     */
+    struct Entry {
+        int game;                   //< the game number
+        bool last;                  //< close the game's file after this one
+        std::string text;           //< the text, line breaks included
+        std::string name;           //< a whole file's name, empty for a line
+    };
+
+    /*
+     * @brief Struct describing a game whose log is still open, as seen by the game threads.
+     */
+    struct Shard {
+        size_t written;             //< bytes accepted so far
+        int dropped;                //< lines over the cap
+        size_t droppedBytes;        //< bytes over the cap
+    };
+
+    std::filesystem::path dir;                      //< the log directory, resolved
+    size_t cap;                                     //< bytes kept per game
+    Logger logger;                                  //< The log object.
+
+    std::deque<Entry> queue;                        //< Lines handed over, not written yet.
+    size_t queued;                                  //< Bytes in the queue and being written.
+    std::unordered_map<int, Shard> shards;          //< The games whose log is open.
+    std::mutex m_queue;                             //< Mutex protecting the queue, queued and shards.
+    std::condition_variable m_cv;                   //< Wakes the thread when a line is handed over or on shutdown.
+    std::condition_variable m_space;                //< Wakes the game threads when the queue was written.
+
+    int files;                                      //< Game logs written.
+    int failed;                                     //< Game logs that could not be opened.
+    int truncated;                                  //< Game logs over the cap.
+
+    GameArchive* archive;                           //< The archive the game logs go in, NULL for a file per game.
+    std::unordered_map<int, std::string> pending;   //< The lines of the games not over yet, with an archive. Only the thread uses it.
+
+    const static size_t QUEUE_CAP = 8 * 1024 * 1024;    //< bytes waiting for the disk before write() waits
+
+    /*
+     * @brief Writes a batch of entries, opening and closing the files as needed.
+     *
+     * @param batch the entries.
+     * @param open the open files by game.
+     */
+    void flush(std::deque<Entry>& batch, std::unordered_map<int, std::ofstream>& open);
+
+    /*
+     * @brief Adds a game's log to the archive.
+     *
+     * @param game the game number.
+     * @param text the log.
+     */
+    void archiveGame(int game, const std::string& text);
+
+    /*
+     * @brief Writes a whole file to the archive, or the log directory.
+     *
+     * @param entry the file.
+     */
+    void writeWhole(const Entry& entry);
+
+protected:
+    /*
+     * @brief The run method from the Threadable base class we must overide.
+     */
+    void run() override;
+
+public:
+    /*
+     * @brief Constructs a GameLogWriter object.
+     *
+     * @param cap the bytes kept per game.
+     * @param verbose The verbosity to use for the logs.
+     */
+    GameLogWriter(size_t cap, Level verbose);
+
+    /*
+     * @brief Sets the directory the game logs go in. Relative directories are resolved next to the executable, like the logs.
+     *
+     * @param dir The log directory.
+     * @return true if the directory exists, false otherwise.
+     */
+    bool open(const std::string& dir);
+
+    /*
+     * @brief Sets the archive the game logs go in, see GameArchive.h. Call before start().
+     *
+     * @param archive the open archive, NULL for a file per game.
+     */
+    void setArchive(GameArchive* archive);
+
+    /*
+     * @brief Adds a line to a game's log. Thread safe, waits while too much is waiting for the disk.
+     *
+     * @param game the game number.
+     * @param line the line, without a line break.
+     */
+    void write(int game, const std::string& line);
+
+    /*
+     * @brief Ends a game's log, noting the lines dropped over the cap. Thread safe.
+     *
+     * @param game the game number.
+     */
+    void close(int game);
+
+    /*
+     * @brief Adds a whole file of a game, ex. its replay, to the archive or the log directory. Thread safe, waits while
+     * too much is waiting for the disk. Not capped.
+     *
+     * @param game the game number.
+     * @param name the file name.
+     * @param data the file content.
+     */
+    void writeFile(int game, const std::string& name, std::string data);
+
+    /*
+     * @brief Checks if the game logs go in an archive.
+     *
+     * @return true or false.
+     */
+    bool hasArchive() const;
+
+    /*
+     * @brief Writes everything handed over so far, then ends the thread. Wait for isFinished() after.
+     */
+    void shutdown();
+
+    /*
+     * @brief Gets the log.
+     *
+     * @return the log.
+     */
+    Logger& getLog();
+};
+
+#endif
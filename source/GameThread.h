@@ -1,48 +1,69 @@
-#ifndef GAMETHREAD_H
-#define GAMETHREAD_H
-
-#include <stdexcept>
-#include "ThreadedGame.h"
-
-/*
- *
- * @brief Class describing a GameThread object. This is the current way Referees communicate with Players.
- */
-class GameThread : public ThreadedGame {
-private:
-    size_t commandSize;                 //< size of command to send to the ref
-    size_t refereeInputIdx;             //< referee input index
-    std::vector<size_t> pArgIdx;        //< player argument index
-    std::vector<std::string> command;   //< command to send to the ref
-
-public:
-    /*
-     * @brief Constructs an OldGameThread object.
-     *
-     * @param id The id.
-     * @param refereeCmd The referee command line.
-     * @param playersCmd The vector of player command lines.
-     * @param count The shared count of games.
-     * @param playerStats The playerStats object.
-     * @param seeder the shared rng seeder object.
-     * @param swap Are we swapping player positions?
-     * @param verbose The verbosity to use for the logs.
-     */
-    GameThread(int id, std::string refereeCmd, std::vector<std::string> playersCmd, Mutable<int>& count, Mutable<PlayerStats>& playerStats, Mutable<SeedGenerator>& seeder, int n, bool swap, Level verbose, std::string path, std::string file);
-
-    /*
-     * @brief Destructs the OldGameThread object.
-     */
-    ~GameThread();
-
-    /*
-     * @brief sets up the processes and calls start in the base class ThreadedGame
-     */
-    void start();
-
-    /*
-     * @brief The run method from the Threadable base class we must overide.
-     */
-    void run() override;
-};
-#endif
+#ifndef GAMETHREAD_H
+#define GAMETHREAD_H
+
+#include <stdexcept>
+#include "ThreadedGame.h"
+#include "ResultParser.h"
+#include "ReplayMover.h"
+#include "RefereeCommand.h"
+
+/*
+ *
+ * @brief Class describing a GameThread object. This is the current way Referees communicate with Players.
+ */
+class GameThread : public ThreadedGame {
+private:
+    RefereeCommand command;             //< the arguments to send to the ref
+    ResultParser parser;                //< parses the referee output, reused for every game
+    ReplayMover* replays;               //< Shared mover of the staged replays, NULL for the referee to write them to the log directory.
+
+    const static DWORD REFEREE_TIMEOUT = 300000;    //< ms the referee may stay silent, it plays the whole game before it prints
+
+    /*
+     * @brief Records the result of the game once the parser has every score: stats, journal and negative score errors.
+     *
+     * @param scores Set to the scores by player.
+     * @param error Set to true if a score is negative.
+     */
+    void recordResult(std::vector<int>& scores, bool& error);
+
+public:
+    /*
+     * @brief Constructs an OldGameThread object.
+     *
+     * @param id The id.
+     * @param refereeCmd The referee command line.
+     * @param playersCmd The vector of player command lines.
+     * @param count The shared count of games.
+     * @param playerStats The playerStats object.
+     * @param seeder the shared rng seeder object.
+     * @param journal the shared results journal.
+     * @param reaper the shared teardown thread.
+     * @param swap Are we swapping player positions?
+     * @param verbose The verbosity to use for the logs.
+     */
+    GameThread(int id, std::string refereeCmd, std::vector<std::string> playersCmd, Mutable<int>& count, Mutable<PlayerStats>& playerStats, Mutable<SeedGenerator>& seeder, ResultsJournal& journal, Reaper& reaper, int n, bool swap, Level verbose, std::string path, std::string file);
+
+    /*
+     * @brief Destructs the OldGameThread object.
+     */
+    ~GameThread();
+
+    /*
+     * @brief sets up the processes and calls start in the base class ThreadedGame
+     */
+    void start();
+
+    /*
+     * @brief Has the referee write its replay to a staging directory, see ReplayMover.h. Call before start().
+     *
+     * @param replays the shared mover, NULL for the referee to write its replay to the log directory.
+     */
+    void setReplayMover(ReplayMover* replays);
+
+    /*
+     * @brief The run method from the Threadable base class we must overide.
+     */
+    void run() override;
+};
+#endif
@@ -0,0 +1,164 @@
+#include "GauntletScheduler.h"
+
+#include <cmath>
+#include <format>
+#include <iostream>
+#include <algorithm>
+
+GauntletScheduler::GauntletScheduler(const std::string& candidate, const std::vector<std::string>& pool, Mutable<SeedGenerator>& seeder, int budget, double precision)
+    :candidate{ candidate }, seeder{ seeder }, budget{ budget }, precision{ precision }, issued{ 0 } {
+    for (const std::string& cmd : pool) {
+        Opponent opponent;
+        opponent.cmd = cmd;
+        opponents.push_back(opponent);
+    }
+}
+
+int GauntletScheduler::played(const Opponent& opponent) {
+    return opponent.wins + opponent.draws + opponent.losses;
+}
+
+bool GauntletScheduler::isSettled(const Opponent& opponent) const {
+    if (precision <= 0.0 || played(opponent) < 2) return false;
+
+    double low, high;
+    wilson(opponent.wins + 0.5 * opponent.draws, played(opponent), low, high);
+    return (high - low) / 2.0 <= precision;
+}
+
+int GauntletScheduler::pick() const {
+    int best = -1;
+    double bestGain = -1.0;
+    for (int i = 0; i < (int)opponents.size(); ++i) {
+        const Opponent& opponent = opponents[i];
+        if (isSettled(opponent)) continue;
+
+        //everyone gets a first pair before the results say anything
+        int games = played(opponent) + opponent.pending;
+        if (games == 0) return i;
+
+        //the standard error goes as sqrt(p(1-p)/n), the pair goes where it drops the most
+        double p = (opponent.wins + 0.5 * opponent.draws + 1.0) / (played(opponent) + 2.0);
+        double gain = std::sqrt(p * (1.0 - p)) * (1.0 / std::sqrt((double)games) - 1.0 / std::sqrt(games + 2.0));
+        if (gain > bestGain) {
+            bestGain = gain;
+            best = i;
+        }
+    }
+    return best;
+}
+
+bool GauntletScheduler::next(GameOrder& order) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (issued >= budget) return false;
+
+    //the swapped game of an open pair goes first, so both seats stay even
+    int chosen = -1;
+    for (int i = 0; i < (int)opponents.size(); ++i) {
+        if (opponents[i].openPair) {
+            chosen = i;
+            break;
+        }
+    }
+
+    long long seed;
+    int rotation;
+    if (chosen >= 0) {
+        opponents[chosen].openPair = false;
+        seed = opponents[chosen].pairSeed;
+        rotation = 1;
+    }
+    else {
+        chosen = pick();
+        if (chosen < 0) return false;
+        seed = seeder.get().nextSeed();
+        rotation = 0;
+        if (issued + 1 < budget) {
+            opponents[chosen].openPair = true;
+            opponents[chosen].pairSeed = seed;
+        }
+    }
+
+    opponents[chosen].pending++;
+    issued++;
+
+    order.game = issued;
+    order.players = { candidate, opponents[chosen].cmd };
+    order.seed = seed;
+    order.rotation = rotation;
+    order.tag = chosen;
+    return true;
+}
+
+void GauntletScheduler::report(const GameOrder& order, const std::vector<int>& scores) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (order.tag < 0 || order.tag >= (int)opponents.size()) return;
+
+    Opponent& opponent = opponents[order.tag];
+    opponent.pending--;
+    if (scores.size() < 2) {
+        opponent.failed++;
+    }
+    else if (scores[0] > scores[1]) {
+        opponent.wins++;
+    }
+    else if (scores[0] < scores[1]) {
+        opponent.losses++;
+    }
+    else {
+        opponent.draws++;
+    }
+}
+
+void GauntletScheduler::print() {
+    /*
+    +----------------------+-------+-------+-------+-------+---------+-------------------+
+    | Opponent             | Games | Wins  | Draws | Losses| Score   | 95% interval      |
+    +----------------------+-------+-------+-------+-------+---------+-------------------+
+    | bot_v12.exe          | 48    | 30    | 2     | 16    | 64.58%  | 50.40% - 76.58%   |
+    +----------------------+-------+-------+-------+-------+---------+-------------------+
+    */
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::string separator = "+----------------------+-------+-------+-------+-------+---------+-------------------+";
+    std::cout << "Gauntlet of " << candidate << std::endl;
+    std::cout << separator << std::endl;
+    std::cout << "| Opponent             | Games | Wins  | Draws | Losses| Score   | 95% interval      |" << std::endl;
+    std::cout << separator << std::endl;
+
+    int total = 0;
+    double widest = 0.0;
+    for (const Opponent& opponent : opponents) {
+        int games = played(opponent);
+        total += games;
+        double score = opponent.wins + 0.5 * opponent.draws;
+        double low, high;
+        wilson(score, games, low, high);
+        if (games > 0) widest = std::max(widest, (high - low) / 2.0);
+
+        std::string name = opponent.cmd.size() > 20 ? "..." + opponent.cmd.substr(opponent.cmd.size() - 17) : opponent.cmd;
+        std::cout << std::format("| {:<21}| {:<6}| {:<6}| {:<6}| {:<6}|", name, games, opponent.wins, opponent.draws, opponent.losses);
+        if (games > 0) {
+            std::cout << std::format(" {:<8}| {:<18}|", std::format("{:.2f}%", 100.0 * score / games), std::format("{:.2f}% - {:.2f}%", 100.0 * low, 100.0 * high));
+        }
+        else {
+            std::cout << std::format(" {:<8}| {:<18}|", "-", "-");
+        }
+        std::cout << std::endl;
+        std::cout << separator << std::endl;
+
+        if (opponent.failed > 0) {
+            std::cout << opponent.failed << " games against " << opponent.cmd << " gave no result." << std::endl;
+        }
+    }
+
+    //what an even split would have cost for the same worst interval, n = z^2 p(1-p) / w^2 for the hardest matchup
+    if (widest > 0.0 && opponents.size() > 1) {
+        double hardest = 0.0;
+        for (const Opponent& opponent : opponents) {
+            double p = (opponent.wins + 0.5 * opponent.draws + 1.0) / (played(opponent) + 2.0);
+            hardest = std::max(hardest, 1.96 * 1.96 * p * (1.0 - p) / (widest * widest));
+        }
+        std::cout << std::format("{} games played, an even split would need about {:.0f} for the same widest interval (+/- {:.2f}%).", total, hardest * opponents.size(), 100.0 * widest) << std::endl;
+    }
+}
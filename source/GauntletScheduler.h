@@ -0,0 +1,83 @@
+#ifndef GAUNTLETSCHEDULER_H
+#define GAUNTLETSCHEDULER_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include "Scheduler.h"
+#include "SeedGenerator.h"
+#include "Mutable.h"
+
+/*
+ * @brief Class describing a gauntlet: one candidate against a pool of opponents, one opponent per game.
+ *
+ * Games go out in pairs, one seed played from both seats. Each new pair goes to the opponent whose confidence
+ * interval shrinks the most from it, so a clear matchup stops taking games early and a close one gets the rest.
+ */
+class GauntletScheduler : public Scheduler {
+private:
+    /*
+     * @brief Struct describing one opponent and the candidate's results against it.
+     */
+    struct Opponent {
+        std::string cmd;            //< the command line
+        int wins = 0;               //< games the candidate won
+        int draws = 0;              //< games drawn
+        int losses = 0;             //< games the candidate lost
+        int failed = 0;             //< games without a result
+        int pending = 0;            //< games handed out, not reported yet
+        bool openPair = false;      //< the first game of a pair is out, the swapped one is not
+        long long pairSeed = 0;     //< the seed of the open pair
+    };
+
+    std::string candidate;                  //< the candidate command line
+    std::vector<Opponent> opponents;        //< the pool
+    Mutable<SeedGenerator>& seeder;         //< Shared rng seeder.
+    int budget;                             //< the most games to hand out
+    double precision;                       //< stop once every interval is this narrow on each side, 0 to use the whole budget
+    int issued;                             //< games handed out so far
+    std::mutex m_mutex;                     //< Mutex protecting everything above.
+
+    /*
+     * @brief Gets the number of finished games against an opponent.
+     *
+     * @param opponent the opponent.
+     *
+     * @return the games.
+     */
+    static int played(const Opponent& opponent);
+
+    /*
+     * @brief Checks if an opponent's interval is narrow enough.
+     *
+     * @param opponent the opponent.
+     *
+     * @return true if it needs no more games.
+     */
+    bool isSettled(const Opponent& opponent) const;
+
+    /*
+     * @brief Picks the opponent for the next pair, the one whose interval shrinks the most.
+     *
+     * @return the opponent index, -1 if all are settled.
+     */
+    int pick() const;
+
+public:
+    /*
+     * @brief Constructs a GauntletScheduler object.
+     *
+     * @param candidate the candidate command line.
+     * @param pool the opponents command lines.
+     * @param seeder the shared rng seeder.
+     * @param budget the most games to play.
+     * @param precision the half width of the 95% interval to reach against every opponent, ex. 0.05. 0 to play the whole budget.
+     */
+    GauntletScheduler(const std::string& candidate, const std::vector<std::string>& pool, Mutable<SeedGenerator>& seeder, int budget, double precision);
+
+    bool next(GameOrder& order) override;
+    void report(const GameOrder& order, const std::vector<int>& scores) override;
+    void print() override;
+};
+
+#endif
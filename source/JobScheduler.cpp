@@ -0,0 +1,197 @@
+#include "JobScheduler.h"
+
+#include <iostream>
+
+JobScheduler::JobScheduler() : jobCount{ 0 }, games{ 0 }, stopping{ false } {}
+
+//the clients left are closed with the jobs
+JobScheduler::~JobScheduler() {}
+
+int JobScheduler::submit(const Job& job, HANDLE client) {
+    int id;
+    std::shared_ptr<Client> writer = std::make_shared<Client>();
+    writer->pipe = client;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        id = ++jobCount;
+        Running& running = jobs[id];
+        running.job = job;
+        running.client = writer;
+        running.rng.seed(job.seeded ? (unsigned int)job.seed : std::random_device()());
+
+        tell(running, "accepted " + std::to_string(id) + " " + std::to_string(jobs.size() - 1));
+        if (running.job.n <= 0 || running.cancelled) retire(id);
+    }
+    m_cv.notify_all();
+    deliver(writer);
+    //a client gone already is retired by the next thread looking for a game
+    if (writer->failed) m_cv.notify_all();
+    return id;
+}
+
+void JobScheduler::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        stopping = true;
+    }
+    m_cv.notify_all();
+}
+
+void JobScheduler::tell(Running& running, const std::string& line) {
+    //the client went away, its games in flight still finish but nothing new is started
+    if (running.client->failed) running.cancelled = true;
+    if (running.cancelled) return;
+
+    std::lock_guard<std::mutex> lock(running.client->m_pending);
+    running.client->pending += line + "\n";
+}
+
+void JobScheduler::retire(int id) {
+    auto found = jobs.find(id);
+    if (found == jobs.end() || found->second.inFlight > 0) return;
+
+    Running& running = found->second;
+    tell(running, "done " + std::to_string(running.reported));
+    {
+        std::lock_guard<std::mutex> lock(running.client->m_pending);
+        running.client->closing = true;
+    }
+    jobs.erase(found);
+}
+
+void JobScheduler::deliver(const std::shared_ptr<Client>& client) {
+    {
+        std::lock_guard<std::mutex> lock(client->m_pending);
+        if (client->writing || client->pipe == NULL) return;
+        client->writing = true;
+    }
+
+    std::string text;
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(client->m_pending);
+            if (client->pending.empty()) {
+                client->writing = false;
+                if (!client->closing) return;
+                break;
+            }
+            text.swap(client->pending);
+            client->pending.clear();
+        }
+        DWORD written = 0;
+        if (!client->failed && (!WriteFile(client->pipe, text.data(), (DWORD)text.size(), &written, NULL) || written != text.size())) {
+            client->failed = true;
+        }
+    }
+
+    //the job is over and nothing more is queued once closing is set, so the pipe is closed once
+    HANDLE pipe;
+    {
+        std::lock_guard<std::mutex> lock(client->m_pending);
+        pipe = client->pipe;
+        client->pipe = NULL;
+    }
+    if (pipe == NULL) return;
+    FlushFileBuffers(pipe);
+    DisconnectNamedPipe(pipe);
+    CloseHandle(pipe);
+}
+
+bool JobScheduler::next(GameOrder& order) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        //a job whose client went away with nothing in flight has no report() left to retire it
+        std::vector<int> gone;
+        for (auto& entry : jobs) {
+            Running& running = entry.second;
+            if (running.client->failed) running.cancelled = true;
+            if (running.cancelled && running.inFlight == 0) gone.push_back(entry.first);
+        }
+        if (!gone.empty()) {
+            std::vector<std::shared_ptr<Client> > closed;
+            for (int id : gone) {
+                closed.push_back(jobs[id].client);
+                retire(id);
+            }
+            lock.unlock();
+            for (const std::shared_ptr<Client>& client : closed) {
+                deliver(client);
+            }
+            //a thread waiting for the last job to end may go
+            m_cv.notify_all();
+            lock.lock();
+            continue;
+        }
+
+        //the job with the fewest games in flight, std::map keeps the oldest first on a tie
+        Running* pick = NULL;
+        int pickId = 0;
+        for (auto& entry : jobs) {
+            Running& running = entry.second;
+            if (running.client->failed) running.cancelled = true;
+            if (running.cancelled || running.issued >= running.job.n) continue;
+            if (pick == NULL || running.inFlight < pick->inFlight) {
+                pick = &running;
+                pickId = entry.first;
+            }
+        }
+
+        if (pick != NULL) {
+            int playersCount = (int)pick->job.players.size();
+            int rotation = pick->job.swap ? pick->issued % playersCount : 0;
+            if (rotation == 0) pick->seed = (long long)(pick->rng() >> 1);
+
+            order.players = pick->job.players;
+            order.referee = pick->job.referee;
+            order.seed = pick->seed;
+            order.rotation = rotation;
+            order.tag = pickId;
+            order.game = ++games;
+            pick->issued++;
+            pick->inFlight++;
+            jobGames[order.game] = pick->issued;
+            return true;
+        }
+
+        if (stopping && jobs.empty()) return false;
+        m_cv.wait(lock);
+    }
+}
+
+void JobScheduler::report(const GameOrder& order, const std::vector<int>& scores) {
+    bool finished = false;
+    std::shared_ptr<Client> client;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto found = jobs.find(order.tag);
+        int jobGame = jobGames[order.game];
+        jobGames.erase(order.game);
+        if (found == jobs.end()) return;
+
+        Running& running = found->second;
+        client = running.client;
+        running.inFlight--;
+        running.reported++;
+
+        std::string line = scores.empty() ? "failed " + std::to_string(jobGame) : "result " + std::to_string(jobGame);
+        for (int score : scores) {
+            line += " " + std::to_string(score);
+        }
+        tell(running, line);
+
+        if (running.inFlight == 0 && (running.cancelled || running.issued >= running.job.n)) {
+            retire(order.tag);
+            finished = true;
+        }
+    }
+    //a thread waiting for the last job to end may go
+    if (finished) m_cv.notify_all();
+    deliver(client);
+    //the write failed, the job is retired by the next thread looking for a game
+    if (client->failed) m_cv.notify_all();
+}
+
+void JobScheduler::print() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::cout << "Daemon ran " << jobCount << " jobs, " << games << " games." << std::endl;
+}
@@ -0,0 +1,129 @@
+#ifndef JOBSCHEDULER_H
+#define JOBSCHEDULER_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <random>
+#include <condition_variable>
+#include <windows.h>
+#include "Scheduler.h"
+
+/*
+ * @brief Struct describing one job for the daemon: a plain run, the one lineup n times.
+ */
+struct Job {
+    std::string referee;                    //< the referee command line
+    std::vector<std::string> players;       //< the players command lines
+    int n = 1;                              //< the number of games
+    bool swap = false;                      //< rotate the seats, one seed played from each
+    bool seeded = false;                    //< was a first seed given? then the job plays the same seeds every time
+    long long seed = 0;                     //< the first seed
+};
+
+/*
+ * @brief Class describing the daemon's Scheduler, sharing the game threads between all the jobs submitted to it.
+ *
+ * The next game always goes to the job with the fewest games in flight, the oldest first on a tie, so a short job
+ * submitted during a long one gets its share of the threads right away. next() blocks while there is no job, the
+ * threads stay up until shutdown(). Progress is written to each job's client as the results come in, see Daemon.h.
+ * The lines are queued under the mutex and written after it, so a client slow to read only holds up the thread writing
+ * to it.
+ */
+class JobScheduler : public Scheduler {
+private:
+    /*
+     * @brief Struct describing a job's client, the lines waiting for it and who writes them.
+     */
+    struct Client {
+        HANDLE pipe = NULL;                 //< the client's pipe, owned
+        std::string pending;                //< lines queued, not written yet
+        bool writing = false;               //< a thread is writing, it also writes the lines queued meanwhile
+        bool closing = false;               //< the job is over, the pipe is closed once everything is written
+        std::atomic<bool> failed{ false };  //< a write failed, the client is gone
+        std::mutex m_pending;               //< Mutex protecting pending, writing and closing.
+
+        ~Client() { if (pipe != NULL) CloseHandle(pipe); }
+    };
+
+    /*
+     * @brief Struct describing a job in progress.
+     */
+    struct Running {
+        Job job;                            //< the job
+        std::shared_ptr<Client> client;     //< the client, shared with the threads writing to it
+        std::mt19937 rng;                   //< the job's own seeds, repeatable whatever the other jobs do
+        long long seed = 0;                 //< the seed of the current seat rotation
+        int issued = 0;                     //< games handed out
+        int reported = 0;                   //< games reported
+        int inFlight = 0;                   //< games handed out, not reported yet
+        bool cancelled = false;             //< the client is gone, nothing more is handed out
+    };
+
+    std::map<int, Running> jobs;            //< the jobs in progress, by job number, oldest first
+    std::map<int, int> jobGames;            //< the job's own game number of each game in flight, by game number
+    int jobCount;                           //< jobs submitted so far
+    int games;                              //< games handed out so far, over all jobs
+    bool stopping;                          //< no more jobs, end the threads once the last job is done
+    std::mutex m_mutex;                     //< Mutex protecting everything above.
+    std::condition_variable m_cv;           //< Wakes the threads when a job is submitted or on shutdown.
+
+    /*
+     * @brief Queues a line for a job's client, cancelling the job if the client is gone. Call with the mutex held.
+     *
+     * @param running the job.
+     * @param line the line, without the line feed.
+     */
+    void tell(Running& running, const std::string& line);
+
+    /*
+     * @brief Forgets the job once nothing of it is in flight, its client is closed once its last lines are written.
+     * Call with the mutex held.
+     *
+     * @param id the job number.
+     */
+    void retire(int id);
+
+    /*
+     * @brief Writes the lines queued for a client, and closes it if its job is over. Call without the mutex, a thread
+     * finding another one writing leaves its lines to it.
+     *
+     * @param client the client.
+     */
+    static void deliver(const std::shared_ptr<Client>& client);
+
+public:
+    /*
+     * @brief Constructs a JobScheduler object without jobs.
+     */
+    JobScheduler();
+
+    /*
+     * @brief Destructs the JobScheduler object, closing the clients left.
+     */
+    ~JobScheduler();
+
+    /*
+     * @brief Submits a job. Thread safe.
+     *
+     * @param job the job.
+     * @param client the client's pipe, the JobScheduler closes it once the job is done.
+     *
+     * @return the job number.
+     */
+    int submit(const Job& job, HANDLE client);
+
+    /*
+     * @brief Takes no more jobs. The threads end once the jobs in progress are done.
+     */
+    void shutdown();
+
+    bool next(GameOrder& order) override;
+    void report(const GameOrder& order, const std::vector<int>& scores) override;
+    void print() override;
+};
+
+#endif
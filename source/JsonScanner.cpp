@@ -0,0 +1,225 @@
+#include "JsonScanner.h"
+
+namespace {
+    bool isSpace(char c) { return c == ' ' || c == '\n' || c == '\r' || c == '\t'; }
+}
+
+JsonScanner::JsonScanner() : skipped{ 0 }, inSkipped{ false }, mode{ VALUE }, inKey{ false }, escaped{ false }, matches{ 0 }, dropped{ 0 } {
+    stack.reserve(MAX_DEPTH);
+    token.reserve(MAX_VALUE);
+}
+
+void JsonScanner::setFields(const std::vector<std::string>& fields) {
+    patterns.clear();
+    for (const std::string& field : fields) {
+        std::vector<std::string> segments;
+        size_t start = 0;
+        while (true) {
+            size_t end = field.find('.', start);
+            segments.push_back(field.substr(start, end == std::string::npos ? std::string::npos : end - start));
+            if (end == std::string::npos) break;
+            start = end + 1;
+        }
+        if (!field.empty()) patterns.push_back(segments);
+    }
+}
+
+void JsonScanner::reset() {
+    stack.clear();
+    skipped = 0;
+    inSkipped = false;
+    mode = VALUE;
+    inKey = false;
+    escaped = false;
+    token.clear();
+    matches = 0;
+    dropped = 0;
+}
+
+bool JsonScanner::matchesPath() const {
+    for (const std::vector<std::string>& pattern : patterns) {
+        if (pattern.size() != stack.size()) continue;
+        size_t i = 0;
+        while (i < pattern.size() && (pattern[i] == "*" || pattern[i] == stack[i].key)) ++i;
+        if (i == pattern.size()) return true;
+    }
+    return false;
+}
+
+void JsonScanner::startValue(char c) {
+    if (!stack.empty() && stack.back().array) {
+        stack.back().index++;
+        stack.back().key = std::to_string(stack.back().index);
+    }
+
+    switch (c) {
+    case '{':
+    case '[':
+        //rather than grow, skip the container whole, what follows it still matches
+        if (stack.size() == MAX_DEPTH) {
+            skipped = 1;
+            inSkipped = false;
+            escaped = false;
+            mode = SKIP;
+            return;
+        }
+        stack.push_back({ c == '[', -1, "" });
+        mode = c == '[' ? FIRST_VALUE : FIRST_KEY;
+        break;
+    case '"':
+        token.clear();
+        inKey = false;
+        escaped = false;
+        mode = STRING;
+        break;
+    default:
+        if (c == '-' || (c >= '0' && c <= '9') || c == 't' || c == 'f' || c == 'n') {
+            token.assign(1, c);
+            mode = LITERAL;
+        }
+        else {
+            mode = BROKEN;
+        }
+    }
+}
+
+void JsonScanner::afterValue() { mode = stack.empty() ? DONE : NEXT; }
+
+void JsonScanner::endValue(const Found& found) {
+    //nothing worth a record
+    if (token.empty() || token == "null" || !matchesPath()) return;
+
+    if (matches >= MAX_MATCHES) {
+        dropped++;
+        return;
+    }
+    matches++;
+
+    path.clear();
+    for (const Frame& frame : stack) {
+        if (!path.empty()) path += '.';
+        path += frame.key;
+    }
+    found(path, token);
+}
+
+void JsonScanner::feed(std::string_view chunk, const Found& found) {
+    size_t i = 0;
+    while (i < chunk.size()) {
+        char c = chunk[i];
+        switch (mode) {
+        case VALUE:
+        case FIRST_VALUE:
+            if (isSpace(c)) break;
+            if (mode == FIRST_VALUE && c == ']') {
+                stack.pop_back();
+                afterValue();
+                break;
+            }
+            startValue(c);
+            break;
+
+        case KEY:
+        case FIRST_KEY:
+            if (isSpace(c)) break;
+            if (mode == FIRST_KEY && c == '}') {
+                stack.pop_back();
+                afterValue();
+                break;
+            }
+            if (c != '"') {
+                mode = BROKEN;
+                break;
+            }
+            token.clear();
+            inKey = true;
+            escaped = false;
+            mode = STRING;
+            break;
+
+        case STRING:
+            if (escaped) {
+                escaped = false;
+            }
+            else if (c == '\\') {
+                escaped = true;
+            }
+            else if (c == '"') {
+                if (inKey) {
+                    stack.back().key = token;
+                    mode = COLON;
+                }
+                else {
+                    endValue(found);
+                    afterValue();
+                }
+                break;
+            }
+            if (token.size() < (inKey ? MAX_KEY : MAX_VALUE)) token += c;
+            break;
+
+        case COLON:
+            if (isSpace(c)) break;
+            mode = c == ':' ? VALUE : BROKEN;
+            break;
+
+        case LITERAL:
+            if (isSpace(c) || c == ',' || c == '}' || c == ']') {
+                endValue(found);
+                afterValue();
+                //the delimiter belongs to what follows
+                continue;
+            }
+            if (token.size() < MAX_VALUE) token += c;
+            break;
+
+        case SKIP:
+            //only the brackets outside strings count, a bracket of the wrong kind is not caught
+            if (inSkipped) {
+                if (escaped) escaped = false;
+                else if (c == '\\') escaped = true;
+                else if (c == '"') inSkipped = false;
+            }
+            else if (c == '"') {
+                inSkipped = true;
+            }
+            else if (c == '{' || c == '[') {
+                skipped++;
+            }
+            else if ((c == '}' || c == ']') && --skipped == 0) {
+                afterValue();
+            }
+            break;
+
+        case NEXT:
+            if (isSpace(c)) break;
+            if (c == ',') {
+                mode = stack.back().array ? VALUE : KEY;
+            }
+            else if ((c == ']' && stack.back().array) || (c == '}' && !stack.back().array)) {
+                stack.pop_back();
+                afterValue();
+            }
+            else {
+                mode = BROKEN;
+            }
+            break;
+
+        case DONE:
+            if (!isSpace(c)) mode = BROKEN;
+            break;
+
+        case BROKEN:
+            return;
+        }
+        ++i;
+    }
+}
+
+bool JsonScanner::finish(const Found& found) {
+    if (mode == LITERAL && stack.empty()) {
+        endValue(found);
+        mode = DONE;
+    }
+    return mode == DONE;
+}
@@ -0,0 +1,131 @@
+#ifndef JSONSCANNER_H
+#define JSONSCANNER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <functional>
+
+/*
+ * @brief Class describing a streaming JSON scanner, picking the fields named by a few patterns out of a referee's
+ *        replay without ever holding the replay, ex. the per turn summaries of a multi MB file.
+ *
+ * The JSON is fed in chunks of any size. A pattern is a path of keys and array indexes separated by dots, * matching
+ * any one of them, ex. "scores.*" or "errors.*.*". Only scalars match: each string, number or boolean found at a
+ * pattern's path is handed to the callback with its actual path, ex. "scores.0". Strings keep their JSON escapes,
+ * empty strings and nulls are skipped. The memory used is capped: containers deeper than MAX_DEPTH are skipped whole,
+ * nothing in them matches, longer keys and values are cut, and the matches past MAX_MATCHES are only counted.
+ */
+class JsonScanner {
+public:
+    typedef std::function<void(std::string_view path, std::string_view value)> Found;
+
+private:
+    const static size_t MAX_DEPTH = 64;         //< deeper containers are skipped, only their brackets are counted
+    const static size_t MAX_KEY = 256;          //< longer keys are cut
+    const static size_t MAX_VALUE = 1024;       //< longer values are cut
+    const static int MAX_MATCHES = 10000;       //< matches handed over per replay
+
+    /*
+     * @brief What the scanner expects next.
+     */
+    enum Mode { VALUE, FIRST_VALUE, KEY, FIRST_KEY, COLON, NEXT, STRING, LITERAL, SKIP, DONE, BROKEN };
+
+    /*
+     * @brief Struct describing an open container.
+     */
+    struct Frame {
+        bool array;             //< an array, else an object
+        int index;              //< the index of the current element, arrays only
+        std::string key;        //< the current key, or index as text
+    };
+
+    std::vector<std::vector<std::string> > patterns;    //< the patterns, split at the dots
+    std::vector<Frame> stack;                           //< the open containers, MAX_DEPTH at most
+    size_t skipped;                                     //< the containers open past MAX_DEPTH
+    bool inSkipped;                                     //< a string of a skipped container is being read
+    Mode mode;                                          //< what comes next
+    bool inKey;                                         //< the string read is a key
+    bool escaped;                                       //< the last string character was a backslash
+    std::string token;                                  //< the string or literal being read, capped
+    std::string path;                                   //< the path of the last match
+    int matches;                                        //< the matches handed over
+    int dropped;                                        //< the matches past MAX_MATCHES
+
+    /*
+     * @brief Starts a value, in an array it gets the next index.
+     *
+     * @param c its first character.
+     */
+    void startValue(char c);
+
+    /*
+     * @brief Ends a scalar value, handing it over if its path matches.
+     *
+     * @param found the callback.
+     */
+    void endValue(const Found& found);
+
+    /*
+     * @brief Ends a value, a scalar or a container, and expects what follows it.
+     */
+    void afterValue();
+
+    /*
+     * @brief Checks the current path against the patterns.
+     *
+     * @return true if a pattern matches.
+     */
+    bool matchesPath() const;
+
+public:
+    /*
+     * @brief Constructs a JsonScanner object without patterns, it matches nothing.
+     */
+    JsonScanner();
+
+    /*
+     * @brief Sets the patterns.
+     *
+     * @param fields the patterns, ex. "scores.*".
+     */
+    void setFields(const std::vector<std::string>& fields);
+
+    /*
+     * @brief Checks if there are patterns.
+     *
+     * @return true or false.
+     */
+    bool hasFields() const { return !patterns.empty(); }
+
+    /*
+     * @brief Gets ready for the next replay.
+     */
+    void reset();
+
+    /*
+     * @brief Scans the next chunk of the replay.
+     *
+     * @param chunk the chunk, cut anywhere.
+     * @param found called for every match.
+     */
+    void feed(std::string_view chunk, const Found& found);
+
+    /*
+     * @brief Ends the replay, a top level number without anything after it still counts.
+     *
+     * @param found called for a last match.
+     *
+     * @return false if the replay is not complete, valid JSON.
+     */
+    bool finish(const Found& found);
+
+    /*
+     * @brief Gets the number of matches past MAX_MATCHES, which were not handed over.
+     *
+     * @return the number of matches.
+     */
+    int getDropped() const { return dropped; }
+};
+
+#endif
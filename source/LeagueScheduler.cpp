@@ -0,0 +1,201 @@
+#include "LeagueScheduler.h"
+#include "ExePath.h"
+
+#include <cmath>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+
+LeagueScheduler::LeagueScheduler(const std::vector<std::string>& pool, Mutable<SeedGenerator>& seeder, int lineupSize, int budget)
+    :pairGames(pool.size(), std::vector<int>(pool.size(), 0)),
+    seeder{ seeder }, lineupSize{ lineupSize }, budget{ budget }, issued{ 0 }, failed{ 0 } {
+    for (const std::string& cmd : pool) {
+        Bot bot;
+        bot.cmd = cmd;
+        bots.push_back(bot);
+    }
+}
+
+void LeagueScheduler::setTable(const std::string& dir, const std::string& file) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    table = ExePath::resolve(dir) / file;
+}
+
+double LeagueScheduler::expected(int i, int j) const {
+    return bots[i].strength / (bots[i].strength + bots[j].strength);
+}
+
+void LeagueScheduler::fit(int steps) {
+    //Hunter's MM update, the virtual draw against a bot of strength 1 is the 0.5 and the last term
+    int size = (int)bots.size();
+    for (int step = 0; step < steps; ++step) {
+        for (int i = 0; i < size; ++i) {
+            double denominator = 1.0 / (bots[i].strength + 1.0);
+            for (int j = 0; j < size; ++j) {
+                if (pairGames[i][j] > 0) denominator += pairGames[i][j] / (bots[i].strength + bots[j].strength);
+            }
+            bots[i].strength = (bots[i].wins + 0.5) / denominator;
+        }
+    }
+}
+
+double LeagueScheduler::variance(int i, bool withPending) const {
+    double anchor = bots[i].strength / (bots[i].strength + 1.0);
+    double information = anchor * (1.0 - anchor);
+    for (int j = 0; j < (int)bots.size(); ++j) {
+        if (pairGames[i][j] > 0) {
+            double p = expected(i, j);
+            information += pairGames[i][j] * p * (1.0 - p);
+        }
+    }
+
+    //a game in flight is counted as an even match against each of its opponents
+    if (withPending) information += bots[i].pending * (lineupSize - 1) * 0.25;
+    return 1.0 / information;
+}
+
+bool LeagueScheduler::next(GameOrder& order) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (issued >= budget || (int)bots.size() < lineupSize) return false;
+
+    //the least known bot first
+    std::vector<int> lineup;
+    std::vector<bool> chosen(bots.size(), false);
+    int first = 0;
+    for (int i = 1; i < (int)bots.size(); ++i) {
+        if (variance(i, true) > variance(first, true)) first = i;
+    }
+    lineup.push_back(first);
+    chosen[first] = true;
+
+    //then whoever it is most likely to split games with, a match between two uncertain bots teaches the most,
+    //and a pair already played often teaches less, without that the neighbours in the ranking lock each other in
+    while ((int)lineup.size() < lineupSize) {
+        int best = -1;
+        double bestGain = -1.0;
+        for (int j = 0; j < (int)bots.size(); ++j) {
+            if (chosen[j]) continue;
+            double gain = 0.0;
+            for (int i : lineup) {
+                double p = expected(i, j);
+                gain += p * (1.0 - p) * (variance(i, true) + variance(j, true)) / (1.0 + pairGames[i][j]);
+            }
+            if (gain > bestGain) {
+                bestGain = gain;
+                best = j;
+            }
+        }
+        lineup.push_back(best);
+        chosen[best] = true;
+    }
+
+    issued++;
+    order.game = issued;
+    order.players.clear();
+    for (int i : lineup) {
+        bots[i].pending++;
+        order.players.push_back(bots[i].cmd);
+    }
+    order.seed = seeder.get().nextSeed();
+    order.rotation = issued % lineupSize;
+    order.tag = first;
+    inFlight[issued] = lineup;
+    return true;
+}
+
+void LeagueScheduler::report(const GameOrder& order, const std::vector<int>& scores) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto found = inFlight.find(order.game);
+    if (found == inFlight.end()) return;
+    std::vector<int> lineup = found->second;
+    inFlight.erase(found);
+
+    for (int i : lineup) {
+        bots[i].pending--;
+    }
+    if (scores.size() < lineup.size()) {
+        failed++;
+        return;
+    }
+
+    //one match per pair in the lineup
+    for (int a = 0; a < (int)lineup.size(); ++a) {
+        bots[lineup[a]].games++;
+        for (int b = a + 1; b < (int)lineup.size(); ++b) {
+            int i = lineup[a];
+            int j = lineup[b];
+            double result = scores[a] > scores[b] ? 1.0 : (scores[a] < scores[b] ? 0.0 : 0.5);
+            bots[i].wins += result;
+            bots[j].wins += 1.0 - result;
+            pairGames[i][j]++;
+            pairGames[j][i]++;
+        }
+    }
+    fit(FIT_STEPS);
+
+    //the table is for people watching the run, once a second is plenty
+    auto now = std::chrono::steady_clock::now();
+    if (!table.empty() && now - written >= std::chrono::seconds(1)) {
+        written = now;
+        std::filesystem::path temp = table;
+        temp += ".tmp";
+        {
+            std::ofstream out(temp, std::ofstream::out | std::ofstream::trunc);
+            if (!out.is_open()) return;
+            writeTable(out);
+        }
+        std::error_code error;
+        std::filesystem::rename(temp, table, error);
+    }
+}
+
+void LeagueScheduler::writeTable(std::ostream& out) const {
+    /*
+    +------+----------------------+---------+---------+-------+---------+
+    | Rank | Bot                  | Rating  | 95% +/- | Games | Score   |
+    +------+----------------------+---------+---------+-------+---------+
+    | 1    | bot_v12.exe          | 152.3   | 41.2    | 120   | 71.25%  |
+    +------+----------------------+---------+---------+-------+---------+
+    */
+    std::vector<int> order(bots.size());
+    for (int i = 0; i < (int)bots.size(); ++i) order[i] = i;
+    std::sort(order.begin(), order.end(), [this](int a, int b) { return bots[a].strength > bots[b].strength; });
+
+    std::string separator = "+------+----------------------+---------+---------+-------+---------+";
+    out << "League after " << (issued - (int)inFlight.size() - failed) << " games, ratings relative to an average bot" << std::endl;
+    out << separator << std::endl;
+    out << "| Rank | Bot                  | Rating  | 95% +/- | Games | Score   |" << std::endl;
+    out << separator << std::endl;
+    for (int rank = 0; rank < (int)order.size(); ++rank) {
+        const Bot& bot = bots[order[rank]];
+        double rating = 400.0 * std::log10(bot.strength);
+        double margin = 1.96 * 400.0 / std::log(10.0) * std::sqrt(variance(order[rank], false));
+
+        //a game of n players is n - 1 matches for each of them
+        int matches = 0;
+        for (int j = 0; j < (int)bots.size(); ++j) matches += pairGames[order[rank]][j];
+
+        std::string name = bot.cmd.size() > 20 ? "..." + bot.cmd.substr(bot.cmd.size() - 17) : bot.cmd;
+        out << std::format("| {:<5}| {:<21}| {:<8}| {:<8}| {:<6}| {:<8}|", rank + 1, name, std::format("{:.1f}", rating), std::format("{:.1f}", margin),
+            bot.games, matches > 0 ? std::format("{:.2f}%", 100.0 * bot.wins / matches) : "-") << std::endl;
+        out << separator << std::endl;
+    }
+    if (failed > 0) {
+        out << failed << " games gave no result." << std::endl;
+    }
+}
+
+void LeagueScheduler::print() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    //the run is over, no need to be cheap
+    fit(200);
+    writeTable(std::cout);
+
+    if (!table.empty()) {
+        std::ofstream out(table, std::ofstream::out | std::ofstream::trunc);
+        if (out.is_open()) writeTable(out);
+    }
+}
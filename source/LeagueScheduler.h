@@ -0,0 +1,111 @@
+#ifndef LEAGUESCHEDULER_H
+#define LEAGUESCHEDULER_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <chrono>
+#include <filesystem>
+#include "Scheduler.h"
+#include "SeedGenerator.h"
+#include "Mutable.h"
+
+/*
+ * @brief Class describing a league: a pool of bots ranked with a Bradley-Terry model updated after every game.
+ *
+ * A game of more than two players counts as one match between each pair in it, the same way PlayerStats does.
+ * The model is refit with a few minorization-maximization steps per result, warm started from the previous fit,
+ * so it stays cheap for a pool of dozens of bots. Every bot also has one virtual draw against an average bot,
+ * which keeps an unbeaten bot's rating finite.
+ *
+ * Lineups are picked to be informative: the bot with the least certain rating first, then the opponents it is most
+ * likely to split games with, weighted by how uncertain their own ratings are and by how rarely the pair has met.
+ */
+class LeagueScheduler : public Scheduler {
+private:
+    /*
+     * @brief Struct describing one bot of the pool.
+     */
+    struct Bot {
+        std::string cmd;            //< the command line
+        double strength = 1.0;      //< the Bradley-Terry strength, the rating is 400 * log10 of it
+        double wins = 0.0;          //< pairwise wins, a draw counting 0.5
+        int games = 0;              //< games played
+        int pending = 0;            //< games handed out, not reported yet
+    };
+
+    std::vector<Bot> bots;                          //< the pool
+    std::vector<std::vector<int> > pairGames;       //< pairGames[i][j], the matches between i and j
+    Mutable<SeedGenerator>& seeder;                 //< Shared rng seeder.
+    int lineupSize;                                 //< players per game
+    int budget;                                     //< the most games to hand out
+    int issued;                                     //< games handed out so far
+    int failed;                                     //< games without a result
+    std::map<int, std::vector<int> > inFlight;      //< the lineup of each game handed out, by game number
+
+    std::filesystem::path table;                    //< the live rating table, empty if none
+    std::chrono::steady_clock::time_point written;  //< when the table was last written
+    std::mutex m_mutex;                             //< Mutex protecting everything above.
+
+    const static int FIT_STEPS = 8;                 //< minorization-maximization steps per result
+
+    /*
+     * @brief Refits the strengths, starting from the current ones.
+     *
+     * @param steps the number of steps.
+     */
+    void fit(int steps);
+
+    /*
+     * @brief Gets the chance that a bot beats another under the current fit.
+     *
+     * @param i the first bot.
+     * @param j the second bot.
+     *
+     * @return the chance.
+     */
+    double expected(int i, int j) const;
+
+    /*
+     * @brief Gets the variance of a bot's log strength, the inverse of the information its games carry.
+     *
+     * @param i the bot.
+     * @param withPending count the games handed out as if played.
+     *
+     * @return the variance.
+     */
+    double variance(int i, bool withPending) const;
+
+    /*
+     * @brief Writes the rating table, sorted by rating.
+     *
+     * @param out the stream.
+     */
+    void writeTable(std::ostream& out) const;
+
+public:
+    /*
+     * @brief Constructs a LeagueScheduler object.
+     *
+     * @param pool the bots command lines.
+     * @param seeder the shared rng seeder.
+     * @param lineupSize the players per game, 2 to 4.
+     * @param budget the most games to play.
+     */
+    LeagueScheduler(const std::vector<std::string>& pool, Mutable<SeedGenerator>& seeder, int lineupSize, int budget);
+
+    /*
+     * @brief Keeps a rating table file next to the executable up to date during the run, rewritten at most once a second.
+     *
+     * @param dir the directory.
+     * @param file the file name.
+     */
+    void setTable(const std::string& dir, const std::string& file);
+
+    bool next(GameOrder& order) override;
+    void report(const GameOrder& order, const std::vector<int>& scores) override;
+    void print() override;
+};
+
+#endif
@@ -0,0 +1,126 @@
+#include "LzCodec.h"
+
+#include <vector>
+#include <cstring>
+#include <cstdint>
+
+namespace {
+    std::uint32_t read32(const char* p) {
+        std::uint32_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    void writeLength(std::string& out, size_t length) {
+        //lengths over the token's 15 go on in bytes of 255, the last one under 255
+        while (length >= 255) {
+            out += (char)255;
+            length -= 255;
+        }
+        out += (char)length;
+    }
+}
+
+std::string LzCodec::compress(std::string_view in) {
+    std::string out;
+    out.reserve(in.size() / 2 + 16);
+
+    const char* base = in.data();
+    size_t size = in.size();
+    size_t anchor = 0;  //first literal not written yet
+
+    if (size > MATCH_LIMIT) {
+        std::vector<std::uint32_t> table(1 << HASH_BITS, 0);
+        size_t limit = size - MATCH_LIMIT;
+        size_t i = 1;
+
+        while (i < limit) {
+            std::uint32_t sequence = read32(base + i);
+            std::uint32_t hash = (sequence * 2654435761u) >> (32 - HASH_BITS);
+            size_t candidate = table[hash];
+            table[hash] = (std::uint32_t)i;
+
+            //the format's offsets are 16 bits
+            if (candidate == 0 || i - candidate > 65535 || read32(base + candidate) != sequence) {
+                ++i;
+                continue;
+            }
+
+            //a match stops short of the last literals
+            size_t length = MIN_MATCH;
+            size_t end = size - LAST_LITERALS;
+            while (i + length < end && base[candidate + length] == base[i + length]) ++length;
+
+            size_t literals = i - anchor;
+            size_t matchExtra = length - MIN_MATCH;
+            out += (char)(((literals < 15 ? literals : 15) << 4) | (matchExtra < 15 ? matchExtra : 15));
+            if (literals >= 15) writeLength(out, literals - 15);
+            out.append(base + anchor, literals);
+
+            size_t offset = i - candidate;
+            out += (char)(offset & 0xFF);
+            out += (char)(offset >> 8);
+            if (matchExtra >= 15) writeLength(out, matchExtra - 15);
+
+            i += length;
+            anchor = i;
+        }
+    }
+
+    //the last sequence is literals only
+    size_t literals = size - anchor;
+    out += (char)((literals < 15 ? literals : 15) << 4);
+    if (literals >= 15) writeLength(out, literals - 15);
+    out.append(base + anchor, literals);
+    return out;
+}
+
+bool LzCodec::decompress(std::string_view in, size_t size, std::string& out) {
+    out.clear();
+    //a match's length runs on in bytes of 255 each, no block decompresses to more
+    if (size > in.size() * MAX_RATIO) return false;
+    out.reserve(size);
+
+    size_t i = 0;
+    while (i < in.size()) {
+        unsigned char token = (unsigned char)in[i++];
+
+        size_t literals = token >> 4;
+        if (literals == 15) {
+            unsigned char more;
+            do {
+                if (i >= in.size()) return false;
+                more = (unsigned char)in[i++];
+                literals += more;
+            } while (more == 255);
+        }
+        if (literals > in.size() - i || out.size() + literals > size) return false;
+        out.append(in.data() + i, literals);
+        i += literals;
+
+        //the last sequence has no match
+        if (i == in.size()) break;
+
+        if (in.size() - i < 2) return false;
+        size_t offset = (unsigned char)in[i] | ((size_t)(unsigned char)in[i + 1] << 8);
+        i += 2;
+        if (offset == 0 || offset > out.size()) return false;
+
+        size_t length = (token & 0x0F);
+        if (length == 15) {
+            unsigned char more;
+            do {
+                if (i >= in.size()) return false;
+                more = (unsigned char)in[i++];
+                length += more;
+            } while (more == 255);
+        }
+        length += MIN_MATCH;
+        if (out.size() + length > size) return false;
+
+        //the match may overlap what it copies, ex. a run of one byte, so byte by byte
+        size_t from = out.size() - offset;
+        for (size_t k = 0; k < length; ++k) out += out[from + k];
+    }
+    return out.size() == size;
+}
@@ -0,0 +1,44 @@
+#ifndef LZCODEC_H
+#define LZCODEC_H
+
+#include <string>
+#include <string_view>
+
+/*
+ * @brief Class describing a small LZ77 codec writing the LZ4 block format, fast enough to compress every game's log
+ * on the fly. Logs are full of repeated lines and compress about ten fold.
+ *
+ * The blocks hold no sizes, the caller keeps the decompressed size next to them. Any LZ4 block decoder reads them.
+ */
+class LzCodec {
+private:
+    const static int HASH_BITS = 12;        //< the match finder's table has 1 << HASH_BITS entries
+    const static int MIN_MATCH = 4;         //< the shortest match worth a sequence
+    const static int LAST_LITERALS = 5;     //< a block ends with at least this many literals
+    const static int MATCH_LIMIT = 12;      //< no match starts in the last MATCH_LIMIT bytes
+    const static int MAX_RATIO = 255;       //< a block byte never stands for more than this many bytes
+
+public:
+    /*
+     * @brief Compresses a block.
+     *
+     * @param in the data.
+     *
+     * @return the compressed block.
+     */
+    static std::string compress(std::string_view in);
+
+    /*
+     * @brief Decompresses a block.
+     *
+     * @param in the compressed block.
+     * @param size the decompressed size.
+     * @param out the data.
+     *
+     * @return false if the block is corrupt or does not decompress to size bytes. A size the block cannot hold is
+     * refused before anything is allocated.
+     */
+    static bool decompress(std::string_view in, size_t size, std::string& out);
+};
+
+#endif
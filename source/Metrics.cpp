@@ -0,0 +1,93 @@
+#include "Metrics.h"
+
+#include <algorithm>
+
+Histogram::Histogram(const std::vector<double>& bounds)
+    :bounds{ bounds }, buckets{ new std::atomic<unsigned long long>[bounds.size() + 1] }, count{ 0 }, sum{ 0 } {
+    for (size_t i = 0; i <= bounds.size(); ++i) buckets[i] = 0;
+}
+
+void Histogram::observe(std::chrono::steady_clock::duration elapsed) {
+    double seconds = std::chrono::duration<double>(elapsed).count();
+    size_t bucket = std::lower_bound(bounds.begin(), bounds.end(), seconds) - bounds.begin();
+    buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(), std::memory_order_relaxed);
+}
+
+void Histogram::render(std::ostream& out, const std::string& name, const std::string& labels) const {
+    std::string prefix = labels.empty() ? "" : labels + ",";
+
+    //Prometheus buckets are cumulative, each one counts everything up to its bound
+    unsigned long long cumulative = 0;
+    for (size_t i = 0; i < bounds.size(); ++i) {
+        cumulative += buckets[i].load(std::memory_order_relaxed);
+        out << name << "_bucket{" << prefix << "le=\"" << bounds[i] << "\"} " << cumulative << "\n";
+    }
+    cumulative += buckets[bounds.size()].load(std::memory_order_relaxed);
+    out << name << "_bucket{" << prefix << "le=\"+Inf\"} " << cumulative << "\n";
+
+    std::string braces = labels.empty() ? "" : "{" + labels + "}";
+    out << name << "_sum" << braces << " " << sum.load(std::memory_order_relaxed) / 1e9 << "\n";
+    out << name << "_count" << braces << " " << cumulative << "\n";
+}
+
+Metrics::Metrics(int playersCount)
+    :begin{ std::chrono::steady_clock::now() }, started{ 0 }, finished{ 0 }, failed{ 0 }, workers{ 0 },
+    spawn{ { 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5 } } {
+    for (int i = 0; i < playersCount; ++i) {
+        turns.emplace_back(std::vector<double>{ 0.001, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0 });
+        timeouts.emplace_back(0);
+    }
+}
+
+void Metrics::gameStarted() { started.fetch_add(1, std::memory_order_relaxed); }
+
+void Metrics::gameEnded(bool result) { (result ? finished : failed).fetch_add(1, std::memory_order_relaxed); }
+
+void Metrics::workerRunning(bool running) { workers.fetch_add(running ? 1 : -1, std::memory_order_relaxed); }
+
+void Metrics::spawned(std::chrono::steady_clock::duration elapsed) { spawn.observe(elapsed); }
+
+void Metrics::turn(int player, std::chrono::steady_clock::duration elapsed) {
+    if (player < 0 || player >= (int)turns.size()) return;
+    turns[player].observe(elapsed);
+}
+
+void Metrics::timeout(int player) {
+    if (player < 0 || player >= (int)timeouts.size()) return;
+    timeouts[player].fetch_add(1, std::memory_order_relaxed);
+}
+
+long long Metrics::getFinished() const { return finished.load(std::memory_order_relaxed); }
+
+std::string Metrics::render(double gamesPerSecond) const {
+    std::ostringstream out;
+
+    out << "# HELP brutaltester_games_started_total Games started.\n# TYPE brutaltester_games_started_total counter\n";
+    out << "brutaltester_games_started_total " << started.load(std::memory_order_relaxed) << "\n";
+    out << "# HELP brutaltester_games_finished_total Games with a result, the cached ones included.\n# TYPE brutaltester_games_finished_total counter\n";
+    out << "brutaltester_games_finished_total " << finished.load(std::memory_order_relaxed) << "\n";
+    out << "# HELP brutaltester_games_failed_total Games without a result.\n# TYPE brutaltester_games_failed_total counter\n";
+    out << "brutaltester_games_failed_total " << failed.load(std::memory_order_relaxed) << "\n";
+    out << "# HELP brutaltester_games_per_second Games with a result per second over the last minute.\n# TYPE brutaltester_games_per_second gauge\n";
+    out << "brutaltester_games_per_second " << gamesPerSecond << "\n";
+    out << "# HELP brutaltester_workers Game threads running.\n# TYPE brutaltester_workers gauge\n";
+    out << "brutaltester_workers " << workers.load(std::memory_order_relaxed) << "\n";
+    out << "# HELP brutaltester_uptime_seconds Time since the run started.\n# TYPE brutaltester_uptime_seconds gauge\n";
+    out << "brutaltester_uptime_seconds " << std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count() << "\n";
+
+    out << "# HELP brutaltester_spawn_seconds Time to start a referee or player process.\n# TYPE brutaltester_spawn_seconds histogram\n";
+    spawn.render(out, "brutaltester_spawn_seconds", "");
+
+    out << "# HELP brutaltester_turn_seconds Time from a player's input to its reply, old mode and in-process referee only.\n# TYPE brutaltester_turn_seconds histogram\n";
+    for (size_t i = 0; i < turns.size(); ++i) {
+        turns[i].render(out, "brutaltester_turn_seconds", "player=\"" + std::to_string(i) + "\"");
+    }
+
+    out << "# HELP brutaltester_timeouts_total Replies a player did not give in time.\n# TYPE brutaltester_timeouts_total counter\n";
+    for (size_t i = 0; i < timeouts.size(); ++i) {
+        out << "brutaltester_timeouts_total{player=\"" << i << "\"} " << timeouts[i].load(std::memory_order_relaxed) << "\n";
+    }
+    return out.str();
+}
@@ -0,0 +1,128 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <memory>
+
+/*
+ * @brief Class describing a histogram with fixed buckets, in seconds, updated without locks.
+ */
+class Histogram {
+private:
+    std::vector<double> bounds;                                         //< the upper bound of each bucket but +Inf
+    std::unique_ptr<std::atomic<unsigned long long>[]> buckets;         //< observations per bucket, +Inf last, not cumulative
+    std::atomic<unsigned long long> count;                              //< observations
+    std::atomic<long long> sum;                                         //< sum of the observations in ns
+
+public:
+    /*
+     * @brief Constructs a Histogram object.
+     *
+     * @param bounds the upper bounds of the buckets in seconds, increasing.
+     */
+    Histogram(const std::vector<double>& bounds);
+
+    /*
+     * @brief Adds an observation. Thread safe.
+     *
+     * @param elapsed the observed time.
+     */
+    void observe(std::chrono::steady_clock::duration elapsed);
+
+    /*
+     * @brief Writes the histogram in the Prometheus text format, without the # lines.
+     *
+     * @param out the stream.
+     * @param name the metric name.
+     * @param labels the labels without braces, ex. player="0", empty for none.
+     */
+    void render(std::ostream& out, const std::string& name, const std::string& labels) const;
+};
+
+/*
+ * @brief Class describing the live metrics of the game threads: counters, gauges and histograms, updated without locks
+ * by the threads and read by the MetricsServer, which serves them in the Prometheus text format.
+ */
+class Metrics {
+private:
+    std::chrono::steady_clock::time_point begin;        //< when the run started
+    std::atomic<long long> started;                     //< games started
+    std::atomic<long long> finished;                    //< games with a result, the cached ones included
+    std::atomic<long long> failed;                      //< games without a result
+    std::atomic<int> workers;                           //< game threads running
+    Histogram spawn;                                    //< time for a process to start
+    std::deque<Histogram> turns;                        //< time from a player's input to its reply, per player
+    std::deque<std::atomic<long long> > timeouts;       //< replies a player did not give in time, per player
+
+public:
+    /*
+     * @brief Constructs a Metrics object.
+     *
+     * @param playersCount the players per game.
+     */
+    Metrics(int playersCount);
+
+    /*
+     * @brief Counts a started game. Thread safe.
+     */
+    void gameStarted();
+
+    /*
+     * @brief Counts an ended game. Thread safe.
+     *
+     * @param result did it give a result?
+     */
+    void gameEnded(bool result);
+
+    /*
+     * @brief Counts a game thread in or out of the running ones. Thread safe.
+     *
+     * @param running true when it starts, false when it is done.
+     */
+    void workerRunning(bool running);
+
+    /*
+     * @brief Adds a process start time. Thread safe.
+     *
+     * @param elapsed the time.
+     */
+    void spawned(std::chrono::steady_clock::duration elapsed);
+
+    /*
+     * @brief Adds a player's turn time, from its input written to its reply read. Thread safe.
+     *
+     * @param player the player.
+     * @param elapsed the time.
+     */
+    void turn(int player, std::chrono::steady_clock::duration elapsed);
+
+    /*
+     * @brief Counts a reply a player did not give in time. Thread safe.
+     *
+     * @param player the player.
+     */
+    void timeout(int player);
+
+    /*
+     * @brief Gets the number of games with a result.
+     *
+     * @return the number of games.
+     */
+    long long getFinished() const;
+
+    /*
+     * @brief Writes every metric in the Prometheus text format.
+     *
+     * @param gamesPerSecond the games with a result per second lately, measured by the caller.
+     *
+     * @return the text.
+     */
+    std::string render(double gamesPerSecond) const;
+};
+
+#endif
@@ -0,0 +1,115 @@
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include "MetricsServer.h"
+
+#include <string>
+
+#pragma comment(lib, "ws2_32.lib")
+
+MetricsServer::MetricsServer(Metrics& metrics, Level verbose)
+    :Threadable{ }, metrics{ metrics }, logger{ Logger(verbose) }, listener{ INVALID_SOCKET } {}
+
+MetricsServer::~MetricsServer() {
+    if ((SOCKET)listener != INVALID_SOCKET) {
+        closesocket((SOCKET)listener);
+        WSACleanup();
+    }
+}
+
+Logger& MetricsServer::getLog() { return logger; }
+
+bool MetricsServer::listen(int port) {
+    WSADATA data;
+    if (WSAStartup(MAKEWORD(2, 2), &data) != 0) return false;
+
+    SOCKET s = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (s == INVALID_SOCKET) {
+        WSACleanup();
+        return false;
+    }
+
+    //only a local collector may scrape, the metrics name the bots
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons((u_short)port);
+    if (bind(s, (sockaddr*)&address, sizeof(address)) == SOCKET_ERROR || ::listen(s, SOMAXCONN) == SOCKET_ERROR) {
+        closesocket(s);
+        WSACleanup();
+        return false;
+    }
+
+    listener = (std::uintptr_t)s;
+    return true;
+}
+
+double MetricsServer::sample() {
+    auto now = std::chrono::steady_clock::now();
+    if (samples.empty() || now - samples.back().first >= std::chrono::seconds(1)) {
+        samples.emplace_back(now, metrics.getFinished());
+        while (now - samples.front().first > std::chrono::seconds(WINDOW)) {
+            samples.pop_front();
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(samples.back().first - samples.front().first).count();
+    if (seconds <= 0.0) return 0.0;
+    return (samples.back().second - samples.front().second) / seconds;
+}
+
+void MetricsServer::answer(std::uintptr_t client) {
+    SOCKET s = (SOCKET)client;
+
+    //a scraper sends its request at once, a client that does not is not waited on for long
+    DWORD timeout = 1000;
+    setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, (const char*)&timeout, sizeof(timeout));
+
+    std::string request;
+    char buffer[1024];
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < 8192) {
+        int received = recv(s, buffer, sizeof(buffer), 0);
+        if (received <= 0) break;
+        request.append(buffer, received);
+    }
+
+    std::string response;
+    if (request.starts_with("GET /metrics ") || request.starts_with("GET / ")) {
+        std::string body = metrics.render(sample());
+        response = "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: " + std::to_string(body.size());
+        response += "\r\nConnection: close\r\n\r\n" + body;
+    }
+    else {
+        response = "HTTP/1.0 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+        logger.addLog(Level::VERBOSE, "Metrics request ignored: " + request.substr(0, request.find('\r')));
+    }
+
+    size_t sent = 0;
+    while (sent < response.size()) {
+        int written = send(s, response.data() + sent, (int)(response.size() - sent), 0);
+        if (written == SOCKET_ERROR) break;
+        sent += written;
+    }
+    shutdown(s, SD_SEND);
+    closesocket(s);
+}
+
+void MetricsServer::run() {
+    while (!shouldStop()) {
+        fd_set readable;
+        FD_ZERO(&readable);
+        FD_SET((SOCKET)listener, &readable);
+        timeval timeout = { 1, 0 };
+        if (select(0, &readable, NULL, NULL, &timeout) == SOCKET_ERROR) {
+            logger.addLog(Level::ERR, "Metrics select failed: " + std::to_string(WSAGetLastError()) + ".");
+            break;
+        }
+
+        sample();
+        if (FD_ISSET((SOCKET)listener, &readable)) {
+            SOCKET s = accept((SOCKET)listener, NULL, NULL);
+            if (s != INVALID_SOCKET) answer((std::uintptr_t)s);
+        }
+    }
+
+    setFinished();
+}
@@ -0,0 +1,79 @@
+#ifndef METRICSSERVER_H
+#define METRICSSERVER_H
+
+#include <deque>
+#include <chrono>
+#include <cstdint>
+#include "Threadable.h"
+#include "Metrics.h"
+#include "Logger.h"
+
+/*
+ * @brief Class describing the metrics endpoint: a minimal HTTP server on localhost answering GET /metrics with the
+ * Metrics in the Prometheus text format, for a local collector to scrape during long runs.
+ *
+ * It serves one request per connection, HTTP/1.0 style, which is all a scraper needs. Once a second it also samples
+ * the finished games, for the games per second over the last minute.
+ */
+class MetricsServer : public Threadable {
+private:
+    Metrics& metrics;                       //< The metrics served.
+    Logger logger;                          //< The log object.
+    std::uintptr_t listener;                //< the listening SOCKET, kept out of this header so it does not pull in winsock2.h after windows.h
+
+    std::deque<std::pair<std::chrono::steady_clock::time_point, long long> > samples;   //< finished games once a second, the last minute
+
+    const static int WINDOW = 60;           //< seconds of samples kept for the games per second
+
+    /*
+     * @brief Answers one connection and closes it.
+     *
+     * @param client the SOCKET.
+     */
+    void answer(std::uintptr_t client);
+
+    /*
+     * @brief Samples the finished games and gets the games per second over the samples kept.
+     *
+     * @return the games per second.
+     */
+    double sample();
+
+protected:
+    /*
+     * @brief The run method from the Threadable base class we must overide.
+     */
+    void run() override;
+
+public:
+    /*
+     * @brief Constructs a MetricsServer object.
+     *
+     * @param metrics the metrics to serve.
+     * @param verbose The verbosity to use for the logs.
+     */
+    MetricsServer(Metrics& metrics, Level verbose);
+
+    /*
+     * @brief Destructs the MetricsServer object.
+     */
+    ~MetricsServer();
+
+    /*
+     * @brief Starts listening on localhost. Call before start().
+     *
+     * @param port the TCP port.
+     *
+     * @return success true or false.
+     */
+    bool listen(int port);
+
+    /*
+     * @brief Gets the log.
+     *
+     * @return the log.
+     */
+    Logger& getLog();
+};
+
+#endif
@@ -1,220 +1,330 @@
-
-
-#include "OldGameThread.h"
-
-OldGameThread::OldGameThread(int id, std::string refereeCmd, std::vector<std::string> playersCmd, Mutable<int>& count, Mutable<PlayerStats>& playerStats, Mutable<SeedGenerator>& seeder, int n, bool swap, Level verbose, std::string path, std::string file)
-	:ThreadedGame{ id, refereeCmd, playersCmd, count, playerStats, seeder, n, swap, verbose, path, file } {
-}
-
-OldGameThread::~OldGameThread() {
-	// Delete vector objects
-	seedRotate.clear();
-	players.clear();
-}
-
-bool OldGameThread::start() {
-	int pid = game * 10;
-	referee = Process(pid, refereeCmd);
-	for (size_t i = 0; i < playersCount; i++) {
-		pid++;
-		players.push_back(Process(pid, playersCmd[i]));
-	}
-
-	// Spawn referee process
-	logger.addLog(Level::VERBOSE, "Attempting to start Referee.");
-	if (!this->referee.start()) {
-		logger.addLog(Level::FATAL, "Cannot start Referee.");
-		return false;
-	}
-	logger.addLog(Level::VERBOSE, "Referee Started.");
-
-	// Spawn players process
-	for (size_t i = 0; i < playersCount; i++) {
-		logString = "Attempting to start player " + std::to_string(i);
-		logger.addLog(Level::VERBOSE, logString);
-		if (!players[i].start()) {
-			logger.addLog(Level::FATAL, "Cannot start player file.");
-			return false;
-		}
-		logString = "Player " + std::to_string(i);
-		logString += " started.";
-		logger.addLog(Level::VERBOSE, logString);
-	}
-	
-
-	seedRotate = seeder.get().getSeed(playersCount);
-	rotate = swap ? seedRotate[1] : 0;
-
-	logString = "Swap flag set to ";
-	logString += (swap ? "true." : "false.");
-	logger.addLog(Level::VERBOSE, logString);
-
-	// Call the start function in ThreadedGame
-	logger.addLog(Level::VERBOSE, "OldGameThread, calling start in ThreadedGame.");
-	ThreadedGame::start();
-	return true;
-}
-
-void OldGameThread::run() {
-
-	while (!shouldStop() || !isFinished()) {
-		
-		game = 0;
-		int c = count.get();
-		if (c < n) {
-			game = c + 1;
-			count.set(game);
-		}
-		if (game == 0) {
-			// End of this thread
-			setFinished();
-			break;
-		}
-		try {
-			//start a log block
-			logString = "Game " + std::to_string(game);
-			logger.addLog(Level::VERBOSE, logString);
-			
-			//send the seed to the referee
-			if (swap) {
-				logString = "###Seed " + std::to_string(seedRotate[0]);
-				if (!referee.writePipe(logString)) { 
-					throw std::exception("Could not write to the referee.");
-				}
-			}
-			else if (seeder.get().repeteableTests) {
-				logString = "###Seed " + std::to_string(seeder.get().getSeed(playersCount)[0]);
-				if (!referee.writePipe(logString)) {
-					throw std::exception("Could not write to the referee.");
-				}
-			}
-
-			//send number of players to referee
-			logString = "###Start " + std::to_string(players.size());
-			if (!referee.writePipe(logString)) {
-				throw std::exception("Could not write to the referee.");
-			}
-
-			//get a line from the referee
-			std::string line = referee.readPipe(Process::OUTPUT);
-			if (line != "") {
-				//log the referee line
-				this->logger.addLog(Level::VERBOSE, "Referee " + line);
-
-				//run the game
-				while (!line.starts_with("###End")) {
-
-					//clear the error stream
-					clearErrorStream(referee.getHandle(Process::ERR), "Referee error: ");
-
-					if (line.starts_with("###Input")) {
-						// Read all lines from the referee until next command and give it to the targeted process
-
-						// player target
-						int target = toInteger(line[9]);
-
-						//get next line from referee
-						line = referee.readPipe(Process::OUTPUT);
-
-						//send these lines to the targeted player
-						while (!line.starts_with("###")) {
-
-							//log the line
-							this->logger.addLog(Level::VERBOSE, "Referee: " + line);
-
-							//send the line to the targeted player 
-							if (!players[target].writePipe(line)) {
-								throw std::exception("Could not write to the Player " + target);
-							}
-
-							//get next line from referee
-							line = referee.readPipe(Process::OUTPUT);
-						}
-					}
-					else if (line.starts_with("###Output")) {
-						// Read x lines from the targeted process and give to the referee
-						std::vector<std::string_view> parts = splitString(line, ' ');
-
-						//target to give lines to
-						int target = toInteger(parts[1]);
-
-						//number of lines
-						int x = toInteger(parts[2]);
-												
-						//clear error stream
-						std::string prefix = "Player " + target;
-						prefix += " error: ";
-						clearErrorStream(players[target].getHandle(Process::ERR), prefix);
-						
-						//iterate through the lines
-						for (int i = 0; i < x; ++i) {
-							//get line from player
-							std::string playerLine;
-							playerLine = players[target].readPipe(Process::OUTPUT);
-
-							//log the line
-							prefix = "Player " + target;
-							prefix += ": ";
-							this->logger.addLog(Level::VERBOSE, prefix + playerLine);
-
-							//send line to referee
-							if (!referee.writePipe(playerLine)) {
-								throw std::exception("Could not write to the referee.");
-							}
-						}
-						
-						//get next line from referee
-						line = referee.readPipe(Process::OUTPUT);
-					}
-					else if (line.starts_with("###Error")) {
-						//player process made an warning level error, lets log it.
-						int target = toInteger(line[9]);
-						std::string logLine = "Error for player " + target;
-						logLine += " in game " + game;
-						logLine += ": " + line.substr(9);
-						this->logger.addLog(Level::WARN, logLine);
-					}
-				}
-
-
-				// End of the game
-				// unswap the positions to declare the correct winner
-				std::string unrotated = "";
-				for (int i = 0; i < line.length(); i++) {
-					char c = line[i];
-					if (c >= '0' && c <= '9') {
-						c -= '0';
-						c += rotate;
-						c %= players.size();
-						c += '0';
-					}
-					unrotated += c;
-				}
-				line = unrotated;
-
-				//log it
-				this->logger.addLog(Level::VERBOSE, "Referee: " + line);
-
-				//add it to stats object
-				playerStats.get().add(line);
-
-				//log end of game
-				std::string logLine = "End of game " + game;
-				logLine += ": " + line.substr(7);
-				logLine += "\t" + playerStats.get().toString();
-				this->logger.addLog(Level::INFO, "Referee: " + logLine);
-			}
-			else {
-				throw std::exception("Unexpected output from referee");
-
-			}
-		}
-		catch (std::exception& e) {
-			//something went really wrong, lets log it. 
-			logString = "Exception in game " + std::to_string(game) + ": " + e.what();
-			logger.addLog(Level::FATAL, logString);
-		}
-
-		setFinished();
-	}
+
+
+#include "OldGameThread.h"
+
+OldGameThread::OldGameThread(int id, std::string refereeCmd, std::vector<std::string> playersCmd, Mutable<int>& count, Mutable<PlayerStats>& playerStats, Mutable<SeedGenerator>& seeder, ResultsJournal& journal, Reaper& reaper, int n, bool swap, Level verbose, std::string path, std::string file)
+	:ThreadedGame{ id, refereeCmd, playersCmd, count, playerStats, seeder, journal, reaper, n, swap, verbose, path, file } {
+}
+
+OldGameThread::~OldGameThread() {
+	// Delete vector objects
+	seedRotate.clear();
+	players.clear();
+}
+
+bool OldGameThread::start() {
+	logString = "Swap flag set to ";
+	logString += (swap ? "true." : "false.");
+	logger.addLog(Level::VERBOSE, logString);
+
+	//the protocol loop needs these on every reply, build them once
+	playerPrefixes.clear();
+	for (int i = 0; i < playersCount; ++i) {
+		playerPrefixes.push_back("Player " + std::to_string(i));
+	}
+
+	// Call the start function in ThreadedGame
+	logger.addLog(Level::VERBOSE, "OldGameThread, calling start in ThreadedGame.");
+	ThreadedGame::start();
+	return true;
+}
+
+bool OldGameThread::spawnProcesses() {
+	if (!createGroup()) {
+		logger.addLog(Level::FATAL, "Cannot create the process group.");
+		return false;
+	}
+
+	int pid = game * 10;
+	referee = Process(pid, refereeCmd);
+	players.clear();
+	for (size_t i = 0; i < playersCount; i++) {
+		pid++;
+		players.push_back(Process(pid, playersCmd[i]));
+	}
+
+	// Spawn referee process
+	logger.addLog(Level::VERBOSE, "Attempting to start Referee.");
+	{
+		TraceSpan span(trace, "spawn referee", game);
+		auto spawnStart = std::chrono::steady_clock::now();
+		if (!this->referee.start(ResourceProfile(), group.getHandle())) {
+			logger.addLog(Level::FATAL, "Cannot start Referee.");
+			return false;
+		}
+		if (metrics != NULL) metrics->spawned(std::chrono::steady_clock::now() - spawnStart);
+	}
+	logger.addLog(Level::VERBOSE, "Referee Started.");
+
+	// Spawn players process
+	for (size_t i = 0; i < playersCount; i++) {
+		logString = "Attempting to start player " + std::to_string(i);
+		logger.addLog(Level::VERBOSE, logString);
+		if (sharedMemory) players[i].enableSharedMemory();
+		TraceSpan span(trace, "spawn player", game, (int)i);
+		auto spawnStart = std::chrono::steady_clock::now();
+		if (!players[i].start(profile, group.getHandle())) {
+			logger.addLog(Level::FATAL, "Cannot start player file.");
+			return false;
+		}
+		if (metrics != NULL) metrics->spawned(std::chrono::steady_clock::now() - spawnStart);
+		logString = "Player " + std::to_string(i);
+		logString += " started.";
+		logger.addLog(Level::VERBOSE, logString);
+	}
+
+	return true;
+}
+
+void OldGameThread::run() {
+
+	while (!shouldStop() || !isFinished()) {
+		
+		if (!nextGame()) {
+			// End of this thread
+			setFinished();
+			break;
+		}
+		TraceSpan gameSpan(trace, "game", game);
+		try {
+			//start a log block
+			logString = "Game " + std::to_string(game);
+			logger.addLog(Level::VERBOSE, logString);
+
+			//pick the seed first, a cached game needs nothing spawned
+			bool seeded = true;
+			long long seed = 0;
+			if (scheduler != NULL) {
+				seed = order.seed;
+				rotate = order.rotation;
+			}
+			else {
+				seedRotate = seeder.get().getSeed(playersCount);
+				rotate = swap ? seedRotate[1] : 0;
+				seeded = swap || seeder.get().repeteableTests;
+				if (swap) {
+					seed = seedRotate[0];
+				}
+				else if (seeded) {
+					seed = seeder.get().getSeed(playersCount)[0];
+				}
+			}
+
+			//without a seed the referee picks one, such a game cannot be cached
+			cacheKey.clear();
+			if (seeded && loadCachedResult(seed)) {
+				continue;
+			}
+
+			//every game gets fresh processes, so usage and crashes are per game
+			if (!spawnProcesses()) {
+				throw std::exception("Could not start the game processes.");
+			}
+			
+			//send the seed to the referee
+			if (seeded) {
+				logString = "###Seed " + std::to_string(seed);
+				if (!referee.writeLine(logString)) {
+					throw std::exception("Could not write to the referee.");
+				}
+			}
+
+			//send number of players to referee
+			logString = "###Start " + std::to_string(players.size());
+			if (!referee.writeLine(logString)) {
+				throw std::exception("Could not write to the referee.");
+			}
+
+			//get a line from the referee, the view lives until the referee is read again
+			std::string_view line;
+			bool started;
+			{
+				TraceSpan span(trace, "referee wait", game);
+				started = referee.readLine(line);
+			}
+			if (started) {
+				//log the referee line
+				if (verbose == Level::VERBOSE) {
+					this->logger.addLog(Level::VERBOSE, "Referee " + std::string(line));
+				}
+
+				//players that got their input and still owe a reply, they think at the same time and are read at the same time
+				std::vector<Process*> thinking;
+				std::vector<std::chrono::steady_clock::time_point> inputAt(playersCount);
+				//players that missed a reply, their late lines would answer the next ###Output so they are never read again
+				std::vector<bool> timedOut(playersCount, false);
+
+				//run the game
+				OldCommand command;
+				while (true) {
+					if (!OldProtocol::parse(line, command)) {
+						throw std::exception(("Malformed command from the referee: " + std::string(line)).c_str());
+					}
+					if (command.type == CMD_END) {
+						break;
+					}
+
+					//clear the error stream
+					clearErrorStream(referee.getHandle(Process::ERR), "Referee error: ");
+
+					if ((command.type == CMD_INPUT || command.type == CMD_OUTPUT) && command.player >= (int)players.size()) {
+						throw std::exception(("The referee targeted an unknown player: " + std::string(line)).c_str());
+					}
+
+					//the referee talks about seats, with swap the player in seat s is players[(s + rotate) % playersCount]
+					int index = command.player >= 0 ? (command.player + rotate) % playersCount : command.player;
+
+					if (command.type == CMD_INPUT) {
+						// Read all lines from the referee until next command and give it to the targeted process
+						Process& target = players[index];
+						TraceSpan span(trace, "###Input", game, index);
+
+						//get every line up to the next command, straight from the referee's buffer
+						std::string_view block;
+						if (!referee.readBlock(block, line)) {
+							throw std::exception("The referee stopped answering.");
+						}
+
+						//log the lines
+						if (verbose == Level::VERBOSE) {
+							logBlock("Referee: ", block);
+						}
+
+						//a timed out player gets nothing more, it may be stuck writing a reply nobody reads
+						if (timedOut[index]) {
+							continue;
+						}
+
+						//send these lines to the targeted player, all in one write
+						if (!target.writeLines(block)) {
+							throw std::exception(("Could not write to the Player " + std::to_string(index)).c_str());
+						}
+
+						//the player is thinking now
+						if (std::find(thinking.begin(), thinking.end(), &target) == thinking.end()) {
+							thinking.push_back(&target);
+							inputAt[index] = std::chrono::steady_clock::now();
+						}
+					}
+					else if (command.type == CMD_OUTPUT) {
+						// Read x lines from the targeted process and give to the referee
+						Process& target = players[index];
+						int x = command.count;
+						TraceSpan span(trace, "###Output", game, index);
+
+						//clear error stream
+						clearErrorStream(target.getHandle(Process::ERR), playerPrefixes[index] + " error: ");
+
+						//wait for the target's reply, buffering the replies of the other thinking players as they come in
+						if (timedOut[index]) {
+							//already timed out, the referee gets empty lines without waiting
+						}
+						else if (!Process::waitForLines(target, x, thinking, replyTimeout)) {
+							timedOut[index] = true;
+							logString = playerPrefixes[index] + " did not reply in game " + std::to_string(game) + ", the referee gets empty lines for it from now on.";
+							logger.addLog(Level::WARN, logString);
+							cacheable = false;
+							if (metrics != NULL) metrics->timeout(index);
+						}
+						else if (metrics != NULL) {
+							metrics->turn(index, std::chrono::steady_clock::now() - inputAt[index]);
+						}
+						thinking.erase(std::remove(thinking.begin(), thinking.end(), &target), thinking.end());
+
+						//take the lines from the player, they are already buffered. A timed out player's partial reply is dropped.
+						std::string_view reply;
+						int taken = 0;
+						if (!timedOut[index]) taken = target.takeLines(x, reply);
+
+						//log the lines
+						if (verbose == Level::VERBOSE) {
+							logBlock(playerPrefixes[index] + ": ", reply);
+						}
+
+						//send the lines to the referee in one write, padded with empty lines if the player did not reply
+						bool written;
+						if (taken == x) {
+							written = referee.writeLines(reply);
+						}
+						else {
+							std::string padded(reply);
+							padded.append(x - taken, '\n');
+							written = referee.writeLines(padded);
+						}
+						if (!written) {
+							throw std::exception("Could not write to the referee.");
+						}
+						span.end();
+
+						//get next line from referee
+						readReferee(line);
+					}
+					else {
+						if (command.type == CMD_ERROR) {
+							//player process made an warning level error, lets log it. Without a player, it is the referee's own.
+							std::string logLine = index >= 0 ? "Error for player " + std::to_string(index) : "Referee error";
+							logLine += " in game " + std::to_string(game);
+							logLine += ": " + std::string(command.text);
+							this->logger.addLog(Level::WARN, logLine);
+						}
+
+						//get next line from referee
+						readReferee(line);
+					}
+				}
+
+
+				// End of the game
+				// unswap the positions to declare the correct winner
+				std::string unrotated = "###End ";
+				for (char c : command.text) {
+					if (c >= '0' && c <= '9') {
+						c -= '0';
+						c += rotate;
+						c %= players.size();
+						c += '0';
+					}
+					unrotated += c;
+				}
+
+				//log it
+				this->logger.addLog(Level::VERBOSE, "Referee: " + unrotated);
+
+				//add it to stats object
+				gameScores = PlayerStats::rankingToScores(unrotated, playersCount);
+				{
+					TraceSpan span(trace, "stats merge", game);
+					playerStats.get().add(gameScores);
+				}
+				journal.addRecord(game, "result", unrotated);
+				storeResult(unrotated);
+
+				//log end of game
+				std::string logLine = "End of game " + std::to_string(game);
+				logLine += ": " + unrotated.substr(7);
+				logLine += "\t" + playerStats.get().toString();
+				this->logger.addLog(Level::INFO, "Referee: " + logLine);
+			}
+			else {
+				throw std::exception("Unexpected output from referee");
+
+			}
+		}
+		catch (std::exception& e) {
+			//something went really wrong, lets log it. 
+			logString = "Exception in game " + std::to_string(game) + ": " + e.what();
+			logger.addLog(Level::FATAL, logString);
+		}
+
+		//also after a failed game, a broken limit is the likely cause
+		collectUsage();
+		teardown();
+	}
+}
+
+void OldGameThread::readReferee(std::string_view& line) {
+	TraceSpan span(trace, "referee wait", game);
+	if (!referee.readLine(line)) {
+		throw std::exception("The referee stopped answering.");
+	}
 }
\ No newline at end of file
@@ -1,41 +1,61 @@
-#ifndef OLDGAMETHREAD_H
-#define OLDGAMETHREAD_H
-
-#include "ThreadedGame.h"
-
-/*
- * @brief Class describing an OldGameThread object. This is the old way Referees communicate with Players.
- */
-class OldGameThread : public ThreadedGame {
-
-public:
-    /*
-     * @brief Constructs an OldGameThread object.
-     *
-     * @param id The id.
-     * @param refereeCmd The referee command line.
-     * @param playersCmd The vector of player command lines.
-     * @param count The shared count of games.
-     * @param playerStats The playerStats object.
-     * @param seeder the shared rng seeder object.
-     * @param swap Are we swapping player positions?
-     * @param verbose The verbosity to use for the logs.
-     */
-    OldGameThread(int id, std::string refereeCmd, std::vector<std::string> playersCmd, Mutable<int>& count, Mutable<PlayerStats>& playerStats, Mutable<SeedGenerator>& seeder, int n, bool swap, Level verbose, std::string path, std::string file);
-
-    /*
-     * @brief Destructs the OldGameThread object.
-     */
-    ~OldGameThread();   
-
-    /*
-     * @brief sets up the processes and calls start in the base class ThreadedGame 
-     */
-    bool start();
-
-    /*
-     * @brief The run method from the Threadable base class we must overide.
-     */
-    void run() override;    
-};
+#ifndef OLDGAMETHREAD_H
+#define OLDGAMETHREAD_H
+
+#include <algorithm>
+#include "ThreadedGame.h"
+#include "OldProtocol.h"
+
+/*
+ * @brief Class describing an OldGameThread object. This is the old way Referees communicate with Players.
+ */
+class OldGameThread : public ThreadedGame {
+private:
+    std::vector<std::string> playerPrefixes;    //< "Player N" for the logs, by player index
+
+    /*
+     * @brief Spawns this game's referee and player processes.
+     *
+     * @return success true or false.
+     */
+    bool spawnProcesses();
+
+    /*
+     * @brief Reads the next line from the referee.
+     *
+     * @param line Set to the line. The view lives until the referee is read again.
+     */
+    void readReferee(std::string_view& line);
+
+public:
+    /*
+     * @brief Constructs an OldGameThread object.
+     *
+     * @param id The id.
+     * @param refereeCmd The referee command line.
+     * @param playersCmd The vector of player command lines.
+     * @param count The shared count of games.
+     * @param playerStats The playerStats object.
+     * @param seeder the shared rng seeder object.
+     * @param journal the shared results journal.
+     * @param reaper the shared teardown thread.
+     * @param swap Are we swapping player positions?
+     * @param verbose The verbosity to use for the logs.
+     */
+    OldGameThread(int id, std::string refereeCmd, std::vector<std::string> playersCmd, Mutable<int>& count, Mutable<PlayerStats>& playerStats, Mutable<SeedGenerator>& seeder, ResultsJournal& journal, Reaper& reaper, int n, bool swap, Level verbose, std::string path, std::string file);
+
+    /*
+     * @brief Destructs the OldGameThread object.
+     */
+    ~OldGameThread();   
+
+    /*
+     * @brief sets up the processes and calls start in the base class ThreadedGame 
+     */
+    bool start();
+
+    /*
+     * @brief The run method from the Threadable base class we must overide.
+     */
+    void run() override;    
+};
 #endif
\ No newline at end of file
@@ -0,0 +1,125 @@
+#include "OldProtocol.h"
+
+void OldProtocol::skipSpaces(const char*& it, const char* end) {
+    while (it != end && *it == ' ') ++it;
+}
+
+bool OldProtocol::readNumber(const char*& it, const char* end, long long& value) {
+    skipSpaces(it, end);
+
+    bool negative = it != end && *it == '-';
+    if (negative) ++it;
+
+    const char* digits = it;
+    unsigned long long magnitude = 0;
+    while (it != end && *it >= '0' && *it <= '9') {
+        //more than 18 digits could overflow, no player id, count or seed is that long
+        if (it - digits == 18) return false;
+        magnitude = magnitude * 10 + (unsigned long long)(*it - '0');
+        ++it;
+    }
+
+    //a number must have digits and end at a space or the end of the line, "1x" is not 1
+    if (it == digits || (it != end && *it != ' ')) {
+        return false;
+    }
+    value = negative ? -(long long)magnitude : (long long)magnitude;
+    return true;
+}
+
+bool OldProtocol::readIndex(const char*& it, const char* end, int& value) {
+    long long number;
+    if (!readNumber(it, end, number) || number < 0 || number > INT_MAX) {
+        return false;
+    }
+    value = (int)number;
+    return true;
+}
+
+bool OldProtocol::parse(std::string_view line, OldCommand& command) {
+    command = OldCommand();
+
+    const char* it = line.data();
+    const char* end = it + line.size();
+    while (end != it && (end[-1] == '\n' || end[-1] == '\r')) --end;
+
+    if (end - it < 3 || it[0] != '#' || it[1] != '#' || it[2] != '#') {
+        return true;
+    }
+    it += 3;
+
+    //the keyword runs up to the first space, "###Inputs" is not "###Input"
+    const char* keywordEnd = it;
+    while (keywordEnd != end && *keywordEnd != ' ') ++keywordEnd;
+    std::string_view keyword(it, keywordEnd - it);
+    it = keywordEnd;
+
+    //dispatch on the first letter, then one compare
+    switch (keyword.empty() ? '\0' : keyword[0]) {
+    case 'I':
+        command.type = keyword == "Input" ? CMD_INPUT : CMD_UNKNOWN;
+        break;
+    case 'O':
+        command.type = keyword == "Output" ? CMD_OUTPUT : CMD_UNKNOWN;
+        break;
+    case 'E':
+        command.type = keyword == "End" ? CMD_END : keyword == "Error" ? CMD_ERROR : CMD_UNKNOWN;
+        break;
+    case 'S':
+        command.type = keyword == "Start" ? CMD_START : keyword == "Seed" ? CMD_SEED : CMD_UNKNOWN;
+        break;
+    default:
+        command.type = CMD_UNKNOWN;
+    }
+
+    switch (command.type) {
+    case CMD_START:
+        return readIndex(it, end, command.count) && command.count > 0;
+    case CMD_SEED:
+        return readNumber(it, end, command.seed);
+    case CMD_INPUT:
+        return readIndex(it, end, command.player);
+    case CMD_OUTPUT:
+        return readIndex(it, end, command.player) && readIndex(it, end, command.count);
+    case CMD_ERROR: {
+        //the player is optional, the message is whatever follows
+        const char* afterPlayer = it;
+        if (readIndex(afterPlayer, end, command.player)) {
+            it = afterPlayer;
+        }
+        else {
+            command.player = -1;
+        }
+        skipSpaces(it, end);
+        command.text = std::string_view(it, end - it);
+        return true;
+    }
+    case CMD_END:
+        skipSpaces(it, end);
+        command.text = std::string_view(it, end - it);
+        return true;
+    default:
+        return true;
+    }
+}
+
+std::string_view OldProtocol::typeToString(OldCommandType type) {
+    switch (type) {
+    case CMD_START:
+        return "###Start";
+    case CMD_SEED:
+        return "###Seed";
+    case CMD_INPUT:
+        return "###Input";
+    case CMD_OUTPUT:
+        return "###Output";
+    case CMD_ERROR:
+        return "###Error";
+    case CMD_END:
+        return "###End";
+    case CMD_UNKNOWN:
+        return "###?";
+    default:
+        return "";
+    }
+}
@@ -0,0 +1,81 @@
+#ifndef OLDPROTOCOL_H
+#define OLDPROTOCOL_H
+
+#include <string_view>
+#include <climits>
+
+enum OldCommandType { CMD_NONE, CMD_UNKNOWN, CMD_START, CMD_SEED, CMD_INPUT, CMD_OUTPUT, CMD_ERROR, CMD_END };
+
+/*
+ * @brief Struct describing one parsed line of the old cg-brutaltester referee protocol.
+ *
+ * The views point into the parsed line, so they live as long as the line does.
+ */
+struct OldCommand {
+    OldCommandType type = CMD_NONE;     //< the command, CMD_NONE if the line is not a command at all
+    int player = -1;                    //< the player of ###Input, ###Output and ###Error, -1 if none
+    int count = 0;                      //< the number of players of ###Start, the number of lines of ###Output
+    long long seed = 0;                 //< the seed of ###Seed
+    std::string_view text;              //< the message of ###Error, the ranking of ###End
+};
+
+/*
+ * @brief Class parsing the old protocol: ###Start, ###Seed, ###Input, ###Output, ###Error and ###End.
+ *
+ * It runs on every line of every old mode game, so it never allocates and never copies, it only slices the line.
+ * Player ids and counts may have any number of digits.
+ */
+class OldProtocol {
+private:
+    /*
+     * @brief Moves past the spaces at the cursor.
+     *
+     * @param it The cursor.
+     * @param end The end of the line.
+     */
+    static void skipSpaces(const char*& it, const char* end);
+
+    /*
+     * @brief Reads the next space separated token as a number, a minus sign is allowed.
+     *
+     * @param it The cursor, moved past the number.
+     * @param end The end of the line.
+     * @param value Set to the number.
+     *
+     * @return true if the token is a whole number of at most 18 digits.
+     */
+    static bool readNumber(const char*& it, const char* end, long long& value);
+
+    /*
+     * @brief Reads the next space separated token as a player id or a count.
+     *
+     * @param it The cursor, moved past the number.
+     * @param end The end of the line.
+     * @param value Set to the number.
+     *
+     * @return true if the token is a whole number that is not negative and fits in an int.
+     */
+    static bool readIndex(const char*& it, const char* end, int& value);
+
+public:
+    /*
+     * @brief Parses one line from the referee.
+     *
+     * @param line The line, with or without its line break.
+     * @param command Set to the parsed command.
+     *
+     * @return false if the line is a command with missing or broken arguments, ex. "###Output 1".
+     */
+    static bool parse(std::string_view line, OldCommand& command);
+
+    /*
+     * @brief Converts a command type to its name in the protocol.
+     *
+     * @param type The command type.
+     *
+     * @return the name, ex. "###Input".
+     */
+    static std::string_view typeToString(OldCommandType type);
+};
+
+#endif
@@ -1,150 +1,215 @@
-#pragma once
-
-#include "PlayerStats.h"
-
-PlayerStats::PlayerStats() : number{ 0 }, total{ 0 }, empty{ true } {}
-PlayerStats::PlayerStats(int num) : number{ num }, total{ 0 }, empty{ true } {}
-PlayerStats::~PlayerStats() { stats.clear(); global.clear(); }
-void PlayerStats::add(std::vector<int> scores) {
-	empty = false;
-	for (int i = 0; i < number; ++i) {
-		for (int j = i + 1; j < number; ++j) {
-			if (scores[i] > scores[j]) {
-				stats[i][j][VICTORY] += 1;
-				stats[j][i][DEFEAT] += 1;
-				global[i][VICTORY] += 1;
-				global[j][DEFEAT] += 1;
-			}
-			else if (scores[i] < scores[j]) {
-				stats[j][i][VICTORY] += 1;
-				stats[i][j][DEFEAT] += 1;
-				global[j][VICTORY] += 1;
-				global[i][DEFEAT] += 1;
-			}
-			else {
-				stats[i][j][DRAW] += 1;
-				stats[j][i][DRAW] += 1;
-				global[i][DRAW] += 1;
-				global[j][DRAW] += 1;
-			}
-		}
-	}
-
-	total += 1;
-}
-void PlayerStats::add(std::string line) {
-	empty = false;
-	std::vector<std::string> params;
-	std::vector<int> positions;
-
-	std::string delim = " ";
-
-	auto start = 0U;
-	auto end = line.find(delim);
-	while (end != std::string::npos)
-	{
-		params.push_back(line.substr(start, end - start));
-		start = (unsigned int)end + (unsigned int)delim.length();
-		end = line.find(delim, start);
-	}
-	params.push_back(line.substr(start, end));
-	for (int i = 1; i < params.size(); ++i) {
-		for (char c : params[i]) {
-			int pos = c - '0';
-			if (pos > 9) {
-				pos = c - 'A';
-			}
-			if (pos > 26) {
-				pos = c - 'a';
-			}
-			positions[pos] = i - 1;
-		}
-		for (int i = 0; i < number; ++i) {
-			for (int j = i + 1; j < number; ++j) {
-				if (positions[i] < positions[j]) {
-					stats[i][j][VICTORY] += 1;
-					stats[j][i][DEFEAT] += 1;
-					global[i][VICTORY] += 1;
-					global[j][DEFEAT] += 1;
-				}
-				else if (positions[i] > positions[j]) {
-					stats[j][i][VICTORY] += 1;
-					stats[i][j][DEFEAT] += 1;
-					global[j][VICTORY] += 1;
-					global[i][DEFEAT] += 1;
-				}
-				else {
-					stats[i][j][DRAW] += 1;
-					stats[j][i][DRAW] += 1;
-					global[i][DRAW] += 1;
-					global[j][DRAW] += 1;
-				}
-			}
-		}
-
-		total += 1;
-	}	
-}
-
-std::string PlayerStats::percent(float amount) {
-	return std::format("{:.2f}", amount * 100.0 / total) + "%";
-}
-std::string PlayerStats::toString() {
-	std::string result = "";
-	if (!empty) {
-		for (int i = 0; i < number; ++i) {
-			result += " ";
-			result += percent(global[i][VICTORY] / ((float)number - 1));
-		}
-	}
-	return result;
-}
-void PlayerStats::print() {
-	/*
-	+----------+----------+----------+----------+----------+
-	| Results  | Player 1 | Player 2 | Player 3 | Player 4 |
-	+----------+----------+----------+----------+----------+
-	| Player 1 |          |  42%     | 100%     |  32.46%  |
-	+----------+----------+----------+----------+----------+
-	| Player 2 | 42.36%   |          | 100%     |  100%    |
-	+----------+----------+----------+----------+----------+
-	| Player 3 | 42.36%   |  99.99%  |          |  100%    |
-	+----------+----------+----------+----------+----------+
-	| Player 4 | 42.36%   |  99.99%  | 17.8%    |          |
-	+----------+----------+----------+----------+----------+
-	*/
-	if (!empty) {
-		std::string separator = "";
-
-		if (number == 2) { separator = "+----------+----------+----------+"; }
-		else if (number == 3) { separator = "+----------+----------+----------+----------+"; }
-		else if (number == 4) { separator = "+----------+----------+----------+----------+----------+"; }
-
-		std::cout << separator << std::endl;
-		std::cout << "| Results  |" << std::endl;
-		for (int i = 0; i < number; ++i) {
-			std::cout << " Player " << (i + 1) << " |";
-		}
-		std::cout << std::endl;
-		std::cout << separator << std::endl;
-		std::string space = "         ";
-		std::string result = "";
-		for (int i = 0; i < number; ++i) {
-			std::cout << "| Player " << (i + 1) << " |";
-
-			for (int j = 0; j < number; ++j) {
-				result = "";
-
-				if (i != j) {
-					result = percent((float)stats[i][j][VICTORY]);
-				}
-
-				std::cout << " " << result << space.substr(result.length()) + "|";
-			}
-
-			std::cout << std::endl;
-			std::cout << separator << std::endl;
-
-		}
-	}
-}
\ No newline at end of file
+#pragma once
+
+#include "PlayerStats.h"
+
+PlayerStats::PlayerStats() : number{ 0 }, total{ 0 }, empty{ true } {}
+PlayerStats::PlayerStats(int num) : stats(num, std::vector<std::vector<int> >(num, std::vector<int>(DRAW + 1, 0))), global(num, std::vector<int>(DRAW + 1, 0)), number{ num }, total{ 0 }, empty{ true }, usageTotal(num), usageMax(num), usageGames(num, 0), violations(num, std::vector<int>(PROCESS_LIMIT + 1, 0)) {}
+PlayerStats::~PlayerStats() { stats.clear(); global.clear(); usageTotal.clear(); usageMax.clear(); usageGames.clear(); violations.clear(); }
+void PlayerStats::add(std::vector<int> scores) {
+	empty = false;
+	for (int i = 0; i < number; ++i) {
+		for (int j = i + 1; j < number; ++j) {
+			if (scores[i] > scores[j]) {
+				stats[i][j][VICTORY] += 1;
+				stats[j][i][DEFEAT] += 1;
+				global[i][VICTORY] += 1;
+				global[j][DEFEAT] += 1;
+			}
+			else if (scores[i] < scores[j]) {
+				stats[j][i][VICTORY] += 1;
+				stats[i][j][DEFEAT] += 1;
+				global[j][VICTORY] += 1;
+				global[i][DEFEAT] += 1;
+			}
+			else {
+				stats[i][j][DRAW] += 1;
+				stats[j][i][DRAW] += 1;
+				global[i][DRAW] += 1;
+				global[j][DRAW] += 1;
+			}
+		}
+	}
+
+	total += 1;
+}
+void PlayerStats::add(std::string line) {
+	add(rankingToScores(line, number));
+}
+
+std::vector<int> PlayerStats::rankingToScores(std::string_view line, int number) {
+	//"###End 0 12" is player 0 first, then players 1 and 2 tied, the first group gets the highest score
+	std::vector<std::string_view> groups;
+	size_t start = line.find(' ');
+	while (start != std::string_view::npos) {
+		start = line.find_first_not_of(' ', start);
+		if (start == std::string_view::npos) break;
+		size_t end = line.find(' ', start);
+		groups.push_back(line.substr(start, end == std::string_view::npos ? std::string_view::npos : end - start));
+		start = end;
+	}
+
+	std::vector<int> scores(number, 0);
+	for (int g = 0; g < (int)groups.size(); ++g) {
+		for (char c : groups[g]) {
+			int pos = -1;
+			if (c >= '0' && c <= '9') pos = c - '0';
+			else if (c >= 'A' && c <= 'Z') pos = c - 'A' + 10;
+			else if (c >= 'a' && c <= 'z') pos = c - 'a' + 10;
+			if (pos >= 0 && pos < number) scores[pos] = (int)groups.size() - g;
+		}
+	}
+	return scores;
+}
+
+void PlayerStats::addUsage(int player, const ResourceUsage& usage) {
+	if (player < 0 || player >= number) return;
+
+	ResourceUsage& sum = usageTotal[player];
+	sum.peakWorkingSet += usage.peakWorkingSet;
+	sum.peakCommit += usage.peakCommit;
+	sum.userTime += usage.userTime;
+	sum.kernelTime += usage.kernelTime;
+	sum.pageFaults += usage.pageFaults;
+
+	usageMax[player].update(usage);
+	usageGames[player] += 1;
+}
+
+void PlayerStats::addViolation(int player, Violation violation) {
+	if (player < 0 || player >= number || violation == NO_VIOLATION) return;
+	violations[player][violation] += 1;
+}
+
+std::string PlayerStats::percent(float amount) {
+	return std::format("{:.2f}", amount * 100.0 / total) + "%";
+}
+std::string PlayerStats::toString() {
+	std::string result = "";
+	if (!empty) {
+		for (int i = 0; i < number; ++i) {
+			result += " ";
+			result += percent(global[i][VICTORY] / ((float)number - 1));
+		}
+	}
+	return result;
+}
+void PlayerStats::print() {
+	/*
+	+----------+----------+----------+----------+----------+
+	| Results  | Player 1 | Player 2 | Player 3 | Player 4 |
+	+----------+----------+----------+----------+----------+
+	| Player 1 |          |  42%     | 100%     |  32.46%  |
+	+----------+----------+----------+----------+----------+
+	| Player 2 | 42.36%   |          | 100%     |  100%    |
+	+----------+----------+----------+----------+----------+
+	| Player 3 | 42.36%   |  99.99%  |          |  100%    |
+	+----------+----------+----------+----------+----------+
+	| Player 4 | 42.36%   |  99.99%  | 17.8%    |          |
+	+----------+----------+----------+----------+----------+
+	*/
+	if (!empty) {
+		std::string separator = "";
+
+		if (number == 2) { separator = "+----------+----------+----------+"; }
+		else if (number == 3) { separator = "+----------+----------+----------+----------+"; }
+		else if (number == 4) { separator = "+----------+----------+----------+----------+----------+"; }
+
+		std::cout << separator << std::endl;
+		std::cout << "| Results  |" << std::endl;
+		for (int i = 0; i < number; ++i) {
+			std::cout << " Player " << (i + 1) << " |";
+		}
+		std::cout << std::endl;
+		std::cout << separator << std::endl;
+		std::string space = "         ";
+		std::string result = "";
+		for (int i = 0; i < number; ++i) {
+			std::cout << "| Player " << (i + 1) << " |";
+
+			for (int j = 0; j < number; ++j) {
+				result = "";
+
+				if (i != j) {
+					result = percent((float)stats[i][j][VICTORY]);
+				}
+
+				std::cout << " " << result << space.substr(result.length()) + "|";
+			}
+
+			std::cout << std::endl;
+			std::cout << separator << std::endl;
+
+		}
+
+		//games a player broke a resource limit in are an outcome of their own, next to the wins
+		bool broken = false;
+		for (int i = 0; i < number; ++i) {
+			if (limitGames(i) > 0) broken = true;
+		}
+		if (broken) {
+			std::cout << "| Limits   |";
+			for (int i = 0; i < number; ++i) {
+				result = percent((float)limitGames(i));
+				std::cout << " " << result << space.substr(result.length()) + "|";
+			}
+			std::cout << std::endl;
+			std::cout << separator << std::endl;
+		}
+	}
+}
+
+int PlayerStats::limitGames(int player) const {
+	//a player gets at most one violation per game, the first limit it broke
+	int games = 0;
+	for (int v = MEMORY_LIMIT; v <= PROCESS_LIMIT; ++v) {
+		games += violations[player][v];
+	}
+	return games;
+}
+
+void PlayerStats::printUsage() {
+	/*
+	+----------+----------+----------+----------+----------+----------+
+	| Usage    | Max RSS  | Max mem  | Avg mem  | Avg CPU  | Max CPU  |
+	+----------+----------+----------+----------+----------+----------+
+	| Player 1 | 12.4 MB  | 9.1 MB   | 8.7 MB   | 812 ms   | 1204 ms  |
+	+----------+----------+----------+----------+----------+----------+
+	*/
+	bool any = false;
+	for (int i = 0; i < number; ++i) {
+		if (usageGames[i] > 0) any = true;
+	}
+	if (!any) return;
+
+	auto mb = [](double bytes) { return std::format("{:.1f} MB", bytes / (1024.0 * 1024.0)); };
+	auto ms = [](double us) { return std::format("{:.0f} ms", us / 1000.0); };
+
+	std::string separator = "+----------+----------+----------+----------+----------+----------+";
+	std::cout << separator << std::endl;
+	std::cout << "| Usage    | Max RSS  | Max mem  | Avg mem  | Avg CPU  | Max CPU  |" << std::endl;
+	std::cout << separator << std::endl;
+	for (int i = 0; i < number; ++i) {
+		if (usageGames[i] == 0) continue;
+		double games = (double)usageGames[i];
+		const ResourceUsage& sum = usageTotal[i];
+		const ResourceUsage& max = usageMax[i];
+
+		std::cout << "| Player " << (i + 1) << " |";
+		std::cout << std::format(" {:<9}|", mb((double)max.peakWorkingSet));
+		std::cout << std::format(" {:<9}|", mb((double)max.peakCommit));
+		std::cout << std::format(" {:<9}|", mb(sum.peakCommit / games));
+		std::cout << std::format(" {:<9}|", ms((sum.userTime + sum.kernelTime) / games));
+		std::cout << std::format(" {:<9}|", ms((double)(max.userTime + max.kernelTime)));
+		std::cout << std::endl;
+		std::cout << separator << std::endl;
+	}
+
+	//games lost to a resource limit, reported apart from ordinary losses
+	for (int i = 0; i < number; ++i) {
+		for (int v = MEMORY_LIMIT; v <= PROCESS_LIMIT; ++v) {
+			if (violations[i][v] > 0) {
+				std::cout << "Player " << (i + 1) << " broke the " << ResourceProfile::violationToString((Violation)v) << " limit in " << violations[i][v] << " games." << std::endl;
+			}
+		}
+	}
+}
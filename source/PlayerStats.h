@@ -1,56 +1,103 @@
-#ifndef PLAYERSTATS_H
-#define PLAYERSTATS_H
-
-#include <string>
-#include <vector>
-#include <format>
-#include <iostream>
-
-enum Result { VICTORY, DEFEAT, DRAW };
-/**
- * @brief Class representing Player Statistics
- */
-class PlayerStats {
-private:
-	std::vector<std::vector<std::vector<int> > > stats;		//< the individual statistics
-	std::vector<std::vector<int> > global;					//< the global statistics
-	int number;												//< the number of players
-	int total;												//< the total
-	bool empty;												//< has anything been added?
-
-public:
-	/**
-	 * @brief Constructs a default Player Statistics object with size of 0.
-	 */
-	PlayerStats();
-	
-	/**
-	 * @brief Constructs a Player Statistics object with size num.
-	 * 
-	 * @param num the number of players
-	 */
-	PlayerStats(int num);
-
-	/**
-	 * @brief Destructs the Player Statistics object.
-	 */
-	~PlayerStats();
-
-	/**
-	 * @brief append the stat list.
-	 *
-	 * @param scores array the scores to append
-	 */
-	void add(std::vector<int> scores);
-
-	/**
-	 * @brief append the stat list.
-	 *
-	 * @param line csv list the scores to append
-	 */
-	void add(std::string line);
-	std::string percent(float amount);
-	std::string toString();
-	void print();
-};
+#ifndef PLAYERSTATS_H
+#define PLAYERSTATS_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <format>
+#include <iostream>
+#include "ResourceUsage.h"
+#include "ResourceProfile.h"
+
+enum Result { VICTORY, DEFEAT, DRAW };
+/**
+ * @brief Class representing Player Statistics
+ */
+class PlayerStats {
+private:
+	std::vector<std::vector<std::vector<int> > > stats;		//< the individual statistics
+	std::vector<std::vector<int> > global;					//< the global statistics
+	int number;												//< the number of players
+	int total;												//< the total
+	bool empty;												//< has anything been added?
+	std::vector<ResourceUsage> usageTotal;					//< the summed resource usage of each player
+	std::vector<ResourceUsage> usageMax;					//< the worst single game resource usage of each player
+	std::vector<int> usageGames;							//< the number of games with a resource usage for each player
+	std::vector<std::vector<int> > violations;				//< the number of games each player broke each resource limit in
+
+public:
+	/**
+	 * @brief Constructs a default Player Statistics object with size of 0.
+	 */
+	PlayerStats();
+	
+	/**
+	 * @brief Constructs a Player Statistics object with size num.
+	 * 
+	 * @param num the number of players
+	 */
+	PlayerStats(int num);
+
+	/**
+	 * @brief Destructs the Player Statistics object.
+	 */
+	~PlayerStats();
+
+	/**
+	 * @brief append the stat list.
+	 *
+	 * @param scores array the scores to append
+	 */
+	void add(std::vector<int> scores);
+
+	/**
+	 * @brief append the stat list.
+	 *
+	 * @param line csv list the scores to append
+	 */
+	void add(std::string line);
+
+	/**
+	 * @brief converts an old mode ranking line to scores, higher is better. A player missing from the ranking scores 0.
+	 *
+	 * @param line the ranking, ex. "###End 0 12"
+	 * @param number the number of players
+	 *
+	 * @return the score of each player
+	 */
+	static std::vector<int> rankingToScores(std::string_view line, int number);
+
+	/**
+	 * @brief append the resource usage of one player for one game.
+	 *
+	 * @param player the player index
+	 * @param usage the resources the player used during the game
+	 */
+	void addUsage(int player, const ResourceUsage& usage);
+
+	/**
+	 * @brief append a broken resource limit of one player for one game.
+	 *
+	 * @param player the player index
+	 * @param violation the limit the player broke
+	 */
+	void addViolation(int player, Violation violation);
+
+	/**
+	 * @brief gets the number of games a player broke a resource limit in.
+	 *
+	 * @param player the player index
+	 *
+	 * @return the number of games
+	 */
+	int limitGames(int player) const;
+	std::string percent(float amount);
+	std::string toString();
+	void print();
+
+	/**
+	 * @brief prints the per player resource usage table, if any usage was added.
+	 */
+	void printUsage();
+};
 #endif
\ No newline at end of file
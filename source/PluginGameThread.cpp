@@ -0,0 +1,206 @@
+#include "PluginGameThread.h"
+
+PluginGameThread::PluginGameThread(int id, const RefereePlugin& plugin, std::string refereeCmd, std::vector<std::string> playersCmd, Mutable<int>& count, Mutable<PlayerStats>& playerStats, Mutable<SeedGenerator>& seeder, ResultsJournal& journal, Reaper& reaper, int n, bool swap, Level verbose, std::string path, std::string file)
+	:ThreadedGame{ id, refereeCmd, playersCmd, count, playerStats, seeder, journal, reaper, n, swap, verbose, path, file }, plugin{ plugin } {
+}
+
+PluginGameThread::~PluginGameThread() {
+	// Delete vector objects
+	seedRotate.clear();
+	players.clear();
+}
+
+bool PluginGameThread::start() {
+	logString = "Swap flag set to ";
+	logString += (swap ? "true." : "false.");
+	logger.addLog(Level::VERBOSE, logString);
+
+	// Call the start function in ThreadedGame
+	logger.addLog(Level::VERBOSE, "PluginGameThread, calling start in ThreadedGame.");
+	ThreadedGame::start();
+	return true;
+}
+
+bool PluginGameThread::spawnPlayers() {
+	if (!createGroup()) {
+		logger.addLog(Level::FATAL, "Cannot create the process group.");
+		return false;
+	}
+
+	int pid = game * 10;
+	players.clear();
+	for (size_t i = 0; i < playersCount; i++) {
+		pid++;
+		players.push_back(Process(pid, playersCmd[i]));
+	}
+
+	// Spawn players process
+	for (size_t i = 0; i < playersCount; i++) {
+		logString = "Attempting to start player " + std::to_string(i);
+		logger.addLog(Level::VERBOSE, logString);
+		if (sharedMemory) players[i].enableSharedMemory();
+		TraceSpan span(trace, "spawn player", game, (int)i);
+		auto spawnStart = std::chrono::steady_clock::now();
+		if (!players[i].start(profile, group.getHandle())) {
+			logger.addLog(Level::FATAL, "Cannot start player file.");
+			return false;
+		}
+		if (metrics != NULL) metrics->spawned(std::chrono::steady_clock::now() - spawnStart);
+		logString = "Player " + std::to_string(i);
+		logString += " started.";
+		logger.addLog(Level::VERBOSE, logString);
+	}
+	return true;
+}
+
+void PluginGameThread::run() {
+	while (true) {
+
+		if (!nextGame()) {
+			// End of this thread
+			setFinished();
+			break;
+		}
+		TraceSpan gameSpan(trace, "game", game);
+
+		RefereeGame* state = NULL;
+		try {
+			//start a log block
+			logString = "Game " + std::to_string(game);
+			logger.addLog(Level::VERBOSE, logString);
+
+			//the plugin always gets a seed, so every game can be cached
+			long long seed;
+			if (scheduler != NULL) {
+				seed = order.seed;
+				rotate = order.rotation;
+			}
+			else {
+				seedRotate = seeder.get().getSeed(playersCount);
+				seed = seedRotate[0];
+				rotate = swap ? seedRotate[1] : 0;
+			}
+			if (loadCachedResult(seed)) {
+				continue;
+			}
+
+			//only the players are processes, the referee lives in this thread
+			if (!spawnPlayers()) {
+				throw std::exception("Could not start the players.");
+			}
+
+			state = plugin.init(seed, playersCount);
+			if (state == NULL) {
+				throw std::exception("The referee plugin refused the game.");
+			}
+
+			playGame(state);
+		}
+		catch (std::exception& e) {
+			//something went really wrong, lets log it. 
+			logString = "Exception in game " + std::to_string(game) + ": " + e.what();
+			logger.addLog(Level::FATAL, logString);
+		}
+
+		if (state != NULL) {
+			plugin.free(state);
+		}
+
+		//also after a failed game, a broken limit is the likely cause
+		collectUsage();
+		teardown();
+	}
+}
+
+void PluginGameThread::playGame(RefereeGame* state) {
+	//the plugin sees positions, with swap the player at position p is players[(p + rotate) % playersCount]
+	int position;
+	//players that missed a reply
+	std::vector<bool> timedOut(playersCount, false);
+	while ((position = plugin.nextPlayer(state)) >= 0) {
+		if (position >= playersCount) {
+			throw std::exception(("The referee plugin asked for unknown player " + std::to_string(position) + ".").c_str());
+		}
+		int index = (position + rotate) % playersCount;
+		Process& player = players[index];
+		std::string prefix = "Player " + std::to_string(index);
+
+		//input from the referee, straight to the player
+		TraceSpan inputSpan(trace, "###Input", game, index);
+		const char* input = NULL;
+		size_t length = 0;
+		int lines = plugin.nextInput(state, position, &input, &length);
+		if (lines < 0) {
+			throw std::exception("The referee plugin could not give the input.");
+		}
+		std::string_view block(input, length);
+		if (verbose == Level::VERBOSE) {
+			logBlock("Referee: ", block);
+		}
+
+		//a timed out player is never read again, its late lines would answer the next turn, the plugin gets no answer
+		if (timedOut[index]) {
+			plugin.submitOutput(state, position, NULL, 0);
+			continue;
+		}
+		if (!player.writeLines(block)) {
+			throw std::exception(("Could not write to the " + prefix).c_str());
+		}
+		inputSpan.end();
+		auto inputAt = std::chrono::steady_clock::now();
+
+		//the player's reply, straight to the referee
+		TraceSpan outputSpan(trace, "###Output", game, index);
+		clearErrorStream(player.getHandle(Process::ERR), prefix + " error: ");
+		bool replied = lines == 0 || Process::waitForLines(player, lines, {}, replyTimeout);
+		auto replyAt = std::chrono::steady_clock::now();
+		std::string_view reply;
+		player.takeLines(lines, reply);
+		reply = Process::plainLines(reply, replyBuffer);
+		if (verbose == Level::VERBOSE) {
+			logBlock(prefix + ": ", reply);
+		}
+
+		if (!replied) {
+			timedOut[index] = true;
+			logString = prefix + " did not reply in game " + std::to_string(game) + ", it gets no more turns.";
+			logger.addLog(Level::WARN, logString);
+			cacheable = false;
+			if (metrics != NULL) metrics->timeout(index);
+		}
+		else if (metrics != NULL && lines > 0) {
+			metrics->turn(index, replyAt - inputAt);
+		}
+		if (plugin.submitOutput(state, position, replied ? reply.data() : NULL, replied ? reply.size() : 0) != 0) {
+			logString = prefix + " gave an invalid answer in game " + std::to_string(game) + ".";
+			logger.addLog(Level::WARN, logString);
+		}
+	}
+
+	// End of the game, back from positions to players
+	std::vector<int> positionScores(playersCount, 0);
+	if (plugin.result(state, positionScores.data(), playersCount) != 0) {
+		throw std::exception("The referee plugin could not give the result.");
+	}
+	std::vector<int> scores(playersCount, 0);
+	for (int p = 0; p < playersCount; ++p) {
+		scores[(p + rotate) % playersCount] = positionScores[p];
+	}
+
+	{
+		TraceSpan span(trace, "stats merge", game);
+		playerStats.get().add(scores);
+	}
+	gameScores = scores;
+
+	std::string result = "";
+	for (int score : scores) result += std::to_string(score) + " ";
+	journal.addRecord(game, "result", result);
+	storeResult(result);
+
+	//log end of game
+	std::string logLine = "End of game " + std::to_string(game);
+	logLine += ": " + result;
+	logLine += "\t" + playerStats.get().toString();
+	this->logger.addLog(Level::INFO, "Referee: " + logLine);
+}
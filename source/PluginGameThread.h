@@ -0,0 +1,63 @@
+#ifndef PLUGINGAMETHREAD_H
+#define PLUGINGAMETHREAD_H
+
+#include "ThreadedGame.h"
+#include "RefereePlugin.h"
+
+/*
+ * @brief Class describing a PluginGameThread object. The referee is a DLL running inside the tester, see RefereePluginApi.h,
+ *        so there is no referee process to spawn and every line goes through a single pipe.
+ */
+class PluginGameThread : public ThreadedGame {
+private:
+    const RefereePlugin& plugin;        //< The shared referee plugin.
+    std::string replyBuffer;            //< Holds a player's reply when its line breaks need fixing.
+
+    /*
+     * @brief Spawns this game's player processes.
+     *
+     * @return success true or false.
+     */
+    bool spawnPlayers();
+
+    /*
+     * @brief Plays one game against the plugin and records the result.
+     *
+     * @param state the plugin's game.
+     */
+    void playGame(RefereeGame* state);
+
+public:
+    /*
+     * @brief Constructs a PluginGameThread object.
+     *
+     * @param id The id.
+     * @param plugin The loaded referee plugin, shared by every thread.
+     * @param refereeCmd The path of the referee plugin, for the logs.
+     * @param playersCmd The vector of player command lines.
+     * @param count The shared count of games.
+     * @param playerStats The playerStats object.
+     * @param seeder the shared rng seeder object.
+     * @param journal the shared results journal.
+     * @param reaper the shared teardown thread.
+     * @param swap Are we swapping player positions?
+     * @param verbose The verbosity to use for the logs.
+     */
+    PluginGameThread(int id, const RefereePlugin& plugin, std::string refereeCmd, std::vector<std::string> playersCmd, Mutable<int>& count, Mutable<PlayerStats>& playerStats, Mutable<SeedGenerator>& seeder, ResultsJournal& journal, Reaper& reaper, int n, bool swap, Level verbose, std::string path, std::string file);
+
+    /*
+     * @brief Destructs the PluginGameThread object.
+     */
+    ~PluginGameThread();
+
+    /*
+     * @brief Starts the thread.
+     */
+    bool start();
+
+    /*
+     * @brief The run method from the Threadable base class we must overide.
+     */
+    void run() override;
+};
+#endif
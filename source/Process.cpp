@@ -1,235 +1,733 @@
-//Process.cpp
-#include "Process.h"
-
-Process::Process() : executable{ "" }, args{ "" }, id{ 0 }, use_window{ false }, running{ false } {
-    ZeroMemory(&startup_info, sizeof(STARTUPINFOW));
-}
-
-Process::Process(int id, const std::string_view& executable, const std::string_view& args, bool window) : id{ id }, executable{ executable }, args{ args }, use_window{ window }, running{ false } {
-    ZeroMemory(&startup_info, sizeof(STARTUPINFOW));
-}
-
-Process::Process(const Process& other) {
-    ZeroMemory(&startup_info, sizeof(STARTUPINFOW));
-    executable = other.executable;
-    args = other.args;
-    use_window = other.use_window;
-    id = other.id + (other.running ? 10000 : 0); //we will never open 10000 processes. if it is running, we need unique pipe names 
-    running = false; //remember to start() the new process, which will setup the pipes
-}
-
-
-Process::~Process()
-{
-    if (this->running) {
-        // Wait for the child process to terminate
-        WaitForSingleObject(process_info.hProcess, 1000);
-
-        // Get the exit code of the child process
-        DWORD exitCode;
-        GetExitCodeProcess(process_info.hProcess, &exitCode);
-
-        //if still active, terminate the process
-        if (exitCode == STILL_ACTIVE) {
-            TerminateProcess(process_info.hProcess, 0);
-        }
-        try {
-            if (hChildStd_IN_Rd != INVALID_HANDLE_VALUE) close(hChildStd_IN_Rd);
-            if (hChildStd_IN_Wr != INVALID_HANDLE_VALUE) close(hChildStd_IN_Wr);
-            if (hChildStd_OUT_Rd != INVALID_HANDLE_VALUE) close(hChildStd_OUT_Rd);
-            if (hChildStd_OUT_Wr != INVALID_HANDLE_VALUE) close(hChildStd_OUT_Wr);
-            if (hChildStd_ERR_Rd != INVALID_HANDLE_VALUE) close(hChildStd_ERR_Rd);
-            if (hChildStd_ERR_Wr != INVALID_HANDLE_VALUE) close(hChildStd_ERR_Wr);
-            if (process_info.hProcess != INVALID_HANDLE_VALUE) close(process_info.hProcess);
-            if (process_info.hThread != INVALID_HANDLE_VALUE) close(process_info.hThread);
-        }
-        catch (std::exception& e) {
-            std::cout << e.what() << std::endl;
-        }
-    }
-}
-
-void Process::close(HANDLE handle) {
-    __try {
-        if (CloseHandle(handle) == FALSE) {
-            throw GetLastError();
-        }
-    }
-
-    __except (EXCEPTION_EXECUTE_HANDLER) { throw std::exception("Warning: Handles not closed. Memory may leak."); }
-}
-
-bool Process::createPipes() {
-    SECURITY_ATTRIBUTES sa_attr;
-    sa_attr.nLength = sizeof(SECURITY_ATTRIBUTES);
-    sa_attr.bInheritHandle = TRUE;
-    sa_attr.lpSecurityDescriptor = NULL;
-
-    // Create the pipes
-    if (!CreatePipe(&hChildStd_OUT_Rd, &hChildStd_OUT_Wr, &sa_attr, 0)
-        || !CreatePipe(&hChildStd_IN_Rd, &hChildStd_IN_Wr, &sa_attr, 0)
-        || !CreatePipe(&hChildStd_ERR_Rd, &hChildStd_ERR_Wr, &sa_attr, 0)) {
-        std::cout << "Error Creating Pipes, Code: " << GetLastError() << std::endl;
-        return false;
-    }
-
-    if (hChildStd_OUT_Rd == INVALID_HANDLE_VALUE || hChildStd_OUT_Wr == INVALID_HANDLE_VALUE
-        || hChildStd_IN_Rd == INVALID_HANDLE_VALUE || hChildStd_IN_Wr == INVALID_HANDLE_VALUE
-        || hChildStd_ERR_Rd == INVALID_HANDLE_VALUE || hChildStd_ERR_Wr == INVALID_HANDLE_VALUE)
-    {
-        std::cout << "Error Creating Handles, Code: " << GetLastError() << std::endl;
-        return false;
-    }
-
-    return true;
-}
-
-HANDLE& Process::getHandle(TYPE type) {
-    switch (type) {
-    case INPUT:
-        return hChildStd_OUT_Wr;
-    case OUTPUT:
-        return hChildStd_OUT_Rd;
-    case ERR:
-        return hChildStd_ERR_Rd;
-    default:
-        std::cout << "Fatal: improper values for getPipeEnd parameters." << std::endl;
-        exit(1);
-    }
-}
-
-bool Process::isPipeEmpty(HANDLE handle)
-{
-    DWORD bytesAvail = 0;
-
-    // Check if there is data available to read from the pipe
-    if (!PeekNamedPipe(handle, NULL, 0, NULL, &bytesAvail, NULL)) {
-        std::cerr << "PeekNamedPipe failed (" << GetLastError() << ").\n";
-        return true;
-    }
-
-    return (bytesAvail == 0);
-}
-
-std::string Process::readPipe(TYPE type) {
-    //we cannot read from the child's IN, you silly user!
-    if (type == INPUT) {
-        return "";
-    }
-
-    HANDLE pipe = getHandle(type);
-    if (isPipeEmpty(pipe))
-    {
-        return "";
-    }
-
-    char buffer[BUFSIZE + 1]{};
-    DWORD bytesRead;
-    if (!ReadFile(pipe, buffer, BUFSIZE, &bytesRead, NULL))
-    {
-        std::cerr << "Failed to read from pipe. Error code: " << GetLastError() << std::endl;
-        return "";
-    }
-
-    //0 terminate and convert to a string
-    buffer[bytesRead] = '\0';
-    std::vector<char> v_data(buffer, buffer + bytesRead);
-    return std::string(v_data.data(), v_data.size());
-}
-
-bool Process::writePipe(const std::string& data) {
-    DWORD dwWritten;
-    DWORD length = (DWORD)data.length() + 1; //no +1 creates problems
-    return WriteFile(hChildStd_IN_Wr, data.c_str(), length, &dwWritten, NULL);
-}
-
-bool Process::start() {
-    //convert the string_view executable to a string
-    std::string name = "";
-    name += this->executable;
-
-    //convert the string executable name to a Wide Char String  
-    std::wstring name_l(name.c_str(), name.c_str() + name.size());
-
-    wchar_t current_dir[FILENAME_MAX];
-    if (_wgetcwd(current_dir, FILENAME_MAX) == nullptr) {
-        std::cerr << "Error getting current working directory. Code:" << GetLastError() << std::endl;
-        exit(0);
-    }
-
-    wchar_t path_exe[MAX_PATH];
-    GetModuleFileName(NULL, path_exe, MAX_PATH);
-    std::wstring path = path_exe;
-    path = std::filesystem::path(path).parent_path();
-    path += L"\\";
-    path += name_l;
-
-    int found = _waccess_s(path.c_str(), 0);
-    if (found != 0)
-    {
-        std::cerr << "Error: Executable file not found: " << name << std::endl;
-        exit(0);
-    }
-
-    std::wstring commandLine = path;
-    if (args != "") {
-        std::string args_s = "";
-        args_s += args;
-        std::wstring args_l(args_s.c_str(), args_s.c_str() + args_s.size());
-        commandLine += L" ";
-        commandLine += args_l;
-    }
-
-    SECURITY_ATTRIBUTES saAttr;
-    saAttr.nLength = sizeof(SECURITY_ATTRIBUTES);
-    saAttr.bInheritHandle = TRUE;
-    saAttr.lpSecurityDescriptor = NULL;
-
-    if (!createPipes())
-    {
-        std::cerr << "Error: Failed to create pipes for the child process" << std::endl;
-        return false;
-    }
-
-    // Make sure the handles' inheritance is set correctly
-    if (!SetHandleInformation(hChildStd_OUT_Rd, HANDLE_FLAG_INHERIT, 0)
-        && !SetHandleInformation(hChildStd_ERR_Rd, HANDLE_FLAG_INHERIT, 0)
-        && !SetHandleInformation(hChildStd_IN_Wr, HANDLE_FLAG_INHERIT, 0))
-    {
-        std::cerr << "Error: Failed to set handle information for the child process" << std::endl;
-        return false;
-    }
-
-    // Set up the startup info struct    
-    startup_info.cb = sizeof(STARTUPINFOW);
-    startup_info.hStdOutput = hChildStd_OUT_Wr;
-    startup_info.hStdError = hChildStd_ERR_Wr;
-    startup_info.hStdInput = hChildStd_IN_Rd;
-    startup_info.dwFlags |= STARTF_USESTDHANDLES;
-    startup_info.dwFlags |= STARTF_USESHOWWINDOW;
-    startup_info.wShowWindow = use_window ? SW_SHOWDEFAULT: SW_HIDE;     
-    
-
-    // Create the child process
-    if (!CreateProcess(commandLine.data(), NULL, NULL, NULL, TRUE, 0, NULL, NULL, &startup_info, &process_info))
-    {
-        std::cerr << "Error: Failed to create the child process" << std::endl;
-        return false;
-    }
-
-    Sleep(25); //let it start
-
-    return isRunning();
-}
-
-bool Process::isRunning() {
-    // Get the exit code of the child process
-    DWORD exitCode;
-    GetExitCodeProcess(process_info.hProcess, &exitCode);
-
-    //set running
-    running = (exitCode == STILL_ACTIVE);
-
-    //return
-    return running;
+//Process.cpp
+#include "Process.h"
+#include "ExePath.h"
+
+Process::Process() : executable{ "" }, args{ "" }, id{ 0 }, use_window{ false }, running{ false } {
+    ZeroMemory(&startup_info, sizeof(STARTUPINFOW));
+    ZeroMemory(&process_info, sizeof(PROCESS_INFORMATION));
+    ZeroMemory(&readOverlapped, sizeof(OVERLAPPED));
+}
+
+Process::Process(int id, const std::string_view& executable, const std::string_view& args, bool window) : id{ id }, executable{ executable }, args{ args }, use_window{ window }, running{ false } {
+    ZeroMemory(&startup_info, sizeof(STARTUPINFOW));
+    ZeroMemory(&process_info, sizeof(PROCESS_INFORMATION));
+    ZeroMemory(&readOverlapped, sizeof(OVERLAPPED));
+}
+
+Process::Process(const Process& other) {
+    ZeroMemory(&startup_info, sizeof(STARTUPINFOW));
+    ZeroMemory(&process_info, sizeof(PROCESS_INFORMATION));
+    ZeroMemory(&readOverlapped, sizeof(OVERLAPPED));
+    sharedMemory = other.sharedMemory;
+    executable = other.executable;
+    args = other.args;
+    use_window = other.use_window;
+    id = other.id + (other.running ? 10000 : 0); //we will never open 10000 processes. if it is running, we need unique pipe names 
+    running = false; //remember to start() the new process, which will setup the pipes
+}
+
+
+Process::~Process()
+{
+    //released processes are torn down by the Reaper, anything left here is killed right away instead of waited on
+    if (process_info.hProcess != NULL) {
+        DWORD exitCode;
+        GetExitCodeProcess(process_info.hProcess, &exitCode);
+        if (exitCode == STILL_ACTIVE) {
+            TerminateProcess(process_info.hProcess, 0);
+        }
+    }
+    cancelRead();
+    try {
+        closeIfOpen(readEvent);
+        closeIfOpen(hChildStd_IN_Rd);
+        closeIfOpen(hChildStd_IN_Wr);
+        closeIfOpen(hChildStd_OUT_Rd);
+        closeIfOpen(hChildStd_OUT_Wr);
+        closeIfOpen(hChildStd_ERR_Rd);
+        closeIfOpen(hChildStd_ERR_Wr);
+        closeIfOpen(process_info.hProcess);
+        closeIfOpen(process_info.hThread);
+        closeIfOpen(jobPort);
+        closeIfOpen(job);
+    }
+    catch (std::exception& e) {
+        std::cout << e.what() << std::endl;
+    }
+}
+
+ProcessHandles Process::release(const std::string& name) {
+    ProcessHandles handles;
+    handles.name = name;
+
+    //end of input is the polite way to ask a bot or referee to exit
+    cancelRead();
+    if (shm != nullptr) {
+        shm->close();
+        shm.reset();
+    }
+    try {
+        closeIfOpen(hChildStd_IN_Wr);
+        closeIfOpen(readEvent);
+    }
+    catch (std::exception& e) {
+        std::cout << e.what() << std::endl;
+    }
+
+    handles.process = process_info.hProcess;
+    handles.thread = process_info.hThread;
+    handles.job = job;
+    handles.jobPort = jobPort;
+    for (HANDLE* pipe : { &hChildStd_IN_Rd, &hChildStd_OUT_Rd, &hChildStd_OUT_Wr, &hChildStd_ERR_Rd, &hChildStd_ERR_Wr }) {
+        if (*pipe != NULL && *pipe != INVALID_HANDLE_VALUE) handles.pipes.push_back(*pipe);
+        *pipe = NULL;
+    }
+
+    ZeroMemory(&process_info, sizeof(PROCESS_INFORMATION));
+    ZeroMemory(&readOverlapped, sizeof(OVERLAPPED));
+    job = NULL;
+    jobPort = NULL;
+    running = false;
+
+    return handles;
+}
+
+void Process::closeIfOpen(HANDLE& handle) {
+    if (handle != NULL && handle != INVALID_HANDLE_VALUE) {
+        close(handle);
+    }
+    handle = NULL;
+}
+
+void Process::close(HANDLE handle) {
+    __try {
+        if (CloseHandle(handle) == FALSE) {
+            throw GetLastError();
+        }
+    }
+
+    __except (EXCEPTION_EXECUTE_HANDLER) { throw std::exception("Warning: Handles not closed. Memory may leak."); }
+}
+
+bool Process::createPipes() {
+    SECURITY_ATTRIBUTES sa_attr;
+    sa_attr.nLength = sizeof(SECURITY_ATTRIBUTES);
+    sa_attr.bInheritHandle = TRUE;
+    sa_attr.lpSecurityDescriptor = NULL;
+
+    // Anonymous pipes cannot do overlapped io, so stdout is a uniquely named pipe
+    static std::atomic<unsigned long> pipeCount{ 0 };
+    std::wstring pipeName = L"\\\\.\\pipe\\new-cg-brutal-tester-" + std::to_wstring(GetCurrentProcessId()) + L"-" + std::to_wstring(pipeCount++);
+    hChildStd_OUT_Rd = CreateNamedPipe(pipeName.c_str(), PIPE_ACCESS_INBOUND | FILE_FLAG_OVERLAPPED | FILE_FLAG_FIRST_PIPE_INSTANCE,
+        PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT, 1, BUFSIZE, BUFSIZE, 0, NULL);
+    if (hChildStd_OUT_Rd != INVALID_HANDLE_VALUE) {
+        hChildStd_OUT_Wr = CreateFile(pipeName.c_str(), GENERIC_WRITE, 0, &sa_attr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    }
+    readEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+
+    // Create the pipes
+    if (hChildStd_OUT_Rd == INVALID_HANDLE_VALUE || readEvent == NULL
+        || !CreatePipe(&hChildStd_IN_Rd, &hChildStd_IN_Wr, &sa_attr, 0)
+        || !CreatePipe(&hChildStd_ERR_Rd, &hChildStd_ERR_Wr, &sa_attr, 0)) {
+        std::cout << "Error Creating Pipes, Code: " << GetLastError() << std::endl;
+        return false;
+    }
+
+    if (hChildStd_OUT_Rd == INVALID_HANDLE_VALUE || hChildStd_OUT_Wr == INVALID_HANDLE_VALUE
+        || hChildStd_IN_Rd == INVALID_HANDLE_VALUE || hChildStd_IN_Wr == INVALID_HANDLE_VALUE
+        || hChildStd_ERR_Rd == INVALID_HANDLE_VALUE || hChildStd_ERR_Wr == INVALID_HANDLE_VALUE)
+    {
+        std::cout << "Error Creating Handles, Code: " << GetLastError() << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+HANDLE& Process::getHandle(TYPE type) {
+    switch (type) {
+    case INPUT:
+        return hChildStd_OUT_Wr;
+    case OUTPUT:
+        return hChildStd_OUT_Rd;
+    case ERR:
+        return hChildStd_ERR_Rd;
+    default:
+        std::cout << "Fatal: improper values for getPipeEnd parameters." << std::endl;
+        exit(1);
+    }
+}
+
+bool Process::isPipeEmpty(HANDLE handle)
+{
+    DWORD bytesAvail = 0;
+
+    // Check if there is data available to read from the pipe
+    if (!PeekNamedPipe(handle, NULL, 0, NULL, &bytesAvail, NULL)) {
+        std::cerr << "PeekNamedPipe failed (" << GetLastError() << ").\n";
+        return true;
+    }
+
+    return (bytesAvail == 0);
+}
+
+std::string Process::readPipe(TYPE type) {
+    //we cannot read from the child's IN, you silly user!
+    if (type == INPUT) {
+        return "";
+    }
+
+    //stdout goes through the overlapped reader, hand out whatever it has without waiting
+    if (type == OUTPUT) {
+        if (!readPending && outStart == outBuffer.size() && !isPipeEmpty(hChildStd_OUT_Rd)) {
+            //data is waiting, so this read completes right away
+            if (beginRead()) completeRead(true);
+        }
+        else if (readPending) {
+            completeRead(false);
+        }
+        std::string data = outBuffer.substr(outStart);
+        outBuffer.clear();
+        outStart = 0;
+        return data;
+    }
+
+    HANDLE pipe = getHandle(type);
+    if (isPipeEmpty(pipe))
+    {
+        return "";
+    }
+
+    char buffer[BUFSIZE + 1]{};
+    DWORD bytesRead;
+    if (!ReadFile(pipe, buffer, BUFSIZE, &bytesRead, NULL))
+    {
+        std::cerr << "Failed to read from pipe. Error code: " << GetLastError() << std::endl;
+        return "";
+    }
+
+    //0 terminate and convert to a string
+    buffer[bytesRead] = '\0';
+    std::vector<char> v_data(buffer, buffer + bytesRead);
+    return std::string(v_data.data(), v_data.size());
+}
+
+bool Process::beginRead() {
+    if (outputClosed) {
+        return false;
+    }
+
+    //the consumed lines are only dropped here, so views from readLine() live until the next read
+    if (outStart > 0) {
+        outBuffer.erase(0, outStart);
+        outStart = 0;
+    }
+
+    //a bot on the shared memory channel has nothing on its stdout, its output is in the ring
+    if (usesSharedMemory()) {
+        if (shm->read(outBuffer) == 0 && WaitForSingleObject(process_info.hProcess, 0) == WAIT_OBJECT_0) {
+            outputClosed = shm->read(outBuffer) == 0;
+        }
+        return !outputClosed;
+    }
+
+    if (readPending) {
+        return true;
+    }
+
+    ZeroMemory(&readOverlapped, sizeof(OVERLAPPED));
+    readOverlapped.hEvent = readEvent;
+    if (!ReadFile(hChildStd_OUT_Rd, readChunk, BUFSIZE_READ, NULL, &readOverlapped) && GetLastError() != ERROR_IO_PENDING) {
+        //broken pipe, the child closed its stdout
+        outputClosed = true;
+        return false;
+    }
+
+    //pending or already complete, either way the event is set once it is done
+    readPending = true;
+    return true;
+}
+
+bool Process::completeRead(bool wait) {
+    if (usesSharedMemory()) {
+        if (wait) WaitForSingleObject(shm->getOutEvent(), TIMEOUT);
+        return shm->read(outBuffer) > 0;
+    }
+    if (!readPending) {
+        return false;
+    }
+
+    DWORD bytesRead = 0;
+    if (!GetOverlappedResult(hChildStd_OUT_Rd, &readOverlapped, &bytesRead, wait ? TRUE : FALSE)) {
+        if (GetLastError() == ERROR_IO_INCOMPLETE) {
+            return false;
+        }
+        readPending = false;
+        outputClosed = true;
+        return false;
+    }
+
+    readPending = false;
+    outBuffer.append(readChunk, bytesRead);
+    return bytesRead > 0;
+}
+
+void Process::cancelRead() {
+    if (!readPending) {
+        return;
+    }
+    DWORD bytesRead = 0;
+    CancelIoEx(hChildStd_OUT_Rd, &readOverlapped);
+    GetOverlappedResult(hChildStd_OUT_Rd, &readOverlapped, &bytesRead, TRUE);
+    readPending = false;
+}
+
+void Process::addWaitHandles(std::vector<HANDLE>& events) {
+    if (readPending) {
+        events.push_back(readEvent);
+    }
+    //also before the bot opened the channel, its first answer may already come through it
+    if (shm != nullptr) {
+        events.push_back(shm->getOutEvent());
+    }
+}
+
+int Process::countLines() const {
+    int lines = 0;
+    for (size_t i = outStart; i < outBuffer.size(); ++i) {
+        if (outBuffer[i] == '\n') lines++;
+    }
+    return lines;
+}
+
+bool Process::readLine(std::string_view& line, DWORD timeout) {
+    if (countLines() == 0 && !waitForLines(*this, 1, {}, timeout)) {
+        //a last line without a line break still counts once the child closed its output
+        if (!outputClosed || outStart == outBuffer.size()) {
+            return false;
+        }
+        outBuffer += '\n';
+    }
+
+    size_t end = outBuffer.find('\n', outStart);
+    line = std::string_view(outBuffer).substr(outStart, end - outStart);
+    if (line.ends_with('\r')) line.remove_suffix(1);
+    outStart = end + 1;
+    return true;
+}
+
+bool Process::readLine(std::string& line, DWORD timeout) {
+    std::string_view view;
+    if (!readLine(view, timeout)) {
+        return false;
+    }
+    line = view;
+    return true;
+}
+
+bool Process::waitForLines(Process& target, int lines, const std::vector<Process*>& others, DWORD timeout) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+
+    std::vector<Process*> processes = { &target };
+    for (Process* other : others) {
+        if (other != &target) processes.push_back(other);
+    }
+
+    std::vector<HANDLE> events;
+    std::vector<Process*> reading;
+    while (target.countLines() < lines) {
+        //a read in flight on every open output, then sleep until one of them has data
+        events.clear();
+        reading.clear();
+        for (Process* process : processes) {
+            if (process->beginRead()) {
+                process->addWaitHandles(events);
+                reading.push_back(process);
+            }
+        }
+        if (target.outputClosed) {
+            return false;
+        }
+
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+        if (remaining <= 0) {
+            return false;
+        }
+        DWORD result = WaitForMultipleObjects((DWORD)events.size(), events.data(), FALSE, (DWORD)remaining);
+        if (result == WAIT_TIMEOUT || result == WAIT_FAILED) {
+            return false;
+        }
+
+        //collect every read that is done, not only the first one signaled
+        for (Process* process : reading) {
+            process->completeRead(false);
+        }
+    }
+
+    return true;
+}
+
+bool Process::readAvailable(std::string_view& chunk, DWORD timeout) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+
+    while (outStart == outBuffer.size()) {
+        if (!beginRead()) {
+            return false;
+        }
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+        if (remaining <= 0 || WaitForSingleObject(readEvent, (DWORD)remaining) != WAIT_OBJECT_0) {
+            return false;
+        }
+        completeRead(false);
+    }
+
+    chunk = std::string_view(outBuffer).substr(outStart);
+    outStart = outBuffer.size();
+    return true;
+}
+
+bool Process::readBlock(std::string_view& block, std::string_view& command, DWORD timeout) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+
+    //offset from outStart of the first line not scanned yet, reads only ever move the unconsumed output to the front
+    size_t scanned = 0;
+    while (true) {
+        size_t lineStart = outStart + scanned;
+        size_t end;
+        while ((end = outBuffer.find('\n', lineStart)) != std::string::npos) {
+            if (outBuffer.compare(lineStart, 3, "###") == 0) {
+                std::string_view output(outBuffer);
+                block = output.substr(outStart, lineStart - outStart);
+                command = output.substr(lineStart, end - lineStart);
+                if (command.ends_with('\r')) command.remove_suffix(1);
+                outStart = end + 1;
+                return true;
+            }
+            lineStart = end + 1;
+        }
+        scanned = lineStart - outStart;
+
+        //no command yet, wait for more output
+        if (!beginRead()) {
+            return false;
+        }
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+        if (remaining <= 0 || WaitForSingleObject(readEvent, (DWORD)remaining) != WAIT_OBJECT_0) {
+            return false;
+        }
+        completeRead(false);
+    }
+}
+
+int Process::takeLines(int count, std::string_view& block) {
+    int taken = 0;
+    size_t end = outStart;
+    while (taken < count) {
+        size_t next = outBuffer.find('\n', end);
+        if (next == std::string::npos) break;
+        end = next + 1;
+        taken++;
+    }
+
+    block = std::string_view(outBuffer).substr(outStart, end - outStart);
+    outStart = end;
+    return taken;
+}
+
+bool Process::writePipe(const std::string& data) {
+    return write(data);
+}
+
+bool Process::write(std::string_view data) {
+    //once the bot opened the channel everything goes through the ring, before that it is counted and sent on stdin
+    if (shm != nullptr && !shm->claimPipe(data.size())) {
+        return shm->write(data);
+    }
+
+    //a blocking pipe write only returns once everything is written, loop anyway in case it is cut short
+    while (!data.empty()) {
+        DWORD dwWritten = 0;
+        if (!WriteFile(hChildStd_IN_Wr, data.data(), (DWORD)data.length(), &dwWritten, NULL)) {
+            return false;
+        }
+        data.remove_prefix(dwWritten);
+    }
+    return true;
+}
+
+bool Process::writeLine(std::string_view line) {
+    writeBuffer.assign(line);
+    writeBuffer += '\n';
+    return write(writeBuffer);
+}
+
+bool Process::writeLines(std::string_view block) {
+    return write(plainLines(block, writeBuffer));
+}
+
+std::string_view Process::plainLines(std::string_view block, std::string& buffer) {
+    if (block.find('\r') == std::string_view::npos) {
+        return block;
+    }
+
+    //the child wrote windows line breaks, the reader gets plain ones like on CodinGame
+    buffer.clear();
+    size_t start = 0;
+    size_t end;
+    while ((end = block.find('\n', start)) != std::string_view::npos) {
+        std::string_view line = block.substr(start, end - start);
+        if (line.ends_with('\r')) line.remove_suffix(1);
+        buffer += line;
+        buffer += '\n';
+        start = end + 1;
+    }
+    return buffer;
+}
+
+bool Process::start(const ResourceProfile& profile, HANDLE group) {
+    //convert the string_view executable to a string
+    std::string name = "";
+    name += this->executable;
+
+    //convert the string executable name to a Wide Char String  
+    std::wstring name_l(name.c_str(), name.c_str() + name.size());
+
+    wchar_t current_dir[FILENAME_MAX];
+    if (_wgetcwd(current_dir, FILENAME_MAX) == nullptr) {
+        std::cerr << "Error getting current working directory. Code:" << GetLastError() << std::endl;
+        exit(0);
+    }
+
+    std::wstring path = ExePath::directory();
+    path += L"\\";
+    path += name_l;
+
+    int found = _waccess_s(path.c_str(), 0);
+    if (found != 0)
+    {
+        std::cerr << "Error: Executable file not found: " << name << std::endl;
+        exit(0);
+    }
+
+    std::wstring commandLine = path;
+    if (args != "") {
+        std::string args_s = "";
+        args_s += args;
+        std::wstring args_l(args_s.c_str(), args_s.c_str() + args_s.size());
+        commandLine += L" ";
+        commandLine += args_l;
+    }
+
+    SECURITY_ATTRIBUTES saAttr;
+    saAttr.nLength = sizeof(SECURITY_ATTRIBUTES);
+    saAttr.bInheritHandle = TRUE;
+    saAttr.lpSecurityDescriptor = NULL;
+
+    if (!createPipes())
+    {
+        std::cerr << "Error: Failed to create pipes for the child process" << std::endl;
+        return false;
+    }
+
+    // Make sure the handles' inheritance is set correctly
+    if (!SetHandleInformation(hChildStd_OUT_Rd, HANDLE_FLAG_INHERIT, 0)
+        && !SetHandleInformation(hChildStd_ERR_Rd, HANDLE_FLAG_INHERIT, 0)
+        && !SetHandleInformation(hChildStd_IN_Wr, HANDLE_FLAG_INHERIT, 0))
+    {
+        std::cerr << "Error: Failed to set handle information for the child process" << std::endl;
+        return false;
+    }
+
+    // Set up the startup info struct    
+    startup_info.cb = sizeof(STARTUPINFOW);
+    startup_info.hStdOutput = hChildStd_OUT_Wr;
+    startup_info.hStdError = hChildStd_ERR_Wr;
+    startup_info.hStdInput = hChildStd_IN_Rd;
+    startup_info.dwFlags |= STARTF_USESTDHANDLES;
+    startup_info.dwFlags |= STARTF_USESHOWWINDOW;
+    startup_info.wShowWindow = use_window ? SW_SHOWDEFAULT: SW_HIDE;     
+    
+
+    // Offer the shared memory channel, if asked to
+    std::wstring environment;
+    if (sharedMemory && !createChannel(environment)) {
+        std::cerr << "Error: Failed to create the shared memory channel for the child process. Code: " << GetLastError() << std::endl;
+        return false;
+    }
+
+    // Create the child process, suspended if it has to be put in a job before it runs
+    bool suspended = group != NULL || !profile.isEmpty();
+    DWORD flags = (suspended ? CREATE_SUSPENDED : 0) | (shm != nullptr ? CREATE_UNICODE_ENVIRONMENT : 0);
+    if (!CreateProcess(commandLine.data(), NULL, NULL, NULL, TRUE, flags, shm != nullptr ? environment.data() : NULL, NULL, &startup_info, &process_info))
+    {
+        std::cerr << "Error: Failed to create the child process" << std::endl;
+        return false;
+    }
+
+    // The game's job first, the limits job then nests inside it
+    if (group != NULL && !AssignProcessToJobObject(group, process_info.hProcess)) {
+        std::cerr << "Error: Failed to add the child process to its game's group. Code: " << GetLastError() << std::endl;
+        TerminateProcess(process_info.hProcess, 1);
+        return false;
+    }
+
+    if (!profile.isEmpty() && !applyProfile(profile)) {
+        std::cerr << "Error: Failed to apply the resource limits to the child process. Code: " << GetLastError() << std::endl;
+        TerminateProcess(process_info.hProcess, 1);
+        return false;
+    }
+
+    if (suspended) {
+        ResumeThread(process_info.hThread);
+    }
+
+    Sleep(25); //let it start
+
+    return isRunning();
+}
+
+bool Process::createChannel(std::wstring& environment) {
+    static std::atomic<unsigned long> channelCount{ 0 };
+    std::string name = "Local\\new-cg-brutal-tester-shm-" + std::to_string(GetCurrentProcessId()) + "-" + std::to_string(channelCount++);
+    shm = std::make_unique<ShmTransport>();
+    if (!shm->create(name)) {
+        shm.reset();
+        return false;
+    }
+
+    //our own environment, plus the variable advertising the channel
+    LPWCH block = GetEnvironmentStringsW();
+    if (block == NULL) {
+        shm.reset();
+        return false;
+    }
+    const wchar_t* end = block;
+    while (*end != L'\0') end += wcslen(end) + 1;
+    environment.assign(block, end - block);
+    FreeEnvironmentStringsW(block);
+
+    std::string variable = std::string(shm::ENV_NAME) + "=" + name;
+    environment.append(variable.begin(), variable.end());
+    environment.push_back(L'\0');
+    environment.push_back(L'\0');
+    return true;
+}
+
+bool Process::applyProfile(const ResourceProfile& profile) {
+    job = CreateJobObject(NULL, NULL);
+    if (job == NULL) {
+        return false;
+    }
+
+    //the limits apply to every process in the job, so a bot cannot dodge them by spawning children
+    JOBOBJECT_EXTENDED_LIMIT_INFORMATION limits;
+    ZeroMemory(&limits, sizeof(JOBOBJECT_EXTENDED_LIMIT_INFORMATION));
+    DWORD flags = JOB_OBJECT_LIMIT_KILL_ON_JOB_CLOSE;
+    if (profile.memoryLimit > 0) {
+        //one limit for the job, the children's memory adds up to the player's
+        flags |= JOB_OBJECT_LIMIT_JOB_MEMORY;
+        limits.JobMemoryLimit = (SIZE_T)profile.memoryLimit;
+    }
+    if (profile.cpuTimeLimit > 0) {
+        flags |= JOB_OBJECT_LIMIT_PROCESS_TIME;
+        limits.BasicLimitInformation.PerProcessUserTimeLimit.QuadPart = (LONGLONG)profile.cpuTimeLimit * 10000; //ms to 100 ns
+    }
+    if (profile.processLimit > 0) {
+        flags |= JOB_OBJECT_LIMIT_ACTIVE_PROCESS;
+        limits.BasicLimitInformation.ActiveProcessLimit = profile.processLimit;
+    }
+    limits.BasicLimitInformation.LimitFlags = flags;
+    if (!SetInformationJobObject(job, JobObjectExtendedLimitInformation, &limits, sizeof(JOBOBJECT_EXTENDED_LIMIT_INFORMATION))) {
+        return false;
+    }
+
+    //the job reports broken limits to a completion port, checkLimits() drains it
+    jobPort = CreateIoCompletionPort(INVALID_HANDLE_VALUE, NULL, 0, 1);
+    if (jobPort == NULL) {
+        return false;
+    }
+    JOBOBJECT_ASSOCIATE_COMPLETION_PORT port;
+    port.CompletionKey = job;
+    port.CompletionPort = jobPort;
+    if (!SetInformationJobObject(job, JobObjectAssociateCompletionPortInformation, &port, sizeof(JOBOBJECT_ASSOCIATE_COMPLETION_PORT))) {
+        return false;
+    }
+
+    return AssignProcessToJobObject(job, process_info.hProcess);
+}
+
+Violation Process::checkLimits() {
+    if (jobPort == NULL) {
+        return violation;
+    }
+
+    DWORD message;
+    ULONG_PTR key;
+    LPOVERLAPPED overlapped;
+    while (GetQueuedCompletionStatus(jobPort, &message, &key, &overlapped, 0)) {
+        //keep the first limit broken, the others usually follow from it
+        if (violation != NO_VIOLATION) continue;
+
+        switch (message) {
+        case JOB_OBJECT_MSG_PROCESS_MEMORY_LIMIT:
+        case JOB_OBJECT_MSG_JOB_MEMORY_LIMIT:
+            violation = MEMORY_LIMIT;
+            break;
+        case JOB_OBJECT_MSG_END_OF_PROCESS_TIME:
+            violation = CPU_LIMIT;
+            break;
+        case JOB_OBJECT_MSG_ACTIVE_PROCESS_LIMIT:
+            violation = PROCESS_LIMIT;
+            break;
+        }
+    }
+
+    return violation;
+}
+
+bool Process::sampleUsage() {
+    if (process_info.hProcess == NULL) {
+        return false;
+    }
+
+    //memory counters, the peaks are tracked by the kernel so one sample at the end of a game is enough
+    PROCESS_MEMORY_COUNTERS_EX counters;
+    ZeroMemory(&counters, sizeof(PROCESS_MEMORY_COUNTERS_EX));
+    if (!GetProcessMemoryInfo(process_info.hProcess, (PROCESS_MEMORY_COUNTERS*)&counters, sizeof(PROCESS_MEMORY_COUNTERS_EX))) {
+        return false;
+    }
+
+    //cpu times, in 100 ns units
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    if (!GetProcessTimes(process_info.hProcess, &creationTime, &exitTime, &kernelTime, &userTime)) {
+        return false;
+    }
+
+    ULARGE_INTEGER user, kernel;
+    user.LowPart = userTime.dwLowDateTime;
+    user.HighPart = userTime.dwHighDateTime;
+    kernel.LowPart = kernelTime.dwLowDateTime;
+    kernel.HighPart = kernelTime.dwHighDateTime;
+
+    ResourceUsage sample;
+    sample.peakWorkingSet = counters.PeakWorkingSetSize;
+    sample.peakCommit = counters.PeakPagefileUsage;
+    sample.pageFaults = counters.PageFaultCount;
+    sample.userTime = user.QuadPart / 10;
+    sample.kernelTime = kernel.QuadPart / 10;
+    usage.update(sample);
+
+    return true;
+}
+
+bool Process::isRunning() {
+    // Get the exit code of the child process
+    DWORD exitCode;
+    GetExitCodeProcess(process_info.hProcess, &exitCode);
+
+    //set running
+    running = (exitCode == STILL_ACTIVE);
+
+    //return
+    return running;
 }
\ No newline at end of file
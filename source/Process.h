@@ -1,163 +1,430 @@
-//Process.h
-#ifndef PROCESS_H
-#define PROCESS_H
-
-#include <string>
-#include <string_view>
-#include <vector>
-#include <iostream>
-#include <fstream>
-#include <filesystem>
-#include <io.h>
-#include <windows.h>
-
-
-/*
- * @brief Class describing a child process and it's pipes for reading and writing data to and from that child process.
- */
-class Process
-{
-protected:
-    std::string_view executable;        //< the executable filename
-    std::string_view args;              //< the command line arguments for the executable
-
-    int id;                             //< the id of the process
-
-    bool use_window;                    //< does the child process use a window?
-
-    bool running;                       //< is the process running?
-
-    //The Pipe ends
-    HANDLE hChildStd_IN_Rd = NULL;
-    HANDLE hChildStd_IN_Wr = NULL;
-    HANDLE hChildStd_OUT_Rd = NULL;
-    HANDLE hChildStd_OUT_Wr = NULL;
-    HANDLE hChildStd_ERR_Rd = NULL;
-    HANDLE hChildStd_ERR_Wr = NULL;
-
-    PROCESS_INFORMATION process_info;
-    STARTUPINFOW startup_info;
-public:
-    enum TYPE { INPUT, OUTPUT, ERR };
-    const static int BUFSIZE = 4096;    //< buffersize
-
-    /*
-     * @brief Constructs a null Process object.
-     */
-    Process();
-
-
-    /*
-     * @brief Copy Constructs a Process object.
-     */
-    Process(const Process& other);
-
-    /*
-     * @brief Constructs a Process object.
-     *
-     * @param executable The file to run. Required.
-     * @param args Any commandline arguments for that executable. Required.
-     * @param width the width of the child window. Default 0.
-     * @param height the height of the child window. Default 0.
-     * @param useWindow bool true or false. Default false.
-     */
-    Process(int id, const std::string_view& executable, const std::string_view& args = "", bool useWindow = false);
-
-    /*
-     * @brief Destructs the Process object.
-     */
-    ~Process();
-
-    /*
-     * @brief Gets the filename of the executable this child process is running.
-     *
-     * @return The filename.
-     */
-    std::string_view& getExe() { return this->executable; }
-
-    /*
-     * @brief Gets the command line arguments used for the executable this child process is running.
-     *
-     * @return The arguments.
-     */
-    std::string_view& getArgs() { return this->args; }
-
-    /*
-     * @brief Gets a Handle.
-     *
-     * @param type INPUT, OUTPUT, Or ERRor?
-     *
-     * @return The end of the pipe handle.
-     */
-    HANDLE& getHandle(TYPE type);
-
-
-    /*
-     * @brief Checks if pipe is empty.
-     *
-     * @param the handle to the pipe.
-     *
-     * @return true or false.
-     */
-    bool isPipeEmpty(HANDLE handle);
-
-    /*
-     * @brief Reads from a pipe.
-     *
-     * @param the pipe.
-     *
-     * @return the string read from the pipe.
-     */
-    std::string readPipe(TYPE type);
-
-    /*
-     * @brief Writes to a pipe.
-     *
-     * @param the string to write to the pipe.\
-     * @return sucess
-     */
-    bool writePipe(const std::string& data);
-
-    /*
-     * @brief Starts the child process.
-     */
-    bool start();
-
-    /*
-     * @brief Overload an operator.
-     */
-    Process& operator=(const Process& other)
-    {
-        ZeroMemory(&startup_info, sizeof(STARTUPINFOW));
-        executable = other.executable;
-        args = other.args;
-        use_window = other.use_window;
-        id = other.id + (other.running ? 10000 : 0); //we will never open 10000 processes. if it is running, we need unique pipe names 
-        running = false; //remember to start() the new process, which will setup the pipes
-
-        return *this;
-    }
-
-    /*
-     * @brief checks if process is running.
-     *
-     * @return is running true or false.
-     */
-    bool isRunning();
-
-private:
-    /*
-     * @brief Checks closes a Handle.
-     *
-     * @param the handle to the pipe.
-     */
-    void close(HANDLE handle);
-
-    /*
-     * @brief Creates the pipes.
-     *
-     * @return success true or false.
-     */
-    bool createPipes();
-};
-#endif
+//Process.h
+#ifndef PROCESS_H
+#define PROCESS_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <io.h>
+#include <windows.h>
+#include <psapi.h>
+#include "ResourceUsage.h"
+#include "ResourceProfile.h"
+#include "ShmTransport.h"
+
+
+/*
+ * @brief Struct holding the handles of a child process handed over for teardown, see Process::release().
+ */
+struct ProcessHandles {
+    std::string name;                   //< name of the process in the logs and journal, ex. "referee" or "p1"
+    HANDLE process = NULL;              //< the process
+    HANDLE thread = NULL;               //< the primary thread
+    HANDLE job = NULL;                  //< the job enforcing the resource profile, if any
+    HANDLE jobPort = NULL;              //< the completion port of that job, if any
+    std::vector<HANDLE> pipes;          //< our ends of the pipes, and the child's ends we still hold
+};
+
+/*
+ * @brief Class describing a child process and it's pipes for reading and writing data to and from that child process.
+ */
+class Process
+{
+    const static int BUFSIZE_READ = 4096;  //< size of a single read from the child's stdout
+protected:
+    std::string_view executable;        //< the executable filename
+    std::string_view args;              //< the command line arguments for the executable
+
+    int id;                             //< the id of the process
+
+    bool use_window;                    //< does the child process use a window?
+
+    bool running;                       //< is the process running?
+
+    //The Pipe ends
+    HANDLE hChildStd_IN_Rd = NULL;
+    HANDLE hChildStd_IN_Wr = NULL;
+    HANDLE hChildStd_OUT_Rd = NULL;
+    HANDLE hChildStd_OUT_Wr = NULL;
+    HANDLE hChildStd_ERR_Rd = NULL;
+    HANDLE hChildStd_ERR_Wr = NULL;
+
+    PROCESS_INFORMATION process_info;
+    STARTUPINFOW startup_info;
+
+    //The output reader, the child's stdout is an overlapped named pipe so several children can be waited on at once
+    HANDLE readEvent = NULL;            //< signaled when the pending read completes
+    OVERLAPPED readOverlapped;          //< the pending read
+    bool readPending = false;           //< is a read in flight?
+    bool outputClosed = false;          //< has the child closed its stdout?
+    std::string outBuffer;              //< output read from the child, not consumed yet from outStart on
+    size_t outStart = 0;                //< start of the unconsumed output in outBuffer
+    char readChunk[BUFSIZE_READ];       //< target of the pending read
+    std::string writeBuffer;            //< reused to frame the data of a single write when it cannot go out in place
+
+    //The shared memory channel, used instead of the pipes once the bot opens it
+    bool sharedMemory = false;          //< advertise a channel when started?
+    std::unique_ptr<ShmTransport> shm;  //< the channel, NULL if none
+
+    ResourceUsage usage;                //< resources consumed by the child, updated by sampleUsage()
+
+    //The limits
+    HANDLE job = NULL;                  //< job object enforcing the resource profile, NULL without limits
+    HANDLE jobPort = NULL;              //< completion port receiving the job's limit notifications
+    Violation violation = NO_VIOLATION; //< the first limit the child broke
+public:
+    enum TYPE { INPUT, OUTPUT, ERR };
+    const static int BUFSIZE = 4096;    //< buffersize
+    const static DWORD TIMEOUT = 30000; //< ms to wait for a line before giving up on a child
+
+    /*
+     * @brief Constructs a null Process object.
+     */
+    Process();
+
+
+    /*
+     * @brief Copy Constructs a Process object.
+     */
+    Process(const Process& other);
+
+    /*
+     * @brief Constructs a Process object.
+     *
+     * @param executable The file to run. Required.
+     * @param args Any commandline arguments for that executable. Required.
+     * @param width the width of the child window. Default 0.
+     * @param height the height of the child window. Default 0.
+     * @param useWindow bool true or false. Default false.
+     */
+    Process(int id, const std::string_view& executable, const std::string_view& args = "", bool useWindow = false);
+
+    /*
+     * @brief Destructs the Process object.
+     */
+    ~Process();
+
+    /*
+     * @brief Gets the filename of the executable this child process is running.
+     *
+     * @return The filename.
+     */
+    std::string_view& getExe() { return this->executable; }
+
+    /*
+     * @brief Gets the command line arguments used for the executable this child process is running.
+     *
+     * @return The arguments.
+     */
+    std::string_view& getArgs() { return this->args; }
+
+    /*
+     * @brief Gets a Handle.
+     *
+     * @param type INPUT, OUTPUT, Or ERRor?
+     *
+     * @return The end of the pipe handle.
+     */
+    HANDLE& getHandle(TYPE type);
+
+
+    /*
+     * @brief Checks if pipe is empty.
+     *
+     * @param the handle to the pipe.
+     *
+     * @return true or false.
+     */
+    bool isPipeEmpty(HANDLE handle);
+
+    /*
+     * @brief Reads from a pipe.
+     *
+     * @param the pipe.
+     *
+     * @return the string read from the pipe.
+     */
+    std::string readPipe(TYPE type);
+
+    /*
+     * @brief Reads the next line the child wrote to its stdout, without the line break.
+     *
+     * @param line Set to the line. The view stays valid until this process reads again.
+     * @param timeout ms to wait for the line.
+     *
+     * @return true if a line was read, false on timeout or end of output.
+     */
+    bool readLine(std::string_view& line, DWORD timeout = TIMEOUT);
+
+    /*
+     * @brief Reads the next line the child wrote to its stdout, without the line break.
+     *
+     * @param line Set to a copy of the line.
+     * @param timeout ms to wait for the line.
+     *
+     * @return true if a line was read, false on timeout or end of output.
+     */
+    bool readLine(std::string& line, DWORD timeout = TIMEOUT);
+
+    /*
+     * @brief Reads whatever the child wrote to its stdout, waiting for some output if there is none yet.
+     *        Lines may be cut anywhere. Nothing is copied.
+     *
+     * @param chunk Set to the output. The view stays valid until this process reads again.
+     * @param timeout ms to wait for output.
+     *
+     * @return true if there was output, false on timeout or end of output.
+     */
+    bool readAvailable(std::string_view& chunk, DWORD timeout = TIMEOUT);
+
+    /*
+     * @brief Counts the complete lines read from the child and not consumed yet.
+     *
+     * @return the number of lines.
+     */
+    int countLines() const;
+
+    /*
+     * @brief Waits until the target has the given number of lines buffered. Meanwhile the output of every other
+     *        process listed is buffered as soon as it arrives, so children thinking at the same time are read at the same time.
+     *
+     * @param target The process the lines are needed from.
+     * @param lines The number of lines needed.
+     * @param others The other processes to keep reading, may include the target.
+     * @param timeout ms to wait in total.
+     *
+     * @return true if the target has the lines, false on timeout or if the target closed its output.
+     */
+    static bool waitForLines(Process& target, int lines, const std::vector<Process*>& others, DWORD timeout = TIMEOUT);
+
+    /*
+     * @brief Reads the lines the child wrote up to the next command line, the one starting with "###".
+     *        Nothing is copied, the block is the raw output as it sits in the buffer, line breaks included.
+     *
+     * @param block Set to the lines before the command. The view stays valid until this process reads again.
+     * @param command Set to the command line, without the line break. Same lifetime as block.
+     * @param timeout ms to wait for the command line.
+     *
+     * @return true if a command line was read, false on timeout or end of output.
+     */
+    bool readBlock(std::string_view& block, std::string_view& command, DWORD timeout = TIMEOUT);
+
+    /*
+     * @brief Takes up to count lines already buffered, without waiting. Nothing is copied.
+     *
+     * @param count The number of lines wanted.
+     * @param block Set to the lines taken, line breaks included. The view stays valid until this process reads again.
+     *
+     * @return the number of lines taken, less than count if not enough are buffered.
+     */
+    int takeLines(int count, std::string_view& block);
+
+    /*
+     * @brief Writes to a pipe.
+     *
+     * @param the string to write to the pipe.\
+     * @return sucess
+     */
+    bool writePipe(const std::string& data);
+
+    /*
+     * @brief Writes data to the child's stdin as is, in a single write.
+     *
+     * @param data The bytes to write.
+     *
+     * @return success true or false.
+     */
+    bool write(std::string_view data);
+
+    /*
+     * @brief Writes one line to the child's stdin, the line break is added.
+     *
+     * @param line The line, without a line break.
+     *
+     * @return success true or false.
+     */
+    bool writeLine(std::string_view line);
+
+    /*
+     * @brief Writes a block of complete lines to the child's stdin in a single write, with "\n" line breaks.
+     *        The block goes out in place unless it has "\r\n" line breaks to fix.
+     *
+     * @param block The lines, each one ending with a line break, ex. from readBlock() or takeLines().
+     *
+     * @return success true or false.
+     */
+    bool writeLines(std::string_view block);
+
+    /*
+     * @brief Turns the "\r\n" line breaks of a block of complete lines into "\n".
+     *
+     * @param block The lines, each one ending with a line break.
+     * @param buffer Holds the fixed lines, only used if there is something to fix.
+     *
+     * @return the block itself if it has no "\r", else a view of the buffer.
+     */
+    static std::string_view plainLines(std::string_view block, std::string& buffer);
+
+    /*
+     * @brief Offers the child a shared memory channel, see ShmChannel.h. Call it before start().
+     *        The pipes are still used until the child opens the channel, so it works with any bot.
+     */
+    void enableSharedMemory() { this->sharedMemory = true; }
+
+    /*
+     * @brief Checks if the child talks through the shared memory channel.
+     *
+     * @return true if the child opened the channel.
+     */
+    bool usesSharedMemory() const { return shm != nullptr && shm->isAttached(); }
+
+    /*
+     * @brief Starts the child process.
+     *
+     * @param profile The resource limits to enforce on the child and anything it spawns. Default no limits.
+     * @param group The job object of the game the child belongs to, see ProcessGroup. Default none.
+     *
+     * @return success true or false.
+     */
+    bool start(const ResourceProfile& profile = ResourceProfile(), HANDLE group = NULL);
+
+    /*
+     * @brief Hands the child over for teardown. Closes its input so it can exit on its own, then gives up every handle.
+     *        This Process object is left empty, its destructor does nothing.
+     *
+     * @param name The name of the process in the logs and journal.
+     *
+     * @return The handles, to be closed by the Reaper.
+     */
+    ProcessHandles release(const std::string& name);
+
+    /*
+     * @brief Checks if the child broke one of the limits of its resource profile.
+     *
+     * @return the first limit broken, NO_VIOLATION if none.
+     */
+    Violation checkLimits();
+
+    /*
+     * @brief Samples the resources used by the child process so far. Also works after the child exited, as long as the process handle is open.
+     *
+     * @return success true or false.
+     */
+    bool sampleUsage();
+
+    /*
+     * @brief Gets the resources used by the child process, as of the last sampleUsage().
+     *
+     * @return The resource usage.
+     */
+    const ResourceUsage& getUsage() const { return this->usage; }
+
+    /*
+     * @brief Overload an operator.
+     */
+    Process& operator=(const Process& other)
+    {
+        ZeroMemory(&startup_info, sizeof(STARTUPINFOW));
+        ZeroMemory(&process_info, sizeof(PROCESS_INFORMATION));
+        usage = ResourceUsage();
+        job = NULL;
+        jobPort = NULL;
+        violation = NO_VIOLATION;
+        readEvent = NULL;
+        readPending = false;
+        outputClosed = false;
+        outBuffer.clear();
+        outStart = 0;
+        sharedMemory = other.sharedMemory;
+        shm.reset();
+        executable = other.executable;
+        args = other.args;
+        use_window = other.use_window;
+        id = other.id + (other.running ? 10000 : 0); //we will never open 10000 processes. if it is running, we need unique pipe names 
+        running = false; //remember to start() the new process, which will setup the pipes
+
+        return *this;
+    }
+
+    /*
+     * @brief checks if process is running.
+     *
+     * @return is running true or false.
+     */
+    bool isRunning();
+
+private:
+    /*
+     * @brief Checks closes a Handle.
+     *
+     * @param the handle to the pipe.
+     */
+    void close(HANDLE handle);
+
+    /*
+     * @brief Closes a handle if it is set and resets it to NULL.
+     *
+     * @param the handle.
+     */
+    void closeIfOpen(HANDLE& handle);
+
+    /*
+     * @brief Issues an overlapped read on the child's stdout, unless one is already pending.
+     *
+     * @return false if the output is closed.
+     */
+    bool beginRead();
+
+    /*
+     * @brief Collects the pending read into the output buffer.
+     *
+     * @param wait Block until the read completes?
+     *
+     * @return true if data was added to the buffer.
+     */
+    bool completeRead(bool wait);
+
+    /*
+     * @brief Cancels the pending read, the buffers must not go away while the kernel may still write to them.
+     */
+    void cancelRead();
+
+    /*
+     * @brief Adds the handles signaled when more output may be ready to read, for waitForLines().
+     *
+     * @param events the handles to wait on.
+     */
+    void addWaitHandles(std::vector<HANDLE>& events);
+
+    /*
+     * @brief Creates the shared memory channel and the environment block advertising it.
+     *
+     * @param environment Set to the environment block for CreateProcess.
+     *
+     * @return success true or false.
+     */
+    bool createChannel(std::wstring& environment);
+
+    /*
+     * @brief Creates the pipes.
+     *
+     * @return success true or false.
+     */
+    bool createPipes();
+
+    /*
+     * @brief Puts the suspended child in a job object enforcing the profile.
+     *
+     * @param profile The resource limits.
+     *
+     * @return success true or false.
+     */
+    bool applyProfile(const ResourceProfile& profile);
+};
+#endif
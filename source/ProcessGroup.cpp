@@ -0,0 +1,49 @@
+#include "ProcessGroup.h"
+
+ProcessGroup::ProcessGroup() : job{ NULL } {}
+
+ProcessGroup::~ProcessGroup() {
+    if (job != NULL) {
+        TerminateJobObject(job, 1);
+        CloseHandle(job);
+    }
+}
+
+bool ProcessGroup::create() {
+    if (job != NULL) {
+        TerminateJobObject(job, 1);
+        CloseHandle(job);
+    }
+
+    job = CreateJobObject(NULL, NULL);
+    if (job == NULL) {
+        return false;
+    }
+
+    //if every handle goes away, so does the game, crashed tester included
+    JOBOBJECT_EXTENDED_LIMIT_INFORMATION limits;
+    ZeroMemory(&limits, sizeof(JOBOBJECT_EXTENDED_LIMIT_INFORMATION));
+    limits.BasicLimitInformation.LimitFlags = JOB_OBJECT_LIMIT_KILL_ON_JOB_CLOSE;
+    if (!SetInformationJobObject(job, JobObjectExtendedLimitInformation, &limits, sizeof(JOBOBJECT_EXTENDED_LIMIT_INFORMATION))) {
+        CloseHandle(job);
+        job = NULL;
+        return false;
+    }
+
+    return true;
+}
+
+HANDLE ProcessGroup::release() {
+    HANDLE released = job;
+    job = NULL;
+    return released;
+}
+
+DWORD ProcessGroup::activeProcesses(HANDLE job) {
+    JOBOBJECT_BASIC_ACCOUNTING_INFORMATION accounting;
+    ZeroMemory(&accounting, sizeof(JOBOBJECT_BASIC_ACCOUNTING_INFORMATION));
+    if (!QueryInformationJobObject(job, JobObjectBasicAccountingInformation, &accounting, sizeof(JOBOBJECT_BASIC_ACCOUNTING_INFORMATION), NULL)) {
+        return 0;
+    }
+    return accounting.ActiveProcesses;
+}
@@ -0,0 +1,58 @@
+#ifndef PROCESSGROUP_H
+#define PROCESSGROUP_H
+
+#include <windows.h>
+
+/*
+ * @brief Class describing the process group of one game: a job object holding the referee, the players and everything they spawn.
+ *
+ * Children of a process in the group join it too, so a referee run through "java -jar" or a shell wrapper cannot leave orphans behind.
+ * The job is created with kill on close, so even if the tester dies, closing the last handle takes the whole game down with it.
+ */
+class ProcessGroup {
+private:
+    HANDLE job;     //< the job object, NULL if not created
+
+public:
+    /*
+     * @brief Constructs an empty ProcessGroup object.
+     */
+    ProcessGroup();
+
+    /*
+     * @brief Destructs the ProcessGroup object, killing anything still in the group.
+     */
+    ~ProcessGroup();
+
+    /*
+     * @brief Creates a fresh job object for the next game. Kills whatever was left in the previous one.
+     *
+     * @return success true or false.
+     */
+    bool create();
+
+    /*
+     * @brief Gets the job handle to pass to Process::start().
+     *
+     * @return the job handle, NULL if not created.
+     */
+    HANDLE getHandle() const { return job; }
+
+    /*
+     * @brief Gives up the job handle, for the Reaper to tear the game down. The group is left empty.
+     *
+     * @return the job handle.
+     */
+    HANDLE release();
+
+    /*
+     * @brief Counts the processes still alive in a job.
+     *
+     * @param job the job handle.
+     *
+     * @return the number of live processes, 0 on error.
+     */
+    static DWORD activeProcesses(HANDLE job);
+};
+
+#endif
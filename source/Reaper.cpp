@@ -0,0 +1,147 @@
+#include "Reaper.h"
+
+Reaper::Reaper(ResultsJournal& journal, int graceMs, Level verbose)
+    :Threadable{ }, journal{ journal }, grace{ graceMs }, logger{ Logger(verbose) }, replays{ NULL }, reaped{ 0 }, killed{ 0 } {}
+
+Reaper::~Reaper() {
+    // Anything never picked up by the thread is killed right away
+    for (Teardown& teardown : queue) {
+        reap(teardown);
+    }
+    queue.clear();
+}
+
+Logger& Reaper::getLog() { return logger; }
+
+void Reaper::setReplayMover(ReplayMover* replays) { this->replays = replays; }
+
+void Reaper::add(int game, HANDLE group, std::vector<ProcessHandles> processes) {
+    {
+        std::lock_guard<std::mutex> lock(m_queue);
+        queue.push_back({ game, group, std::move(processes), std::chrono::steady_clock::now() + grace });
+    }
+    m_cv.notify_one();
+}
+
+void Reaper::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(m_queue);
+        setStop();
+    }
+    m_cv.notify_one();
+}
+
+void Reaper::run() {
+    std::vector<Teardown> active;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_queue);
+
+            //sleep until there is work, or poll the games in their grace period
+            if (active.empty()) {
+                m_cv.wait(lock, [this] { return !queue.empty() || shouldStop(); });
+            }
+            else {
+                m_cv.wait_for(lock, std::chrono::milliseconds(5), [this] { return !queue.empty(); });
+            }
+
+            while (!queue.empty()) {
+                active.push_back(std::move(queue.front()));
+                queue.pop_front();
+            }
+
+            if (active.empty() && shouldStop()) break;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        for (auto it = active.begin(); it != active.end();) {
+            if (hasExited(*it) || now >= it->deadline) {
+                reap(*it);
+                it = active.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+    }
+
+    std::string logString = "Reaper tore down " + std::to_string(reaped) + " processes, ";
+    logString += std::to_string(killed) + " killed after the grace period.";
+    logger.addLog(Level::INFO, logString);
+
+    setFinished();
+}
+
+bool Reaper::hasExited(const Teardown& teardown) {
+    //the group also sees grandchildren, ex. the jvm behind a shell wrapper
+    if (teardown.group != NULL) {
+        return ProcessGroup::activeProcesses(teardown.group) == 0;
+    }
+
+    for (const ProcessHandles& process : teardown.processes) {
+        if (process.process != NULL && WaitForSingleObject(process.process, 0) == WAIT_TIMEOUT) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Reaper::reap(Teardown& teardown) {
+    std::vector<bool> alive;
+    for (const ProcessHandles& process : teardown.processes) {
+        alive.push_back(process.process != NULL && WaitForSingleObject(process.process, 0) == WAIT_TIMEOUT);
+    }
+    bool exited = hasExited(teardown);
+
+    //whatever is still running is killed, the whole tree at once if there is a group
+    if (!exited) {
+        if (teardown.group != NULL) {
+            TerminateJobObject(teardown.group, 1);
+        }
+        else {
+            for (ProcessHandles& process : teardown.processes) {
+                if (process.process != NULL) TerminateProcess(process.process, 1);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < teardown.processes.size(); ++i) {
+        ProcessHandles& process = teardown.processes[i];
+        if (process.process != NULL) {
+            //termination is asynchronous, give it a moment so the exit code is final
+            if (alive[i]) WaitForSingleObject(process.process, 100);
+
+            DWORD exitCode = 0;
+            GetExitCodeProcess(process.process, &exitCode);
+            std::string data = std::to_string(exitCode);
+            if (exitCode == STILL_ACTIVE) data = "running";
+            if (alive[i]) data += " killed";
+            journal.addRecord(teardown.game, "exit " + process.name, data);
+
+            if (alive[i]) {
+                killed++;
+                std::string logString = "[Game " + std::to_string(teardown.game) + "] " + process.name;
+                logString += " did not exit within the grace period and was killed.";
+                logger.addLog(Level::VERBOSE, logString);
+            }
+            reaped++;
+            CloseHandle(process.process);
+        }
+        if (process.thread != NULL) CloseHandle(process.thread);
+        if (process.jobPort != NULL) CloseHandle(process.jobPort);
+        if (process.job != NULL) CloseHandle(process.job);
+        for (HANDLE pipe : process.pipes) {
+            CloseHandle(pipe);
+        }
+    }
+
+    if (teardown.group != NULL) {
+        CloseHandle(teardown.group);
+    }
+
+    //the referee is gone, its replay is complete
+    if (replays != NULL) {
+        replays->add(teardown.game);
+    }
+}
@@ -0,0 +1,115 @@
+#ifndef REAPER_H
+#define REAPER_H
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <windows.h>
+#include "Threadable.h"
+#include "Process.h"
+#include "ProcessGroup.h"
+#include "ResultsJournal.h"
+#include "Logger.h"
+#include "ReplayMover.h"
+
+/*
+ * @brief Class describing the Reaper, the one thread tearing down finished games for all game threads.
+ *
+ * A game thread hands over its processes with add() and starts its next game right away. The Reaper gives the
+ * processes a grace period to exit on their own once their input is closed, then kills whatever is left in the
+ * game's group, journals the exit codes and closes every handle.
+ */
+class Reaper : public Threadable {
+private:
+    /*
+     * @brief Struct describing one game waiting to be torn down.
+     */
+    struct Teardown {
+        int game;                                           //< the game number
+        HANDLE group;                                       //< the game's job object, may be NULL
+        std::vector<ProcessHandles> processes;              //< the game's processes
+        std::chrono::steady_clock::time_point deadline;     //< when the grace period is over
+    };
+
+    ResultsJournal& journal;                    //< Shared results journal.
+    std::chrono::milliseconds grace;            //< How long processes get to exit on their own.
+    Logger logger;                              //< The log object.
+    ReplayMover* replays;                       //< Told when a game's referee is gone, NULL if the replays are not staged.
+
+    std::deque<Teardown> queue;                 //< Games handed over, not picked up by the thread yet.
+    std::mutex m_queue;                         //< Mutex protecting the queue.
+    std::condition_variable m_cv;               //< Wakes the thread when a game is handed over or on shutdown.
+
+    int reaped;                                 //< Number of processes torn down.
+    int killed;                                 //< Number of processes still running after the grace period.
+
+    /*
+     * @brief Checks if everything in a teardown exited on its own.
+     *
+     * @param teardown the teardown.
+     *
+     * @return true if nothing is left running.
+     */
+    bool hasExited(const Teardown& teardown);
+
+    /*
+     * @brief Kills whatever is left, journals the exit codes and closes the handles.
+     *
+     * @param teardown the teardown.
+     */
+    void reap(Teardown& teardown);
+
+protected:
+    /*
+     * @brief The run method from the Threadable base class we must overide.
+     */
+    void run() override;
+
+public:
+    /*
+     * @brief Constructs a Reaper object.
+     *
+     * @param journal the shared results journal.
+     * @param graceMs the grace period in ms.
+     * @param verbose The verbosity to use for the logs.
+     */
+    Reaper(ResultsJournal& journal, int graceMs, Level verbose);
+
+    /*
+     * @brief Destructs the Reaper object.
+     */
+    ~Reaper();
+
+    /*
+     * @brief Sets the replay mover to hand every torn down game to, see ReplayMover.h. Call before start().
+     *
+     * @param replays the mover, NULL if the replays are not staged.
+     */
+    void setReplayMover(ReplayMover* replays);
+
+    /*
+     * @brief Hands a finished game over for teardown. Never blocks on the processes.
+     *
+     * @param game the game number.
+     * @param group the game's job object from ProcessGroup::release(), may be NULL.
+     * @param processes the handles from Process::release().
+     */
+    void add(int game, HANDLE group, std::vector<ProcessHandles> processes);
+
+    /*
+     * @brief Tears down everything handed over so far, then ends the thread. Wait for isFinished() after.
+     */
+    void shutdown();
+
+    /*
+     * @brief Gets the log.
+     *
+     * @return the log.
+     */
+    Logger& getLog();
+};
+
+#endif
@@ -0,0 +1,43 @@
+#include "RefereeCommand.h"
+#include "StringUtils.h"
+
+RefereeCommand::RefereeCommand(const std::vector<std::string>& playersCmd, bool seeded, bool replay) : refereeInputIdx{ 0 }, replayIdx{ 0 } {
+    size_t playersCount = playersCmd.size();
+    command.assign(playersCount * 2 + (seeded ? 2 : 0) + (replay ? 2 : 0), "");
+    pArgIdx.reserve(playersCount);
+
+    for (size_t i = 0; i < playersCount; ++i) {
+        pArgIdx.push_back(i * 2 + 1);
+        command[i * 2] = "-p" + std::to_string(i + 1);
+        command[i * 2 + 1] = playersCmd[i];
+    }
+
+    if (seeded) {
+        refereeInputIdx = playersCount * 2 + 1;
+        command[refereeInputIdx - 1] = "-d";
+    }
+
+    if (replay) {
+        replayIdx = command.size() - 1;
+        command[replayIdx - 1] = "-l";
+    }
+}
+
+void RefereeCommand::seat(const std::vector<std::string>& playersCmd, int rotate) {
+    size_t playersCount = pArgIdx.size();
+    for (size_t i = 0; i < playersCount; i++) {
+        command[pArgIdx[i]] = playersCmd[(i + rotate) % playersCount];
+    }
+}
+
+void RefereeCommand::setSeed(long long seed) {
+    if (refereeInputIdx != 0) command[refereeInputIdx] = "seed=" + std::to_string(seed);
+}
+
+void RefereeCommand::setReplay(const std::string& replay) {
+    if (replayIdx != 0) command[replayIdx] = replay.find(' ') != std::string::npos ? "\"" + replay + "\"" : replay;
+}
+
+std::string RefereeCommand::join() const {
+    return StringUtils::joinString<std::string>(command, command.begin(), command.end(), " ");
+}
@@ -0,0 +1,60 @@
+#ifndef REFEREECOMMAND_H
+#define REFEREECOMMAND_H
+
+#include <vector>
+#include <string>
+
+/*
+ * @brief Class describing the arguments of a new mode referee: -p1 <cmd> ... [-d seed=<seed>] [-l <replay>].
+ *
+ * The layout is set once per thread, each game then only fills in its seats, seed and replay before join(). The referee
+ * command line itself goes to Process, these are only its arguments.
+ */
+class RefereeCommand {
+private:
+    std::vector<std::string> command;   //< the arguments
+    std::vector<size_t> pArgIdx;        //< the index of each seat's player command line
+    size_t refereeInputIdx;             //< the index of the seed, 0 without -d
+    size_t replayIdx;                   //< the index of the replay, 0 without -l
+
+public:
+    /*
+     * @brief Constructs a RefereeCommand object, the players in their own seats.
+     *
+     * @param playersCmd the players command lines.
+     * @param seeded does the referee get a seed with -d?
+     * @param replay does the referee write a replay with -l?
+     */
+    RefereeCommand(const std::vector<std::string>& playersCmd, bool seeded, bool replay);
+
+    /*
+     * @brief Seats the players, the player in seat s is playersCmd[(s + rotate) % playersCount].
+     *
+     * @param playersCmd the players command lines.
+     * @param rotate how far the players are rotated.
+     */
+    void seat(const std::vector<std::string>& playersCmd, int rotate);
+
+    /*
+     * @brief Sets the seed. Only with -d.
+     *
+     * @param seed the seed.
+     */
+    void setSeed(long long seed);
+
+    /*
+     * @brief Sets where the referee writes its replay, quoted if it has spaces. Only with -l.
+     *
+     * @param replay the replay's path.
+     */
+    void setReplay(const std::string& replay);
+
+    /*
+     * @brief Gets the arguments as one string.
+     *
+     * @return the arguments, separated by spaces.
+     */
+    std::string join() const;
+};
+
+#endif
@@ -0,0 +1,34 @@
+#include "RefereePlugin.h"
+
+RefereePlugin::RefereePlugin()
+    :module{ NULL }, abiVersion{ NULL }, initGame{ NULL }, nextPlayerFn{ NULL }, nextInputFn{ NULL }, submitOutputFn{ NULL }, resultFn{ NULL }, freeGame{ NULL } {}
+
+RefereePlugin::~RefereePlugin() {
+    if (module != NULL) {
+        FreeLibrary(module);
+    }
+}
+
+bool RefereePlugin::load(const std::string& path) {
+    module = LoadLibraryA(path.c_str());
+    if (module == NULL) {
+        error = "Could not load " + path + " (" + std::to_string(GetLastError()) + ").";
+        return false;
+    }
+
+    if (!resolve("referee_abi_version", abiVersion)) {
+        return false;
+    }
+    int version = abiVersion();
+    if (version != REFEREE_ABI_VERSION) {
+        error = "The plugin was built for ABI version " + std::to_string(version) + ", the tester needs version " + std::to_string(REFEREE_ABI_VERSION) + ".";
+        return false;
+    }
+
+    return resolve("referee_init", initGame)
+        && resolve("referee_next_player", nextPlayerFn)
+        && resolve("referee_next_input", nextInputFn)
+        && resolve("referee_submit_output", submitOutputFn)
+        && resolve("referee_result", resultFn)
+        && resolve("referee_free", freeGame);
+}
@@ -0,0 +1,103 @@
+#ifndef REFEREEPLUGIN_H
+#define REFEREEPLUGIN_H
+
+#include <string>
+#include <windows.h>
+#include "RefereePluginApi.h"
+
+/*
+ * @brief Class describing a referee plugin, a DLL implementing RefereePluginApi.h. Loaded once, shared by every game thread.
+ */
+class RefereePlugin {
+private:
+    HMODULE module;                                 //< the loaded DLL, NULL if not loaded
+    std::string error;                              //< why the last load() failed
+
+    referee_abi_version_fn abiVersion;              //< the plugin's referee_abi_version
+    referee_init_fn initGame;                       //< the plugin's referee_init
+    referee_next_player_fn nextPlayerFn;            //< the plugin's referee_next_player
+    referee_next_input_fn nextInputFn;              //< the plugin's referee_next_input
+    referee_submit_output_fn submitOutputFn;        //< the plugin's referee_submit_output
+    referee_result_fn resultFn;                     //< the plugin's referee_result
+    referee_free_fn freeGame;                       //< the plugin's referee_free
+
+    /*
+     * @brief Looks up one function of the plugin.
+     *
+     * @param name the exported name.
+     * @param function Set to the function.
+     *
+     * @return true if found.
+     */
+    template <typename T>
+    bool resolve(const char* name, T& function) {
+        function = reinterpret_cast<T>(GetProcAddress(module, name));
+        if (function == NULL) {
+            error = std::string("The plugin does not export ") + name + ".";
+            return false;
+        }
+        return true;
+    }
+
+public:
+    /*
+     * @brief Constructs an empty RefereePlugin object.
+     */
+    RefereePlugin();
+
+    /*
+     * @brief Destructs the RefereePlugin object, unloading the DLL. No game may still be running.
+     */
+    ~RefereePlugin();
+
+    RefereePlugin(const RefereePlugin&) = delete;
+    RefereePlugin& operator=(const RefereePlugin&) = delete;
+
+    /*
+     * @brief Loads the DLL and checks its ABI version.
+     *
+     * @param path the path of the DLL.
+     *
+     * @return success true or false, see getError().
+     */
+    bool load(const std::string& path);
+
+    /*
+     * @brief Gets why the last load() failed.
+     *
+     * @return the error message.
+     */
+    const std::string& getError() const { return error; }
+
+    /*
+     * @brief See referee_init in RefereePluginApi.h.
+     */
+    RefereeGame* init(long long seed, int players) const { return initGame(seed, players); }
+
+    /*
+     * @brief See referee_next_player in RefereePluginApi.h.
+     */
+    int nextPlayer(RefereeGame* game) const { return nextPlayerFn(game); }
+
+    /*
+     * @brief See referee_next_input in RefereePluginApi.h.
+     */
+    int nextInput(RefereeGame* game, int player, const char** input, size_t* length) const { return nextInputFn(game, player, input, length); }
+
+    /*
+     * @brief See referee_submit_output in RefereePluginApi.h.
+     */
+    int submitOutput(RefereeGame* game, int player, const char* output, size_t length) const { return submitOutputFn(game, player, output, length); }
+
+    /*
+     * @brief See referee_result in RefereePluginApi.h.
+     */
+    int result(RefereeGame* game, int* scores, int players) const { return resultFn(game, scores, players); }
+
+    /*
+     * @brief See referee_free in RefereePluginApi.h.
+     */
+    void free(RefereeGame* game) const { freeGame(game); }
+};
+
+#endif
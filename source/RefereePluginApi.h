@@ -0,0 +1,117 @@
+#ifndef REFEREEPLUGINAPI_H
+#define REFEREEPLUGINAPI_H
+
+/*
+ * The C ABI of an in-process referee, a DLL the tester loads with -ip instead of running a referee process.
+ *
+ * The tester runs one game per thread, so the functions are called for several games at once. Keep all the state
+ * of a game in its RefereeGame, nothing global. A game goes:
+ *
+ *   game = referee_init(seed, players)
+ *   while ((player = referee_next_player(game)) >= 0)
+ *       lines = referee_next_input(game, player, &input, &length)     the tester writes input to the player
+ *       referee_submit_output(game, player, output, length)            the player's lines, NULL if it timed out
+ *   referee_result(game, scores, players)
+ *   referee_free(game)
+ *
+ * Buffers handed out by the referee stay valid until the next call for the same game. Lines end with "\n".
+ * Bump REFEREE_ABI_VERSION on any change to this file, the tester refuses a plugin with another version.
+ */
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef REFEREE_PLUGIN_EXPORTS
+#define REFEREE_API __declspec(dllexport)
+#else
+#define REFEREE_API __declspec(dllimport)
+#endif
+
+#define REFEREE_ABI_VERSION 1
+
+typedef struct RefereeGame RefereeGame;
+
+/*
+ * @brief Gets the ABI version the plugin was built with.
+ *
+ * @return REFEREE_ABI_VERSION.
+ */
+REFEREE_API int referee_abi_version(void);
+
+/*
+ * @brief Starts a game.
+ *
+ * @param seed the seed of the game, the same seed must give the same game.
+ * @param players the number of players.
+ *
+ * @return the game, NULL if the referee cannot play it, ex. a wrong number of players.
+ */
+REFEREE_API RefereeGame* referee_init(long long seed, int players);
+
+/*
+ * @brief Gets the player to play next.
+ *
+ * @param game the game.
+ *
+ * @return the player index, -1 once the game is over.
+ */
+REFEREE_API int referee_next_player(RefereeGame* game);
+
+/*
+ * @brief Gets the input for a player's turn.
+ *
+ * @param game the game.
+ * @param player the player from referee_next_player().
+ * @param input Set to the lines to send to the player.
+ * @param length Set to the length of the input in bytes.
+ *
+ * @return the number of lines the player must answer with, -1 on error.
+ */
+REFEREE_API int referee_next_input(RefereeGame* game, int player, const char** input, size_t* length);
+
+/*
+ * @brief Hands the player's answer to the referee.
+ *
+ * @param game the game.
+ * @param player the player.
+ * @param output the lines the player answered with, NULL if it did not answer in time.
+ * @param length the length of the output in bytes.
+ *
+ * @return 0 if the answer is valid, anything else if the player lost for it. The game goes on either way.
+ */
+REFEREE_API int referee_submit_output(RefereeGame* game, int player, const char* output, size_t length);
+
+/*
+ * @brief Gets the final scores, the higher the better.
+ *
+ * @param game the game.
+ * @param scores Set to the score of each player.
+ * @param players the size of scores.
+ *
+ * @return 0 on success.
+ */
+REFEREE_API int referee_result(RefereeGame* game, int* scores, int players);
+
+/*
+ * @brief Ends a game and frees it.
+ *
+ * @param game the game.
+ */
+REFEREE_API void referee_free(RefereeGame* game);
+
+typedef int (*referee_abi_version_fn)(void);
+typedef RefereeGame* (*referee_init_fn)(long long seed, int players);
+typedef int (*referee_next_player_fn)(RefereeGame* game);
+typedef int (*referee_next_input_fn)(RefereeGame* game, int player, const char** input, size_t* length);
+typedef int (*referee_submit_output_fn)(RefereeGame* game, int player, const char* output, size_t length);
+typedef int (*referee_result_fn)(RefereeGame* game, int* scores, int players);
+typedef void (*referee_free_fn)(RefereeGame* game);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,152 @@
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include "RemoteScheduler.h"
+
+#include <sstream>
+#include <iostream>
+#include <thread>
+#include <chrono>
+
+#pragma comment(lib, "ws2_32.lib")
+
+RemoteScheduler::RemoteScheduler()
+    :connection{ INVALID_SOCKET }, playersCount{ 0 }, received{ 0 }, reported{ 0 }, closed{ true } {}
+
+RemoteScheduler::~RemoteScheduler() {
+    if ((SOCKET)connection != INVALID_SOCKET) {
+        closesocket((SOCKET)connection);
+        WSACleanup();
+    }
+}
+
+bool RemoteScheduler::connect(const std::string& host, const std::string& port, const std::string& token) {
+    WSADATA data;
+    if (WSAStartup(MAKEWORD(2, 2), &data) != 0) return false;
+
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_protocol = IPPROTO_TCP;
+    addrinfo* addresses = NULL;
+    if (getaddrinfo(host.c_str(), port.c_str(), &hints, &addresses) != 0) {
+        WSACleanup();
+        return false;
+    }
+
+    SOCKET s = INVALID_SOCKET;
+    for (addrinfo* address = addresses; address != NULL && s == INVALID_SOCKET; address = address->ai_next) {
+        s = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        if (s != INVALID_SOCKET && ::connect(s, address->ai_addr, (int)address->ai_addrlen) == SOCKET_ERROR) {
+            closesocket(s);
+            s = INVALID_SOCKET;
+        }
+    }
+    freeaddrinfo(addresses);
+    if (s == INVALID_SOCKET) {
+        WSACleanup();
+        return false;
+    }
+
+    BOOL noDelay = TRUE;
+    setsockopt(s, IPPROTO_TCP, TCP_NODELAY, (const char*)&noDelay, sizeof(noDelay));
+    connection = (std::uintptr_t)s;
+    closed = false;
+
+    std::string line;
+    std::string type;
+    if (!readLine(line)) return false;
+    std::istringstream fields(line);
+    fields >> type >> playersCount;
+    if (type != "hello" || playersCount < 1) {
+        closed = true;
+        return false;
+    }
+    return send("hello " + token + "\n");
+}
+
+int RemoteScheduler::getPlayersCount() const {
+    return playersCount;
+}
+
+bool RemoteScheduler::send(const std::string& text) {
+    size_t sent = 0;
+    while (sent < text.size()) {
+        int written = ::send((SOCKET)connection, text.data() + sent, (int)(text.size() - sent), 0);
+        if (written == SOCKET_ERROR) {
+            closed = true;
+            return false;
+        }
+        sent += written;
+    }
+    return true;
+}
+
+bool RemoteScheduler::readLine(std::string& line) {
+    size_t end;
+    while ((end = input.find('\n')) == std::string::npos) {
+        char buffer[4096];
+        int count = recv((SOCKET)connection, buffer, sizeof(buffer), 0);
+        if (count <= 0) {
+            closed = true;
+            return false;
+        }
+        input.append(buffer, count);
+    }
+    line = input.substr(0, end);
+    input.erase(0, end + 1);
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    return true;
+}
+
+bool RemoteScheduler::next(GameOrder& order) {
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (closed || !send("next\n")) return false;
+
+            std::string line;
+            if (!readLine(line)) return false;
+            std::istringstream fields(line);
+            std::string type;
+            fields >> type;
+
+            if (type == "game") {
+                size_t count = 0;
+                fields >> order.game >> order.seed >> order.rotation >> order.tag >> count;
+                //checked before anything is sized by it, a garbled count must not allocate
+                if (fields.fail() || count != (size_t)playersCount) {
+                    closed = true;
+                    return false;
+                }
+                order.players.resize(count);
+                for (size_t i = 0; i < count; ++i) {
+                    if (!readLine(order.players[i])) return false;
+                }
+                received++;
+                return true;
+            }
+            if (type != "wait") {
+                closed = true;
+                return false;
+            }
+        }
+        //another worker holds the last games, they come back here if it drops
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    }
+}
+
+void RemoteScheduler::report(const GameOrder& order, const std::vector<int>& scores) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (closed) return;
+
+    std::string message = "result " + std::to_string(order.game) + " " + std::to_string(scores.size());
+    for (int score : scores) {
+        message += " " + std::to_string(score);
+    }
+    if (send(message + "\n")) reported++;
+}
+
+void RemoteScheduler::print() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::cout << "Worker played " << received << " games for the coordinator, " << reported << " results sent." << std::endl;
+}
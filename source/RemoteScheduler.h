@@ -0,0 +1,77 @@
+#ifndef REMOTESCHEDULER_H
+#define REMOTESCHEDULER_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <cstdint>
+#include "Scheduler.h"
+
+/*
+ * @brief Class describing a worker's side of a Coordinator: the games come from the coordinator over TCP and the results go back to it.
+ *
+ * All the game threads of the worker share the one connection. See Coordinator.h for the protocol.
+ */
+class RemoteScheduler : public Scheduler {
+private:
+    std::uintptr_t connection;              //< the SOCKET, kept out of this header so it does not pull in winsock2.h after windows.h
+    std::string input;                      //< received, not read as a line yet
+    int playersCount;                       //< the players per game, from the coordinator's hello
+    int received;                           //< games received
+    int reported;                           //< results sent
+    bool closed;                            //< the coordinator is gone or said the run is over
+    std::mutex m_mutex;                     //< Mutex protecting everything above.
+
+    /*
+     * @brief Reads one line from the coordinator.
+     *
+     * @param line Set to the line, without the line feed.
+     *
+     * @return success true or false, false if the connection is closed.
+     */
+    bool readLine(std::string& line);
+
+    /*
+     * @brief Sends text to the coordinator, all of it.
+     *
+     * @param text the text.
+     *
+     * @return success true or false.
+     */
+    bool send(const std::string& text);
+
+public:
+    /*
+     * @brief Constructs a RemoteScheduler object, not connected yet.
+     */
+    RemoteScheduler();
+
+    /*
+     * @brief Destructs the RemoteScheduler object, closing the connection.
+     */
+    ~RemoteScheduler();
+
+    /*
+     * @brief Connects to a coordinator, reads its hello and answers with the run's token.
+     *
+     * @param host the coordinator's host name or address.
+     * @param port the coordinator's TCP port.
+     * @param token the coordinator's token, a wrong one only shows up as the connection closing on the first next().
+     *
+     * @return success true or false.
+     */
+    bool connect(const std::string& host, const std::string& port, const std::string& token);
+
+    /*
+     * @brief Gets the players per game of the run.
+     *
+     * @return the number of players.
+     */
+    int getPlayersCount() const;
+
+    bool next(GameOrder& order) override;
+    void report(const GameOrder& order, const std::vector<int>& scores) override;
+    void print() override;
+};
+
+#endif
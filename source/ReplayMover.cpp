@@ -0,0 +1,149 @@
+#include "ReplayMover.h"
+#include "ExePath.h"
+
+#include <fstream>
+#include <sstream>
+#include <windows.h>
+
+ReplayMover::ReplayMover(ResultsJournal& journal, size_t depth, Level verbose)
+    :Threadable{ }, gameLogs{ NULL }, depth{ depth }, journal{ journal }, logger{ Logger(verbose) }, moved{ 0 }, missing{ 0 }, failed{ 0 }, broken{ 0 } {}
+
+Logger& ReplayMover::getLog() { return logger; }
+
+void ReplayMover::setGameLogs(GameLogWriter* gameLogs) { this->gameLogs = gameLogs; }
+
+void ReplayMover::setFields(const std::vector<std::string>& fields) { scanner.setFields(fields); }
+
+std::string ReplayMover::replayName(int game) { return "Game" + std::to_string(game) + ".json"; }
+
+bool ReplayMover::open(const std::string& staging, const std::string& dir) {
+    this->dir = ExePath::resolve(dir);
+
+    //testers sharing a staging directory each get their own, their game numbers are the same
+    this->staging = ExePath::resolve(staging) / ("new-cg-brutal-tester-" + std::to_string(GetCurrentProcessId()));
+    std::error_code error;
+    std::filesystem::create_directories(this->staging, error);
+    return std::filesystem::is_directory(this->staging, error);
+}
+
+std::string ReplayMover::stage(int game) {
+    {
+        std::unique_lock<std::mutex> lock(m_queue);
+        m_space.wait(lock, [this] { return staged.size() < depth || shouldStop(); });
+        staged.insert(game);
+    }
+    return (staging / replayName(game)).string();
+}
+
+void ReplayMover::add(int game) {
+    {
+        std::lock_guard<std::mutex> lock(m_queue);
+        if (staged.find(game) == staged.end()) return;
+        queue.push_back(game);
+    }
+    m_cv.notify_one();
+}
+
+void ReplayMover::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(m_queue);
+        setStop();
+    }
+    m_cv.notify_one();
+    m_space.notify_all();
+}
+
+void ReplayMover::move(int game) {
+    std::filesystem::path from = staging / replayName(game);
+    std::error_code error;
+    if (!std::filesystem::exists(from, error)) {
+        missing++;
+        return;
+    }
+    if (scanner.hasFields()) scan(game, from);
+
+    if (gameLogs != NULL && gameLogs->hasArchive()) {
+        std::ifstream in(from, std::ifstream::in | std::ifstream::binary);
+        if (!in.is_open()) {
+            failed++;
+            logger.addLog(Level::WARN, "Cannot read the replay of game " + std::to_string(game) + ".");
+            return;
+        }
+        std::stringstream data;
+        data << in.rdbuf();
+        in.close();
+        gameLogs->writeFile(game, replayName(game), data.str());
+        std::filesystem::remove(from, error);
+        moved++;
+        return;
+    }
+
+    //a rename on the same volume, else a copy and a delete
+    std::filesystem::path to = dir / replayName(game);
+    if (!MoveFileExW(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_COPY_ALLOWED)) {
+        failed++;
+        logger.addLog(Level::WARN, "Cannot move the replay of game " + std::to_string(game) + ": error " + std::to_string(GetLastError()) + ".");
+        return;
+    }
+    moved++;
+}
+
+void ReplayMover::scan(int game, const std::filesystem::path& file) {
+    std::ifstream in(file, std::ifstream::in | std::ifstream::binary);
+    if (!in.is_open()) return;
+
+    //the matches go to the journal together once the replay is read, the game threads share its mutex
+    std::vector<std::pair<std::string, std::string> > records;
+    JsonScanner::Found found = [&records](std::string_view path, std::string_view value) {
+        records.emplace_back("json " + std::string(path), std::string(value));
+    };
+
+    //the replay is never held, only one chunk of it
+    scanner.reset();
+    char buffer[65536];
+    while (in.read(buffer, sizeof(buffer)) || in.gcount() > 0) {
+        scanner.feed(std::string_view(buffer, (size_t)in.gcount()), found);
+    }
+
+    if (!scanner.finish(found)) {
+        broken++;
+        logger.addLog(Level::WARN, "The replay of game " + std::to_string(game) + " is not valid JSON, its fields may be missing.");
+    }
+    if (scanner.getDropped() > 0) {
+        records.emplace_back("json dropped", std::to_string(scanner.getDropped()));
+    }
+    journal.addRecords(game, records);
+}
+
+void ReplayMover::run() {
+    while (true) {
+        int game;
+        {
+            std::unique_lock<std::mutex> lock(m_queue);
+            m_cv.wait(lock, [this] { return !queue.empty() || shouldStop(); });
+            if (queue.empty() && shouldStop()) break;
+            game = queue.front();
+            queue.pop_front();
+        }
+
+        move(game);
+
+        //the staged replay is gone either way
+        {
+            std::lock_guard<std::mutex> lock(m_queue);
+            staged.erase(game);
+        }
+        m_space.notify_all();
+    }
+
+    //only empty, a replay never handed over is left for a look
+    std::error_code error;
+    std::filesystem::remove(staging, error);
+
+    std::string logString = "Replays: " + std::to_string(moved) + " moved, " + std::to_string(missing) + " never written";
+    if (failed > 0) logString += ", " + std::to_string(failed) + " could not be moved";
+    if (broken > 0) logString += ", " + std::to_string(broken) + " not valid JSON";
+    logger.addLog(Level::INFO, logString + ".");
+
+    setFinished();
+}
@@ -0,0 +1,141 @@
+#ifndef REPLAYMOVER_H
+#define REPLAYMOVER_H
+
+#include <deque>
+#include <string>
+#include <filesystem>
+#include <unordered_set>
+#include <mutex>
+#include <condition_variable>
+#include "Threadable.h"
+#include "Logger.h"
+#include "GameLogWriter.h"
+#include "ResultsJournal.h"
+#include "JsonScanner.h"
+
+/*
+ * @brief Class describing the replay mover, the one thread moving the referees' replays, the "-l" JSON files, from a
+ * fast staging directory to the log directory.
+ *
+ * A game thread gets the staged path of its game's replay with stage(), the Reaper hands the game over with add() once
+ * the referee is gone and the file complete, and the mover moves it, or compresses it into the game archive. A referee
+ * so only ever writes to the staging directory, ex. a RAM disk or the local temp directory, and never waits on a slow
+ * log directory. The staged replays are capped, stage() waits while too many are waiting to be moved.
+ *
+ * With fields to extract, each replay is first scanned for them, see JsonScanner.h, and every match is journaled as a
+ * "json <path>" record of its game, so the replays never need parsing again to be analysed.
+ */
+class ReplayMover : public Threadable {
+private:
+    std::filesystem::path staging;              //< this run's own directory in the staging directory
+    std::filesystem::path dir;                  //< the log directory, resolved
+    GameLogWriter* gameLogs;                    //< The writer the replays go to when it has an archive, NULL to move them.
+    size_t depth;                               //< replays staged before stage() waits
+    ResultsJournal& journal;                    //< Shared results journal.
+    JsonScanner scanner;                        //< Picks the fields out of the replays, matches nothing without fields.
+    Logger logger;                              //< The log object.
+
+    std::deque<int> queue;                      //< Games handed over, not moved yet.
+    std::unordered_set<int> staged;             //< Games staged, not moved yet.
+    std::mutex m_queue;                         //< Mutex protecting the queue and staged.
+    std::condition_variable m_cv;               //< Wakes the thread when a game is handed over or on shutdown.
+    std::condition_variable m_space;            //< Wakes the game threads when a replay was moved.
+
+    int moved;                                  //< Replays moved.
+    int missing;                                //< Games without a replay, ex. a referee that crashed.
+    int failed;                                 //< Replays that could not be moved.
+    int broken;                                 //< Replays that are not valid JSON.
+
+    /*
+     * @brief Gets a replay's file name.
+     *
+     * @param game the game number.
+     *
+     * @return the name.
+     */
+    static std::string replayName(int game);
+
+    /*
+     * @brief Moves a game's replay to the log directory, or into the archive.
+     *
+     * @param game the game number.
+     */
+    void move(int game);
+
+    /*
+     * @brief Journals the fields of a game's replay, reading it in chunks.
+     *
+     * @param game the game number.
+     * @param file the replay.
+     */
+    void scan(int game, const std::filesystem::path& file);
+
+protected:
+    /*
+     * @brief The run method from the Threadable base class we must overide.
+     */
+    void run() override;
+
+public:
+    /*
+     * @brief Constructs a ReplayMover object.
+     *
+     * @param journal the shared results journal.
+     * @param depth the replays staged before stage() waits.
+     * @param verbose The verbosity to use for the logs.
+     */
+    ReplayMover(ResultsJournal& journal, size_t depth, Level verbose);
+
+    /*
+     * @brief Creates this run's staging directory. Relative directories are resolved next to the executable, like the logs.
+     *
+     * @param staging The staging directory, ex. a RAM disk.
+     * @param dir The log directory.
+     * @return true if the staging directory was created, false otherwise.
+     */
+    bool open(const std::string& staging, const std::string& dir);
+
+    /*
+     * @brief Hands the replays to a game log writer when it has an archive, see GameLogWriter.h. Call before start().
+     *
+     * @param gameLogs the writer, NULL to move the replays to the log directory.
+     */
+    void setGameLogs(GameLogWriter* gameLogs);
+
+    /*
+     * @brief Sets the fields to journal out of every replay. Call before start().
+     *
+     * @param fields the patterns, ex. "scores.*", see JsonScanner.h. None to journal nothing.
+     */
+    void setFields(const std::vector<std::string>& fields);
+
+    /*
+     * @brief Gets where a game's referee writes its replay. Thread safe, waits while too many replays are staged.
+     *
+     * @param game the game number.
+     *
+     * @return the staged path.
+     */
+    std::string stage(int game);
+
+    /*
+     * @brief Hands a game over once its referee is gone. Thread safe, never blocks. Games not staged are ignored.
+     *
+     * @param game the game number.
+     */
+    void add(int game);
+
+    /*
+     * @brief Moves everything handed over so far, then ends the thread. Wait for isFinished() after.
+     */
+    void shutdown();
+
+    /*
+     * @brief Gets the log.
+     *
+     * @return the log.
+     */
+    Logger& getLog();
+};
+
+#endif
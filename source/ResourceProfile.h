@@ -0,0 +1,44 @@
+#ifndef RESOURCEPROFILE_H
+#define RESOURCEPROFILE_H
+
+#include <string>
+
+enum Violation { NO_VIOLATION, MEMORY_LIMIT, CPU_LIMIT, PROCESS_LIMIT };
+
+/*
+ * @brief Struct describing the resource limits to put on a child process, ex. the CodinGame 768 MB memory cap. A zero means no limit.
+ */
+struct ResourceProfile {
+    unsigned long long memoryLimit = 0;     //< max committed memory of each process in bytes
+    unsigned long long cpuTimeLimit = 0;    //< max user mode cpu time of each process in ms
+    unsigned int processLimit = 0;          //< max number of live processes the child may have, itself included
+
+    /*
+     * @brief Checks if the profile sets any limit.
+     *
+     * @return true if there are no limits.
+     */
+    bool isEmpty() const { return memoryLimit == 0 && cpuTimeLimit == 0 && processLimit == 0; }
+
+    /*
+     * @brief converts a Violation to a std::string.
+     *
+     * @param violation the violation to convert.
+     *
+     * @return The string of the violation
+     */
+    static std::string violationToString(Violation violation) {
+        switch (violation) {
+        case MEMORY_LIMIT:
+            return "memory";
+        case CPU_LIMIT:
+            return "cpu";
+        case PROCESS_LIMIT:
+            return "processes";
+        default:
+            return "none";
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef RESOURCEUSAGE_H
+#define RESOURCEUSAGE_H
+
+#include <string>
+#include <format>
+#include <algorithm>
+
+/*
+ * @brief Struct describing the resources a child process consumed. Filled by Process::sampleUsage().
+ */
+struct ResourceUsage {
+    unsigned long long peakWorkingSet = 0;  //< peak resident memory in bytes
+    unsigned long long peakCommit = 0;      //< peak private committed memory in bytes, what the CodinGame 768 MB cap is checked against
+    unsigned long long userTime = 0;        //< user mode cpu time in microseconds
+    unsigned long long kernelTime = 0;      //< kernel mode cpu time in microseconds
+    unsigned long long pageFaults = 0;      //< page faults, soft and hard
+
+    /*
+     * @brief Folds a newer sample of the same process into this one. Every counter is monotonic, so the largest value wins.
+     *
+     * @param sample The newer sample.
+     */
+    void update(const ResourceUsage& sample) {
+        peakWorkingSet = std::max(peakWorkingSet, sample.peakWorkingSet);
+        peakCommit = std::max(peakCommit, sample.peakCommit);
+        userTime = std::max(userTime, sample.userTime);
+        kernelTime = std::max(kernelTime, sample.kernelTime);
+        pageFaults = std::max(pageFaults, sample.pageFaults);
+    }
+
+    /*
+     * @brief Formats the usage as space separated key=value pairs, as written to the results journal.
+     *
+     * @return the formatted usage.
+     */
+    std::string toString() const {
+        return std::format("rss={} commit={} user_us={} kernel_us={} faults={}", peakWorkingSet, peakCommit, userTime, kernelTime, pageFaults);
+    }
+};
+
+#endif
@@ -0,0 +1,206 @@
+#include "ResultCache.h"
+#include "ExePath.h"
+
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <bcrypt.h>
+
+#pragma comment(lib, "bcrypt.lib")
+
+/*
+ * @brief A running SHA-256, a thin wrapper over the CNG hash object.
+ */
+class Sha256 {
+private:
+    BCRYPT_ALG_HANDLE alg;      //< the algorithm provider
+    BCRYPT_HASH_HANDLE hash;    //< the hash object
+
+public:
+    Sha256() : alg{ NULL }, hash{ NULL } {
+        if (BCryptOpenAlgorithmProvider(&alg, BCRYPT_SHA256_ALGORITHM, NULL, 0) != 0) {
+            alg = NULL;
+            return;
+        }
+        if (BCryptCreateHash(alg, &hash, NULL, 0, NULL, 0, 0) != 0) {
+            hash = NULL;
+        }
+    }
+
+    ~Sha256() {
+        if (hash != NULL) BCryptDestroyHash(hash);
+        if (alg != NULL) BCryptCloseAlgorithmProvider(alg, 0);
+    }
+
+    bool isValid() const { return hash != NULL; }
+
+    bool add(std::string_view data) {
+        if (hash == NULL) return false;
+        return BCryptHashData(hash, (PUCHAR)data.data(), (ULONG)data.size(), 0) == 0;
+    }
+
+    std::string finish() {
+        unsigned char digest[32];
+        if (hash == NULL || BCryptFinishHash(hash, digest, sizeof(digest), 0) != 0) return "";
+
+        static const char hex[] = "0123456789abcdef";
+        std::string result;
+        result.reserve(64);
+        for (unsigned char byte : digest) {
+            result += hex[byte >> 4];
+            result += hex[byte & 0xF];
+        }
+        return result;
+    }
+};
+
+ResultCache::ResultCache() : enabled{ false }, hits{ 0 }, misses{ 0 } {}
+
+bool ResultCache::open(const std::string& directory, const std::string& refereeCmd, const std::vector<std::string>& playersCmd, const std::string& context) {
+    dir = ExePath::resolve(directory);
+
+    std::error_code error;
+    std::filesystem::create_directories(dir, error);
+    if (error) return false;
+
+    refresh();
+    if (commandHash(refereeCmd).empty()) return false;
+    for (const std::string& cmd : playersCmd) {
+        if (commandHash(cmd).empty()) return false;
+    }
+
+    this->context = context;
+    enabled = true;
+    return true;
+}
+
+void ResultCache::refresh() {
+    std::lock_guard<std::mutex> lock(m_hashes);
+    commandHashes.clear();
+    fileHashes.clear();
+}
+
+std::string ResultCache::commandHash(const std::string& cmd) {
+    std::lock_guard<std::mutex> lock(m_hashes);
+    auto found = commandHashes.find(cmd);
+    if (found != commandHashes.end()) return found->second;
+
+    //a bot is hashed once until refresh(), rebuilding it in between is not noticed
+    std::string hash = hashCommand(cmd);
+    if (!hash.empty()) commandHashes[cmd] = hash;
+    return hash;
+}
+
+std::string ResultCache::makeKey(const std::string& refereeCmd, const std::vector<std::string>& playersCmd, long long seed, int rotation) {
+    std::string refereeHash = commandHash(refereeCmd);
+    if (refereeHash.empty()) return "";
+
+    //players stay in their own order, the rotation then tells which one sits in which seat
+    std::string material = "referee " + refereeHash + "\n";
+    for (const std::string& cmd : playersCmd) {
+        std::string hash = commandHash(cmd);
+        if (hash.empty()) return "";
+        material += "player " + hash + "\n";
+    }
+    material += "seed " + std::to_string(seed) + "\n";
+    material += "rotation " + std::to_string(rotation) + "\n";
+    material += "context " + context + "\n";
+    return hashString(material);
+}
+
+std::filesystem::path ResultCache::keyPath(const std::string& key) const {
+    return dir / key.substr(0, 2) / key;
+}
+
+bool ResultCache::lookup(const std::string& key, std::string& outcome) {
+    if (!enabled || key.empty()) return false;
+
+    std::ifstream in(keyPath(key));
+    if (!in.is_open() || !std::getline(in, outcome) || outcome.empty()) {
+        misses++;
+        return false;
+    }
+    hits++;
+    return true;
+}
+
+void ResultCache::store(const std::string& key, std::string_view outcome) {
+    if (!enabled || key.empty()) return;
+
+    std::filesystem::path path = keyPath(key);
+    std::error_code error;
+    std::filesystem::create_directories(path.parent_path(), error);
+    if (error) return;
+
+    //a reader never sees half an outcome, and two threads writing the same key do not mix
+    std::ostringstream thread;
+    thread << std::this_thread::get_id();
+    std::filesystem::path temp = path;
+    temp += ".tmp" + thread.str();
+
+    {
+        std::ofstream out(temp, std::ofstream::out | std::ofstream::trunc);
+        if (!out.is_open()) return;
+        out << outcome << '\n';
+        if (out.fail()) {
+            out.close();
+            std::filesystem::remove(temp, error);
+            return;
+        }
+    }
+
+    std::filesystem::rename(temp, path, error);
+    if (error) std::filesystem::remove(temp, error);
+}
+
+std::string ResultCache::hashCommand(const std::string& command) {
+    Sha256 sha;
+    if (!sha.isValid()) return "";
+
+    std::filesystem::path base = ExePath::directory();
+
+    std::istringstream tokens(command);
+    std::string token;
+    while (tokens >> token) {
+        //Process::start runs the executable from next to the tester, arguments may be anywhere
+        std::error_code error;
+        std::filesystem::path file = base / token;
+        if (!std::filesystem::is_regular_file(file, error)) file = token;
+
+        if (std::filesystem::is_regular_file(file, error)) {
+            //a tuned bot shows up with a new command line every game, its binary is read once
+            std::string key = file.string();
+            auto found = fileHashes.find(key);
+            if (found == fileHashes.end()) {
+                std::string hash = hashFile(file);
+                if (hash.empty()) return "";
+                found = fileHashes.emplace(key, hash).first;
+            }
+            sha.add("file " + found->second);
+        }
+        else {
+            sha.add("text " + token);
+        }
+        sha.add("\n");
+    }
+    return sha.finish();
+}
+
+std::string ResultCache::hashFile(const std::filesystem::path& file) {
+    Sha256 sha;
+    std::ifstream in(file, std::ifstream::binary);
+    if (!sha.isValid() || !in.is_open()) return "";
+
+    std::vector<char> buffer(1 << 16);
+    while (in) {
+        in.read(buffer.data(), buffer.size());
+        if (in.gcount() > 0) sha.add(std::string_view(buffer.data(), (size_t)in.gcount()));
+    }
+    return sha.finish();
+}
+
+std::string ResultCache::hashString(std::string_view data) {
+    Sha256 sha;
+    if (!sha.add(data)) return "";
+    return sha.finish();
+}
@@ -0,0 +1,156 @@
+#ifndef RESULTCACHE_H
+#define RESULTCACHE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <filesystem>
+#include <windows.h>
+
+/*
+ * @brief Class describing the result cache, a content addressed directory of game outcomes shared by all game threads.
+ *
+ * A game is keyed by the SHA-256 of the referee, the players in seat order, the seed and the rotation. The referee
+ * and players are hashed by the content of every file in their command line, so a rebuilt bot gets fresh games
+ * while a renamed or copied one keeps its results. Only worth it for deterministic bots and a sent seed.
+ *
+ * Each outcome is one small file, <dir>/<first 2 hex>/<key>, written to a temp file first and renamed into place.
+ */
+class ResultCache {
+private:
+    std::filesystem::path dir;              //< the cache directory
+    std::unordered_map<std::string, std::string> commandHashes; //< hash of each referee or player command line seen so far
+    std::unordered_map<std::string, std::string> fileHashes;    //< hash of each file named in a command line so far
+    std::mutex m_hashes;                    //< Mutex protecting commandHashes and fileHashes.
+    std::string context;                    //< anything else changing the outcome, ex. the mode or the limits
+    bool enabled;                           //< is the cache open?
+
+    std::atomic<int> hits;                  //< lookups answered from the cache
+    std::atomic<int> misses;                //< lookups played for real
+
+    /*
+     * @brief Gets the hash of a referee or player command line, hashing it the first time.
+     *
+     * @param cmd the command line.
+     *
+     * @return the hash, empty on error.
+     */
+    std::string commandHash(const std::string& cmd);
+
+    /*
+     * @brief Hashes a command line: the content of each token naming a file next to the executable, the text of the others.
+     * Each file is read once, lock m_hashes first once the game threads run.
+     *
+     * @param command the command line.
+     *
+     * @return the hash, 64 hex chars, empty on error.
+     */
+    std::string hashCommand(const std::string& command);
+
+    /*
+     * @brief Gets the file of a key.
+     *
+     * @param key the key.
+     *
+     * @return the path.
+     */
+    std::filesystem::path keyPath(const std::string& key) const;
+
+public:
+    /*
+     * @brief Constructs a closed ResultCache object.
+     */
+    ResultCache();
+
+    /*
+     * @brief Opens the cache directory next to the executable, creating it if needed, and hashes the command lines.
+     *
+     * @param directory the cache directory.
+     * @param refereeCmd the referee command line, hashed now so a missing file shows up right away.
+     * @param playersCmd the players command lines, the same.
+     * @param context anything else changing the outcome, ex. the mode or the limits.
+     *
+     * @return success true or false.
+     */
+    bool open(const std::string& directory, const std::string& refereeCmd, const std::vector<std::string>& playersCmd, const std::string& context);
+
+    /*
+     * @brief Checks if the cache is open.
+     *
+     * @return true if open.
+     */
+    bool isOpen() const { return enabled; }
+
+    /*
+     * @brief Forgets every hash, the files are read again the next time a command line is keyed. Thread safe.
+     * For runs outliving a build of a bot or a referee.
+     */
+    void refresh();
+
+    /*
+     * @brief Makes the key of one game. Thread safe.
+     *
+     * @param refereeCmd the referee command line.
+     * @param playersCmd the players command lines, in player order.
+     * @param seed the seed sent to the referee.
+     * @param rotation how far the players are rotated.
+     *
+     * @return the key, 64 hex chars, empty if a player cannot be hashed.
+     */
+    std::string makeKey(const std::string& refereeCmd, const std::vector<std::string>& playersCmd, long long seed, int rotation);
+
+    /*
+     * @brief Looks a game up. Thread safe.
+     *
+     * @param key the key from makeKey().
+     * @param outcome Set to the stored outcome on a hit.
+     *
+     * @return true on a hit.
+     */
+    bool lookup(const std::string& key, std::string& outcome);
+
+    /*
+     * @brief Stores the outcome of a game. Thread safe, the last writer wins.
+     *
+     * @param key the key from makeKey().
+     * @param outcome the outcome, one line.
+     */
+    void store(const std::string& key, std::string_view outcome);
+
+    /*
+     * @brief Gets the number of hits.
+     *
+     * @return the hits.
+     */
+    int getHits() const { return hits; }
+
+    /*
+     * @brief Gets the number of misses.
+     *
+     * @return the misses.
+     */
+    int getMisses() const { return misses; }
+
+    /*
+     * @brief Hashes the content of a file.
+     *
+     * @param file the file.
+     *
+     * @return the hash, 64 hex chars, empty on error.
+     */
+    static std::string hashFile(const std::filesystem::path& file);
+
+    /*
+     * @brief Hashes a string.
+     *
+     * @param data the string.
+     *
+     * @return the hash, 64 hex chars, empty on error.
+     */
+    static std::string hashString(std::string_view data);
+};
+
+#endif
@@ -0,0 +1,100 @@
+#include <algorithm>
+#include "ResultParser.h"
+
+ResultParser::ResultParser(int playersCount)
+    :playersCount{ playersCount }, scores(playersCount, 0), scoresRead{ 0 }, dropped{ 0 } {
+    partial.reserve(MAX_LINE);
+    summary.reserve(MAX_BLOCK);
+    data.reserve(MAX_BLOCK);
+}
+
+void ResultParser::reset() {
+    std::fill(scores.begin(), scores.end(), 0);
+    scoresRead = 0;
+    partial.clear();
+    summary.clear();
+    data.clear();
+    dropped = 0;
+}
+
+void ResultParser::feed(std::string_view chunk) {
+    while (!chunk.empty()) {
+        size_t end = chunk.find('\n');
+        if (end == std::string_view::npos) {
+            //the rest of the line comes with the next chunk
+            append(partial, chunk, MAX_LINE);
+            return;
+        }
+
+        if (partial.empty()) {
+            addLine(chunk.substr(0, end));
+        }
+        else {
+            append(partial, chunk.substr(0, end), MAX_LINE);
+            addLine(partial);
+            partial.clear();
+        }
+        chunk.remove_prefix(end + 1);
+    }
+}
+
+void ResultParser::finish() {
+    if (!partial.empty()) {
+        addLine(partial);
+        partial.clear();
+    }
+}
+
+void ResultParser::addLine(std::string_view line) {
+    if (line.ends_with('\r')) line.remove_suffix(1);
+
+    if (scoresRead < playersCount) {
+        int score;
+        if (parseScore(line, score)) {
+            scores[scoresRead++] = score;
+        }
+        else {
+            append(summary, line, MAX_BLOCK);
+            append(summary, "\n", MAX_BLOCK);
+        }
+    }
+    else {
+        append(data, line, MAX_BLOCK);
+        append(data, "\n", MAX_BLOCK);
+    }
+}
+
+void ResultParser::append(std::string& buffer, std::string_view text, size_t cap) {
+    size_t room = cap - buffer.size();
+    if (text.size() > room) {
+        dropped += text.size() - room;
+        text = text.substr(0, room);
+    }
+    buffer.append(text);
+}
+
+bool ResultParser::parseScore(std::string_view line, int& score) {
+    size_t start = line.find_first_not_of(' ');
+    size_t end = line.find_last_not_of(' ');
+    if (start == std::string_view::npos) {
+        return false;
+    }
+    line = line.substr(start, end - start + 1);
+
+    bool negative = line[0] == '-';
+    if (negative) line.remove_prefix(1);
+    //more than 9 digits could overflow an int
+    if (line.empty() || line.size() > 9) {
+        return false;
+    }
+
+    int value = 0;
+    for (char c : line) {
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        value = value * 10 + (c - '0');
+    }
+    score = negative ? -value : value;
+    return true;
+}
@@ -0,0 +1,122 @@
+#ifndef RESULTPARSER_H
+#define RESULTPARSER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+ * @brief Class describing the parser of a new mode referee's stdout: one score line per player, with the referee's
+ *        tooltips and summaries mixed in, then the data block that replays the game.
+ *
+ * The output is fed as it is read, in chunks of any size, so lines may be cut anywhere. The scores are there as
+ * soon as the referee prints them. The buffers are allocated once and capped, a chatty referee cannot grow them.
+ */
+class ResultParser {
+private:
+    const static size_t MAX_LINE = 4096;        //< longer lines are cut
+    const static size_t MAX_BLOCK = 65536;      //< cap of the summary and of the data block
+
+    int playersCount;                           //< the number of scores expected
+    std::vector<int> scores;                    //< the scores, in the referee's player order
+    int scoresRead;                             //< the number of scores read so far
+    std::string partial;                        //< the start of a line cut by the end of a chunk
+    std::string summary;                        //< the lines among the scores
+    std::string data;                           //< the lines after the scores
+    size_t dropped;                             //< the number of bytes over the caps
+
+    /*
+     * @brief Handles one complete line.
+     *
+     * @param line the line, without the line break.
+     */
+    void addLine(std::string_view line);
+
+    /*
+     * @brief Appends to a capped buffer, counting what does not fit.
+     *
+     * @param buffer the buffer.
+     * @param text the text to append.
+     * @param cap the max size of the buffer.
+     */
+    void append(std::string& buffer, std::string_view text, size_t cap);
+
+    /*
+     * @brief Parses a score line, a lone integer.
+     *
+     * @param line the line.
+     * @param score Set to the score.
+     *
+     * @return true if the line is a score.
+     */
+    static bool parseScore(std::string_view line, int& score);
+
+public:
+    /*
+     * @brief Constructs a ResultParser object.
+     *
+     * @param playersCount the number of players in a game.
+     */
+    ResultParser(int playersCount);
+
+    /*
+     * @brief Gets ready for the next game. Keeps the buffers.
+     */
+    void reset();
+
+    /*
+     * @brief Parses the next chunk of the referee's output.
+     *
+     * @param chunk the chunk, cut anywhere.
+     */
+    void feed(std::string_view chunk);
+
+    /*
+     * @brief Ends the output, a last line without a line break still counts.
+     */
+    void finish();
+
+    /*
+     * @brief Checks if every player's score was read.
+     *
+     * @return true if the scores are complete.
+     */
+    bool hasScores() const { return scoresRead == playersCount; }
+
+    /*
+     * @brief Gets the scores, in the referee's player order. Missing scores are 0.
+     *
+     * @return the scores.
+     */
+    const std::vector<int>& getScores() const { return scores; }
+
+    /*
+     * @brief Gets the number of scores read so far.
+     *
+     * @return the number of scores.
+     */
+    int getScoresRead() const { return scoresRead; }
+
+    /*
+     * @brief Gets the tooltips, summaries and other lines the referee printed among the scores.
+     *
+     * @return the lines, each one ending with a line break.
+     */
+    const std::string& getSummary() const { return summary; }
+
+    /*
+     * @brief Gets the data block printed after the scores, what the referee needs to replay the game.
+     *
+     * @return the lines, each one ending with a line break.
+     */
+    const std::string& getData() const { return data; }
+
+    /*
+     * @brief Gets the number of bytes thrown away because a line or block was over its cap.
+     *
+     * @return the number of bytes.
+     */
+    size_t getDropped() const { return dropped; }
+};
+
+#endif
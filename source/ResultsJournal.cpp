@@ -0,0 +1,44 @@
+#include "ResultsJournal.h"
+#include "ExePath.h"
+
+ResultsJournal::ResultsJournal() {}
+
+ResultsJournal::~ResultsJournal() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (out.is_open()) out.close();
+}
+
+bool ResultsJournal::open(const std::string& dir, const std::string& file) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::filesystem::path path = ExePath::resolve(dir) / file;
+
+    out.open(path, std::ofstream::out | std::ofstream::app);
+    return !out.fail();
+}
+
+bool ResultsJournal::isOpen() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return out.is_open();
+}
+
+void ResultsJournal::addRecord(int game, std::string_view type, std::string_view data) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!out.is_open()) return;
+
+    //one line per record, flushed so a crashed run keeps every finished game
+    out << game << '\t' << type << '\t' << data << '\n';
+    out.flush();
+}
+
+void ResultsJournal::addRecords(int game, const std::vector<std::pair<std::string, std::string> >& records) {
+    if (records.empty()) return;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!out.is_open()) return;
+
+    //the game threads wait on the mutex, so they wait on one flush, not one per record
+    for (const auto& record : records) {
+        out << game << '\t' << record.first << '\t' << record.second << '\n';
+    }
+    out.flush();
+}
@@ -0,0 +1,69 @@
+#ifndef RESULTSJOURNAL_H
+#define RESULTSJOURNAL_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+#include <fstream>
+#include <mutex>
+#include <filesystem>
+#include <windows.h>
+
+/*
+ * @brief Class describing the results journal, an append only file of per game records shared by all game threads.
+ *
+ * Every record is one line: the game number, a record type and the data, separated by tabs.
+ * A journal that was never opened silently drops records, so callers do not have to check for -d.
+ */
+class ResultsJournal {
+private:
+    std::ofstream out;              //< the journal file
+    mutable std::mutex m_mutex;     //< Mutex serializing writes from the game threads.
+
+public:
+    /*
+     * @brief Constructs a closed ResultsJournal object.
+     */
+    ResultsJournal();
+
+    /*
+     * @brief Destructs the ResultsJournal object, flushing and closing the file.
+     */
+    ~ResultsJournal();
+
+    /*
+     * @brief Opens the journal for appending. Relative directories are resolved next to the executable, like the logs.
+     *
+     * @param dir The log directory.
+     * @param file The journal file name.
+     * @return true if the file was opened, false otherwise.
+     */
+    bool open(const std::string& dir, const std::string& file);
+
+    /*
+     * @brief Checks if the journal is open.
+     *
+     * @return true or false.
+     */
+    bool isOpen() const;
+
+    /*
+     * @brief Appends a record to the journal.
+     *
+     * @param game The game number.
+     * @param type The record type, ex. "result" or "usage p1".
+     * @param data The record data.
+     */
+    void addRecord(int game, std::string_view type, std::string_view data);
+
+    /*
+     * @brief Appends a game's records to the journal at once, with a single flush.
+     *
+     * @param game The game number.
+     * @param records The records, each its type and data.
+     */
+    void addRecords(int game, const std::vector<std::pair<std::string, std::string> >& records);
+};
+
+#endif
@@ -0,0 +1,37 @@
+#include "Scheduler.h"
+
+#include <fstream>
+#include <cmath>
+#include <algorithm>
+
+bool Scheduler::readPool(const std::string& file, std::vector<std::string>& pool) {
+    std::ifstream in(file);
+    if (!in.is_open()) return false;
+
+    std::string line;
+    while (std::getline(in, line)) {
+        //trim, the file may come from any editor
+        size_t start = line.find_first_not_of(" \t\r");
+        size_t end = line.find_last_not_of(" \t\r");
+        if (start == std::string::npos || line[start] == '#') continue;
+        pool.push_back(line.substr(start, end - start + 1));
+    }
+    return true;
+}
+
+void Scheduler::wilson(double score, int games, double& low, double& high) {
+    if (games <= 0) {
+        low = 0.0;
+        high = 1.0;
+        return;
+    }
+
+    const double z = 1.96;
+    double n = (double)games;
+    double p = score / n;
+    double denominator = 1.0 + z * z / n;
+    double center = (p + z * z / (2.0 * n)) / denominator;
+    double half = z * std::sqrt(p * (1.0 - p) / n + z * z / (4.0 * n * n)) / denominator;
+    low = std::max(0.0, center - half);
+    high = std::min(1.0, center + half);
+}
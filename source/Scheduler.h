@@ -0,0 +1,75 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <string>
+#include <vector>
+
+/*
+ * @brief Struct describing one game handed out by a Scheduler: who plays, on which seed and in which seats.
+ */
+struct GameOrder {
+    int game = 0;                           //< the game number, for the logs and the journal
+    std::vector<std::string> players;       //< the players command lines, in player order
+    std::string referee;                    //< the referee command line, empty for the run's own
+    long long seed = 0;                     //< the seed to send the referee
+    int rotation = 0;                       //< how far the players are rotated, player i sits in seat (i - rotation) mod players
+    int tag = 0;                            //< for the scheduler's own use, ex. the matchup
+};
+
+/*
+ * @brief Class describing a Scheduler, picking the games of a run one at a time instead of replaying one lineup n times.
+ *
+ * The game threads ask for the next game with next() and hand the outcome back with report(). Both are called from every
+ * game thread, so implementations lock. A Scheduler is free to pick each game from the results so far.
+ */
+class Scheduler {
+public:
+    /*
+     * @brief Destructs the Scheduler object.
+     */
+    virtual ~Scheduler() {}
+
+    /*
+     * @brief Picks the next game.
+     *
+     * @param order Set to the game.
+     *
+     * @return false if there is nothing left to play, the calling thread then ends.
+     */
+    virtual bool next(GameOrder& order) = 0;
+
+    /*
+     * @brief Hands the outcome of a game back.
+     *
+     * @param order the game, as given by next().
+     * @param scores the score of each player in player order, higher is better. Empty if the game failed.
+     */
+    virtual void report(const GameOrder& order, const std::vector<int>& scores) = 0;
+
+    /*
+     * @brief Prints the results of the run.
+     */
+    virtual void print() = 0;
+
+    /*
+     * @brief Reads a pool of bots, one command line per line. Empty lines and lines starting with # are skipped.
+     *
+     * @param file the file.
+     * @param pool Filled with the command lines.
+     *
+     * @return success true or false.
+     */
+    static bool readPool(const std::string& file, std::vector<std::string>& pool);
+
+    /*
+     * @brief Gets the 95% Wilson score interval of a score rate.
+     *
+     * @param score the points, a win counting 1 and a draw 0.5.
+     * @param games the number of games.
+     * @param low Set to the lower bound.
+     * @param high Set to the upper bound.
+     */
+    static void wilson(double score, int games, double& low, double& high);
+};
+
+#endif
@@ -0,0 +1,264 @@
+#ifndef SHMCHANNEL_H
+#define SHMCHANNEL_H
+
+/*
+ * The shared memory channel between the tester and a bot, two single producer single consumer rings in a named
+ * file mapping, plus a named event for each direction to wake up a sleeping reader.
+ *
+ * The tester advertises the channel in the CG_BRUTAL_SHM environment variable of each player when run with -shm.
+ * This header is all a C++ bot needs to use it, copy it next to the bot and:
+ *
+ *   shm::Client channel;
+ *   bool shared = channel.open();          // false: not run by the tester with -shm, use std::cin/std::cout
+ *   std::string line;
+ *   while (shared ? channel.readLine(line) : (bool)std::getline(std::cin, line)) {
+ *       ...
+ *       if (shared) channel.writeLine(action); else std::cout << action << std::endl;
+ *   }
+ *
+ * Open the channel before reading or writing anything else. Whatever the tester wrote on stdin before the bot opened
+ * the channel is read from stdin first, so no input is lost either way.
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <windows.h>
+
+namespace shm {
+    const char* const ENV_NAME = "CG_BRUTAL_SHM";      //< environment variable holding the name of the mapping
+    const char* const IN_SUFFIX = "-in";                //< name suffix of the event signaling input for the bot
+    const char* const OUT_SUFFIX = "-out";              //< name suffix of the event signaling output from the bot
+    const uint32_t MAGIC = 0x4D485342;                  //< "BSHM"
+    const uint32_t VERSION = 1;                         //< bump on any change to the layout
+    const uint32_t RING_SIZE = 1 << 16;                 //< bytes in each ring, a power of 2
+    const uint64_t ATTACHED = 1ull << 63;               //< bit of Header::state set once the bot uses the rings
+    const int SPIN = 4000;                              //< polls of an empty ring before sleeping on its event
+
+    /*
+     * @brief Struct describing a single producer single consumer byte ring. The counters only grow, wrapping at 2^32.
+     */
+    struct Ring {
+        alignas(64) std::atomic<uint32_t> head;         //< bytes written so far, moved by the producer only
+        alignas(64) std::atomic<uint32_t> tail;         //< bytes read so far, moved by the consumer only
+        alignas(64) char data[RING_SIZE];               //< the bytes
+    };
+
+    /*
+     * @brief Struct describing the whole mapping.
+     */
+    struct Header {
+        uint32_t magic;                                 //< MAGIC
+        uint32_t version;                               //< VERSION
+        std::atomic<uint64_t> state;                    //< ATTACHED, and below it the bytes the tester sent on stdin before
+        std::atomic<uint32_t> closed;                   //< set by the tester once the game is over
+        Ring toBot;                                     //< the bot's input
+        Ring fromBot;                                   //< the bot's output
+    };
+
+    /*
+     * @brief Writes as much as fits into a ring.
+     *
+     * @param ring the ring, this side must be its only producer.
+     * @param data the bytes.
+     * @param length the number of bytes.
+     *
+     * @return the number of bytes written.
+     */
+    inline size_t ringWrite(Ring& ring, const char* data, size_t length) {
+        uint32_t head = ring.head.load(std::memory_order_relaxed);
+        uint32_t tail = ring.tail.load(std::memory_order_acquire);
+        size_t room = RING_SIZE - (head - tail);
+        size_t count = length < room ? length : room;
+
+        size_t offset = head & (RING_SIZE - 1);
+        size_t first = count < RING_SIZE - offset ? count : RING_SIZE - offset;
+        memcpy(ring.data + offset, data, first);
+        memcpy(ring.data, data + first, count - first);
+
+        ring.head.store(head + (uint32_t)count, std::memory_order_release);
+        return count;
+    }
+
+    /*
+     * @brief Appends everything in a ring to a buffer.
+     *
+     * @param ring the ring, this side must be its only consumer.
+     * @param buffer the buffer.
+     *
+     * @return the number of bytes read.
+     */
+    inline size_t ringRead(Ring& ring, std::string& buffer) {
+        uint32_t tail = ring.tail.load(std::memory_order_relaxed);
+        uint32_t head = ring.head.load(std::memory_order_acquire);
+        size_t count = head - tail;
+
+        size_t offset = tail & (RING_SIZE - 1);
+        size_t first = count < RING_SIZE - offset ? count : RING_SIZE - offset;
+        buffer.append(ring.data + offset, first);
+        buffer.append(ring.data, count - first);
+
+        ring.tail.store(tail + (uint32_t)count, std::memory_order_release);
+        return count;
+    }
+
+    /*
+     * @brief Class describing the bot's end of the channel.
+     */
+    class Client {
+    private:
+        HANDLE mapping = NULL;                          //< the file mapping
+        HANDLE inEvent = NULL;                          //< signaled by the tester when there is input
+        HANDLE outEvent = NULL;                         //< signaled by us when there is output
+        Header* header = nullptr;                       //< the mapped channel
+        uint64_t stdinBytes = 0;                        //< input still to read from stdin, sent before we attached
+        std::string input;                              //< input read, not consumed yet from start on
+        size_t start = 0;                               //< start of the unconsumed input
+        std::string output;                             //< reused to add the line break to a line
+
+        /*
+         * @brief Reads more input, waiting for it if there is none.
+         *
+         * @return false once the tester closed the channel and the input is over.
+         */
+        bool fill() {
+            if (stdinBytes > 0) {
+                char chunk[4096];
+                DWORD length = (DWORD)(stdinBytes < sizeof(chunk) ? stdinBytes : sizeof(chunk));
+                DWORD bytesRead = 0;
+                if (!ReadFile(GetStdHandle(STD_INPUT_HANDLE), chunk, length, &bytesRead, NULL) || bytesRead == 0) {
+                    return false;
+                }
+                input.append(chunk, bytesRead);
+                stdinBytes -= bytesRead;
+                return true;
+            }
+
+            //spin a little first, the input usually comes right after our output
+            for (int spin = 0; ; ++spin) {
+                if (ringRead(header->toBot, input) > 0) {
+                    return true;
+                }
+                if (header->closed.load(std::memory_order_acquire) != 0) {
+                    return ringRead(header->toBot, input) > 0;
+                }
+                if (spin < SPIN) {
+                    YieldProcessor();
+                }
+                else {
+                    WaitForSingleObject(inEvent, INFINITE);
+                }
+            }
+        }
+
+    public:
+        /*
+         * @brief Destructs the Client object, closing the channel.
+         */
+        ~Client() { close(); }
+
+        /*
+         * @brief Opens the channel the tester advertised.
+         *
+         * @return false if there is none, then use stdin and stdout.
+         */
+        bool open() {
+            char name[MAX_PATH];
+            DWORD length = GetEnvironmentVariableA(ENV_NAME, name, MAX_PATH);
+            if (length == 0 || length >= MAX_PATH) {
+                return false;
+            }
+
+            mapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name);
+            if (mapping != NULL) {
+                header = static_cast<Header*>(MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(Header)));
+            }
+            inEvent = OpenEventA(SYNCHRONIZE, FALSE, (std::string(name) + IN_SUFFIX).c_str());
+            outEvent = OpenEventA(EVENT_MODIFY_STATE, FALSE, (std::string(name) + OUT_SUFFIX).c_str());
+            if (header == nullptr || inEvent == NULL || outEvent == NULL || header->magic != MAGIC || header->version != VERSION) {
+                close();
+                return false;
+            }
+
+            //from now on the tester writes to the ring, what it wrote on stdin before is read first
+            stdinBytes = header->state.fetch_or(ATTACHED) & ~ATTACHED;
+            return true;
+        }
+
+        /*
+         * @brief Closes the channel.
+         */
+        void close() {
+            if (header != nullptr) UnmapViewOfFile(header);
+            if (mapping != NULL) CloseHandle(mapping);
+            if (inEvent != NULL) CloseHandle(inEvent);
+            if (outEvent != NULL) CloseHandle(outEvent);
+            header = nullptr;
+            mapping = inEvent = outEvent = NULL;
+        }
+
+        /*
+         * @brief Reads the next line of input, without the line break.
+         *
+         * @param line Set to the line.
+         *
+         * @return false once the input is over.
+         */
+        bool readLine(std::string& line) {
+            while (true) {
+                size_t end = input.find('\n', start);
+                if (end != std::string::npos) {
+                    line.assign(input, start, end - start);
+                    start = end + 1;
+                    return true;
+                }
+                input.erase(0, start);
+                start = 0;
+                if (!fill()) {
+                    return false;
+                }
+            }
+        }
+
+        /*
+         * @brief Writes output to the tester.
+         *
+         * @param data the bytes.
+         *
+         * @return false if the tester closed the channel.
+         */
+        bool write(std::string_view data) {
+            while (!data.empty()) {
+                size_t written = ringWrite(header->fromBot, data.data(), data.size());
+                if (written > 0) {
+                    SetEvent(outEvent);
+                    data.remove_prefix(written);
+                }
+                else if (header->closed.load(std::memory_order_acquire) != 0) {
+                    return false;
+                }
+                else {
+                    SwitchToThread();
+                }
+            }
+            return true;
+        }
+
+        /*
+         * @brief Writes a line of output to the tester, the line break is added.
+         *
+         * @param line the line, without a line break.
+         *
+         * @return false if the tester closed the channel.
+         */
+        bool writeLine(std::string_view line) {
+            output.assign(line);
+            output += '\n';
+            return write(output);
+        }
+    };
+}
+
+#endif
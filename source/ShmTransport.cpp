@@ -0,0 +1,82 @@
+#include "ShmTransport.h"
+#include <new>
+#include <chrono>
+
+ShmTransport::ShmTransport() : mapping{ NULL }, inEvent{ NULL }, outEvent{ NULL }, header{ nullptr } {}
+
+ShmTransport::~ShmTransport() {
+    close();
+}
+
+bool ShmTransport::create(const std::string& name) {
+    this->name = name;
+
+    //backed by the paging file, zeroed by the system
+    mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, sizeof(shm::Header), name.c_str());
+    if (mapping == NULL) {
+        return false;
+    }
+    void* view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(shm::Header));
+    inEvent = CreateEventA(NULL, FALSE, FALSE, (name + shm::IN_SUFFIX).c_str());
+    outEvent = CreateEventA(NULL, FALSE, FALSE, (name + shm::OUT_SUFFIX).c_str());
+    if (view == nullptr || inEvent == NULL || outEvent == NULL) {
+        if (view != nullptr) UnmapViewOfFile(view);
+        close();
+        return false;
+    }
+
+    header = new (view) shm::Header();
+    header->magic = shm::MAGIC;
+    header->version = shm::VERSION;
+    return true;
+}
+
+void ShmTransport::close() {
+    if (header != nullptr) {
+        header->closed.store(1, std::memory_order_release);
+        SetEvent(inEvent);
+        UnmapViewOfFile(header);
+        header = nullptr;
+    }
+    for (HANDLE* handle : { &mapping, &inEvent, &outEvent }) {
+        if (*handle != NULL) CloseHandle(*handle);
+        *handle = NULL;
+    }
+}
+
+bool ShmTransport::isAttached() const {
+    return header != nullptr && (header->state.load(std::memory_order_acquire) & shm::ATTACHED) != 0;
+}
+
+bool ShmTransport::claimPipe(size_t length) {
+    //one word for both, so the bot attaching and us counting can never miss each other
+    uint64_t state = header->state.load(std::memory_order_acquire);
+    while ((state & shm::ATTACHED) == 0) {
+        if (header->state.compare_exchange_weak(state, state + length, std::memory_order_acq_rel)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ShmTransport::write(std::string_view data) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(WRITE_TIMEOUT);
+    while (!data.empty()) {
+        size_t written = shm::ringWrite(header->toBot, data.data(), data.size());
+        if (written > 0) {
+            SetEvent(inEvent);
+            data.remove_prefix(written);
+        }
+        else if (std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        else {
+            SwitchToThread();
+        }
+    }
+    return true;
+}
+
+size_t ShmTransport::read(std::string& buffer) {
+    return shm::ringRead(header->fromBot, buffer);
+}
@@ -0,0 +1,103 @@
+#ifndef SHMTRANSPORT_H
+#define SHMTRANSPORT_H
+
+#include <string>
+#include <string_view>
+#include <windows.h>
+#include "ShmChannel.h"
+
+/*
+ * @brief Class describing the tester's end of a player's shared memory channel, see ShmChannel.h.
+ *
+ * The channel is created with the player. Until the bot opens it, the player is talked to over its pipes as usual,
+ * so bots that do not know about it keep working.
+ */
+class ShmTransport {
+private:
+    const static DWORD WRITE_TIMEOUT = 1000;    //< ms to wait for room in a full ring before giving up on the bot
+
+    std::string name;                   //< the name of the mapping, the events add a suffix
+    HANDLE mapping;                     //< the file mapping
+    HANDLE inEvent;                     //< signaled by us when there is input for the bot
+    HANDLE outEvent;                    //< signaled by the bot when there is output
+    shm::Header* header;                //< the mapped channel
+
+public:
+    /*
+     * @brief Constructs an empty ShmTransport object.
+     */
+    ShmTransport();
+
+    /*
+     * @brief Destructs the ShmTransport object, closing the channel.
+     */
+    ~ShmTransport();
+
+    ShmTransport(const ShmTransport&) = delete;
+    ShmTransport& operator=(const ShmTransport&) = delete;
+
+    /*
+     * @brief Creates the mapping and its events.
+     *
+     * @param name the name of the mapping, unique on the machine.
+     *
+     * @return success true or false.
+     */
+    bool create(const std::string& name);
+
+    /*
+     * @brief Tells the bot the game is over and closes our end. The bot's own handles keep the memory alive.
+     */
+    void close();
+
+    /*
+     * @brief Gets the name to advertise to the bot.
+     *
+     * @return the name of the mapping.
+     */
+    const std::string& getName() const { return name; }
+
+    /*
+     * @brief Checks if the bot opened the channel.
+     *
+     * @return true if the bot reads and writes through the rings.
+     */
+    bool isAttached() const;
+
+    /*
+     * @brief Reserves bytes to send on the bot's stdin, as long as it did not open the channel. Counted so the bot
+     *        knows how much to read from stdin when it opens the channel.
+     *
+     * @param length the number of bytes about to be written on stdin.
+     *
+     * @return true if they must go on stdin, false if the bot is attached and they must go through write().
+     */
+    bool claimPipe(size_t length);
+
+    /*
+     * @brief Writes the bot's input to its ring and wakes it up.
+     *
+     * @param data the bytes.
+     *
+     * @return false if the ring stayed full for WRITE_TIMEOUT.
+     */
+    bool write(std::string_view data);
+
+    /*
+     * @brief Appends the bot's output to a buffer, without waiting.
+     *
+     * @param buffer the buffer.
+     *
+     * @return the number of bytes read.
+     */
+    size_t read(std::string& buffer);
+
+    /*
+     * @brief Gets the event the bot signals when it writes output.
+     *
+     * @return the event.
+     */
+    HANDLE getOutEvent() const { return outEvent; }
+};
+
+#endif
@@ -0,0 +1,29 @@
+#include "StringUtils.h"
+
+int StringUtils::toInteger(std::string_view s) {
+    int result = 0;
+    for (char c : s) {
+        result = result * 10 + static_cast<int>(c) - static_cast<int>('0');
+    }
+    return result;
+}
+
+int StringUtils::toInteger(char c) {
+    std::string_view s(&c, 1);
+    return toInteger(s);
+}
+
+std::vector<std::string_view> StringUtils::splitString(std::string_view str, char delimiter) {
+    std::vector<std::string_view> result;
+    std::size_t start = 0;
+    while (start < str.size()) {
+        std::size_t end = str.find(delimiter, start);
+        if (end == std::string_view::npos) {
+            result.emplace_back(str.substr(start));
+            break;
+        }
+        result.emplace_back(str.substr(start, end - start));
+        start = end + 1;
+    }
+    return result;
+}
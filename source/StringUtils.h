@@ -0,0 +1,60 @@
+#ifndef STRINGUTILS_H
+#define STRINGUTILS_H
+
+#include <vector>
+#include <string>
+#include <string_view>
+
+/*
+ * @brief Class describing the string helpers of the game threads, on their own so the benchmarks time the same code.
+ */
+class StringUtils {
+public:
+    /*
+     * @brief Converts a string to an integer.
+     *
+     * @param s The string.
+     * @return an integer
+     */
+    static int toInteger(std::string_view s);
+
+    /*
+     * @brief Converts a char to an integer.
+     *
+     * @param c The char.
+     * @return an integer
+     */
+    static int toInteger(char c);
+
+    /*
+     * @brief Splits a string at delimeter.
+     *
+     * @param str The string.
+     * @param delimeter The delimeter.
+     * @return a std::vector of the strings
+     */
+    static std::vector<std::string_view> splitString(std::string_view str, char delimiter);
+
+    template <typename T>
+    /*
+     * @brief Joins a std::vector<string> or std::vector<string_view> with a std::string or std::string_view delimeter (" " or ", " for example) 
+     *
+     * @param strings The string or string_view vector.
+     * @param begin std::vector<string or string_view>::iterator where to begin
+     * @param end std::vector<string or string_view>::iterator where to end
+     * @param delimeter The delimeter.
+     * @return a std::string or string_view
+     */
+    static T joinString(const std::vector<T>& strings, typename std::vector<T>::const_iterator begin, typename std::vector<T>::const_iterator end, T delimiter) {
+        T str{};
+
+        for (typename std::vector<T>::const_iterator& it = begin; it != end; ++it) {
+            str += *it;
+            if (it + 1 != end) str += delimiter;
+        }
+
+        return str;
+    }
+};
+
+#endif
@@ -1,91 +1,260 @@
-#include "ThreadedGame.h"
-
-ThreadedGame::ThreadedGame(int id, std::string refereeCmd, std::vector<std::string> playersCmd, Mutable<int>& count, Mutable<PlayerStats>& playerStats, Mutable<SeedGenerator>& seeder, int n, bool swap, Level verbose, std::string path, std::string file)
-	:Threadable{ }, count{ count }, playerStats{ playerStats }, seeder{ seeder }, n{ n }, swap{ swap }, game{ 0 }, playersCount{ (int)playersCmd.size() },
-	refereeCmd{ refereeCmd }, playersCmd{ playersCmd }, verbose{ verbose }, path{ path }, file{ file }, logger{ Logger(verbose) }, rotate{ 0 } {
-	players.reserve(playersCount);
-	logger.setOutputPath(path);
-	logger.setOutputFile(file);
-}
-
-ThreadedGame::~ThreadedGame() {
-	// Delete vector objects
-	seedRotate.clear();
-	players.clear();
-	playersCmd.clear();
-}
-
-Logger& ThreadedGame::getLog() { return logger; }
-
-void ThreadedGame::start() {
-	// Call the start function in Threadable
-	logger.addLog(Level::VERBOSE, "Threaded game, starting thread.");
-	Threadable::start();
-}
-
-void ThreadedGame::log(Level v, std::string message) {
-	this->logString = "[Game " + std::to_string(game) + "] ";
-	logString += message;
-	logger.addLog(v, logString);
-}
-
-void ThreadedGame::clearErrorStream(HANDLE& handle, std::string prefix) {
-	DWORD bytesAvail = 0;
-	while (PeekNamedPipe(handle, NULL, 0, NULL, &bytesAvail, NULL)) {
-		std::string line;
-		char buffer[Process::BUFSIZE + 1]{};
-		DWORD bytesRead;
-		if (!ReadFile(handle, buffer, Process::BUFSIZE, &bytesRead, NULL))
-		logger.addLog(Level::ERR, prefix + buffer);
-	}
-}
-
-bool ThreadedGame::hasNextInt(HANDLE& handle) {
-	DWORD dwRead;
-	char c;
-	PeekNamedPipe(handle, &c, 1, &dwRead, NULL, NULL);
-	return isdigit(c);
-}
-
-bool ThreadedGame::hasNext(HANDLE& handle) {
-	DWORD dwRead;
-	char c;
-	PeekNamedPipe(handle, &c, 1, &dwRead, NULL, NULL);
-	return c != EOF;
-}
-
-bool ThreadedGame::hasNextLine(HANDLE& handle) {
-	DWORD dwRead;
-	char c;
-	PeekNamedPipe(handle, &c, 1, &dwRead, NULL, NULL);
-	return c != EOF && c != '\n';
-}
-
-
-int ThreadedGame::toInteger(std::string_view s) {
-	int result = 0;
-	for (char c : s) {
-		result = result * 10 + static_cast<int>(c) - static_cast<int>('0');
-	}
-	return result;
-}
-
-int ThreadedGame::toInteger(char c) {
-	std::string_view s(&c, 1);
-	return toInteger(s);
-}
-
-std::vector<std::string_view> ThreadedGame::splitString(std::string_view str, char delimiter) {
-	std::vector<std::string_view> result;
-	std::size_t start = 0;
-	while (start < str.size()) {
-		std::size_t end = str.find(delimiter, start);
-		if (end == std::string_view::npos) {
-			result.emplace_back(str.substr(start));
-			break;
-		}
-		result.emplace_back(str.substr(start, end - start));
-		start = end + 1;
-	}
-	return result;
-}
\ No newline at end of file
+#include "ThreadedGame.h"
+
+ThreadedGame::ThreadedGame(int id, std::string refereeCmd, std::vector<std::string> playersCmd, Mutable<int>& count, Mutable<PlayerStats>& playerStats, Mutable<SeedGenerator>& seeder, ResultsJournal& journal, Reaper& reaper, int n, bool swap, Level verbose, std::string path, std::string file)
+	:Threadable{ }, count{ count }, playerStats{ playerStats }, seeder{ seeder }, journal{ journal }, reaper{ reaper }, n{ n }, swap{ swap }, game{ 0 }, playersCount{ (int)playersCmd.size() },
+	refereeCmd{ refereeCmd }, playersCmd{ playersCmd }, verbose{ verbose }, path{ path }, file{ file }, logger{ Logger(verbose) }, rotate{ 0 }, sharedMemory{ false }, replyTimeout{ Process::TIMEOUT }, cache{ NULL }, cacheable{ false }, scheduler{ NULL }, ordered{ false }, trace{ NULL }, metrics{ NULL }, gameLogs{ NULL }, groupGame{ 0 }, cancelled{ false } {
+	players.reserve(playersCount);
+	logger.setOutputPath(path);
+	logger.setOutputFile(file);
+}
+
+ThreadedGame::~ThreadedGame() {
+	// Delete vector objects
+	seedRotate.clear();
+	players.clear();
+	playersCmd.clear();
+}
+
+Logger& ThreadedGame::getLog() { return logger; }
+
+void ThreadedGame::setResourceProfile(const ResourceProfile& profile) { this->profile = profile; }
+
+void ThreadedGame::setSharedMemory(bool enabled) { this->sharedMemory = enabled; }
+
+void ThreadedGame::setReplyTimeout(DWORD timeout) { this->replyTimeout = timeout; }
+
+void ThreadedGame::setResultCache(ResultCache* cache) { this->cache = cache; }
+
+void ThreadedGame::setScheduler(Scheduler* scheduler) { this->scheduler = scheduler; }
+
+void ThreadedGame::setTrace(TraceBuffer* trace) { this->trace = trace; }
+
+void ThreadedGame::setMetrics(Metrics* metrics) { this->metrics = metrics; }
+
+void ThreadedGame::setGameLogs(GameLogWriter* gameLogs) {
+	this->gameLogs = gameLogs;
+	logger.setGameLogs(gameLogs);
+}
+
+bool ThreadedGame::nextGame() {
+	//the previous game is over, it gave a result if it has scores
+	if (metrics != NULL && game != 0) {
+		metrics->gameEnded(!gameScores.empty() && !cancelled);
+	}
+	if (gameLogs != NULL && game != 0) {
+		gameLogs->close(game);
+	}
+	logger.setGame(0);
+
+	if (scheduler != NULL) {
+		if (ordered) {
+			scheduler->report(order, cancelled ? std::vector<int>() : gameScores);
+			ordered = false;
+		}
+		gameScores.clear();
+
+		game = 0;
+		if (!scheduler->next(order)) {
+			if (metrics != NULL) metrics->workerRunning(false);
+			return false;
+		}
+		if (metrics != NULL) metrics->gameStarted();
+		ordered = true;
+		game = order.game;
+		logger.setGame(game);
+		playersCmd = order.players;
+		if (!order.referee.empty()) refereeCmd = order.referee;
+		return true;
+	}
+
+	gameScores.clear();
+	game = 0;
+	int c = count.get();
+	if (c < n) {
+		game = c + 1;
+		count.set(game);
+	}
+	logger.setGame(game);
+	if (metrics != NULL) {
+		if (game != 0) metrics->gameStarted();
+		else metrics->workerRunning(false);
+	}
+	return game != 0;
+}
+
+void ThreadedGame::abandonGames() {
+	if (metrics != NULL) {
+		if (game != 0) metrics->gameEnded(false);
+		metrics->workerRunning(false);
+	}
+	if (gameLogs != NULL && game != 0) {
+		gameLogs->close(game);
+	}
+	logger.setGame(0);
+
+	if (scheduler != NULL && ordered) {
+		scheduler->report(order, std::vector<int>());
+		ordered = false;
+	}
+	gameScores.clear();
+	game = 0;
+}
+
+void ThreadedGame::start() {
+	// Call the start function in Threadable
+	logger.addLog(Level::VERBOSE, "Threaded game, starting thread.");
+	if (metrics != NULL) metrics->workerRunning(true);
+	Threadable::start();
+}
+
+bool ThreadedGame::createGroup() {
+	std::lock_guard<std::mutex> lock(m_group);
+	groupGame = game;
+	cancelled = false;
+	return group.create();
+}
+
+void ThreadedGame::cancel(int game) {
+	std::lock_guard<std::mutex> lock(m_group);
+	if (groupGame != game || group.getHandle() == NULL) return;
+
+	//processes the group does not hold yet still play on, the outcome is flagged either way
+	cancelled = true;
+	TerminateJobObject(group.getHandle(), 1);
+}
+
+void ThreadedGame::teardown() {
+	TraceSpan span(trace, "teardown", game);
+	std::vector<ProcessHandles> processes;
+	processes.push_back(referee.release("referee"));
+	for (size_t i = 0; i < players.size(); ++i) {
+		processes.push_back(players[i].release("p" + std::to_string(i + 1)));
+	}
+	players.clear();
+
+	HANDLE released;
+	{
+		std::lock_guard<std::mutex> lock(m_group);
+		released = group.release();
+	}
+	reaper.add(game, released, std::move(processes));
+}
+
+void ThreadedGame::log(Level v, std::string message) {
+	this->logString = "[Game " + std::to_string(game) + "] ";
+	logString += message;
+	logger.addLog(v, logString);
+}
+
+void ThreadedGame::clearErrorStream(HANDLE& handle, std::string_view prefix) {
+	//only read what is there, a read on an empty pipe would block until the child writes to stderr
+	DWORD bytesAvail = 0;
+	while (PeekNamedPipe(handle, NULL, 0, NULL, &bytesAvail, NULL) && bytesAvail > 0) {
+		char buffer[Process::BUFSIZE + 1]{};
+		DWORD bytesRead;
+		if (!ReadFile(handle, buffer, Process::BUFSIZE, &bytesRead, NULL)) {
+			break;
+		}
+		logger.addLog(Level::ERR, std::string(prefix) + std::string(buffer, bytesRead));
+	}
+}
+
+bool ThreadedGame::hasNextInt(HANDLE& handle) {
+	DWORD dwRead;
+	char c;
+	PeekNamedPipe(handle, &c, 1, &dwRead, NULL, NULL);
+	return isdigit(c);
+}
+
+bool ThreadedGame::hasNext(HANDLE& handle) {
+	DWORD dwRead;
+	char c;
+	PeekNamedPipe(handle, &c, 1, &dwRead, NULL, NULL);
+	return c != EOF;
+}
+
+bool ThreadedGame::hasNextLine(HANDLE& handle) {
+	DWORD dwRead;
+	char c;
+	PeekNamedPipe(handle, &c, 1, &dwRead, NULL, NULL);
+	return c != EOF && c != '\n';
+}
+
+
+void ThreadedGame::logBlock(const std::string& prefix, std::string_view block) {
+	size_t start = 0;
+	size_t end;
+	while ((end = block.find('\n', start)) != std::string_view::npos) {
+		std::string_view line = block.substr(start, end - start);
+		if (line.ends_with('\r')) line.remove_suffix(1);
+		logger.addLog(Level::VERBOSE, prefix + std::string(line));
+		start = end + 1;
+	}
+}
+
+void ThreadedGame::collectUsage() {
+	for (int i = 0; i < (int)players.size(); ++i) {
+		std::string player = "p" + std::to_string(i + 1);
+
+		//never started, nothing to collect
+		if (!players[i].sampleUsage()) continue;
+		playerStats.get().addUsage(i, players[i].getUsage());
+		journal.addRecord(game, "usage " + player, players[i].getUsage().toString());
+
+		Violation violation = players[i].checkLimits();
+		if (violation != NO_VIOLATION) {
+			playerStats.get().addViolation(i, violation);
+			journal.addRecord(game, "violation " + player, ResourceProfile::violationToString(violation));
+
+			logString = "Player " + std::to_string(i + 1) + " broke the " + ResourceProfile::violationToString(violation) + " limit in game " + std::to_string(game) + ".";
+			logger.addLog(Level::WARN, logString);
+		}
+	}
+}
+
+bool ThreadedGame::loadCachedResult(long long seed) {
+	cacheKey.clear();
+	cacheable = true;
+	if (cache == NULL || !cache->isOpen()) return false;
+
+	cacheKey = cache->makeKey(refereeCmd, playersCmd, seed, rotate);
+	std::string outcome;
+	if (!cache->lookup(cacheKey, outcome)) return false;
+
+	//the old mode stores its "###End" line, the others their scores
+	std::vector<int> scores;
+	if (outcome.rfind("###End", 0) == 0) {
+		scores = PlayerStats::rankingToScores(outcome, playersCount);
+	}
+	else {
+		for (std::string_view score : StringUtils::splitString(outcome, ' ')) {
+			if (score.empty()) continue;
+			if (score[0] == '-') scores.push_back(-StringUtils::toInteger(score.substr(1)));
+			else scores.push_back(StringUtils::toInteger(score));
+		}
+		if ((int)scores.size() != playersCount) {
+			logString = "Ignoring a broken cache entry for game " + std::to_string(game) + ": " + outcome;
+			logger.addLog(Level::WARN, logString);
+			return false;
+		}
+	}
+	{
+		TraceSpan span(trace, "stats merge", game);
+		playerStats.get().add(scores);
+	}
+	gameScores = scores;
+	journal.addRecord(game, "result", outcome);
+	journal.addRecord(game, "cached", cacheKey);
+
+	//log end of game
+	std::string logLine = "End of game " + std::to_string(game);
+	logLine += " (cached): " + outcome;
+	logLine += "\t" + playerStats.get().toString();
+	logger.addLog(Level::INFO, "Referee: " + logLine);
+	return true;
+}
+
+void ThreadedGame::storeResult(std::string_view outcome) {
+	if (cache == NULL || cacheKey.empty() || !cacheable || cancelled) return;
+	cache->store(cacheKey, outcome);
+}
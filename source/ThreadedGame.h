@@ -1,177 +1,287 @@
-#ifndef THREADEDGAME_H
-#define THREADEDGAME_H
-
-#include <vector>
-#include <string_view>
-#include <iostream>
-#include <stdexcept>
-#include <limits>
-#include <thread>
-#include "Threadable.h"
-#include "PlayerStats.h"
-#include "Process.h"
-#include "Logger.h"
-#include "Mutable.h"
-#include "SeedGenerator.h"
-
-/*
- * @brief Class describing a base ThreadedGame object. This combines the reused code from OldGameThread and GameThread reducing them to run functions.
- */
-class ThreadedGame : public Threadable {
-    friend class GameThread;
-    friend class OldGameThread;
-private:
-    Mutable<PlayerStats>& playerStats;      //< Shared Player Stats.
-    Mutable<int>& count;                    //< Shared count of games played.
-    Mutable<SeedGenerator>& seeder;         //< Shared rng seeder.
-    int playersCount;                       //< the number of players.
-    int n;                                  //< Number of games to play.
-    int rotate;                             //< Rotating the seeds.
-    int game;                               //< Game number we are on.
-    bool swap;                              //< Are we swapping player positions?
-    std::string path;                       //< logfile path 
-    std::string file;                       //< logfile name 
-    std::vector<int> seedRotate;            //< The seeds to rotate.
-
-    std::string logString;                  //< Temporary logString, string to add to the log.
-    Level verbose;                          //< The lowest level to log.
-    Logger logger;                          //< The log object.
-
-    std::string refereeCmd;                 //< The Referee command line.
-    std::vector<std::string> playersCmd;    //< The Players command lines.
-
-    Process referee;                        //< The Referee Process.
-    std::vector<Process> players;           //< The Players Processes.
-        
-protected:
-    /*
-     * @brief Allows child classes access to setFinished in Threadable.
-     */
-    friend void Threadable::setFinished();
-
-    /*
-     * @brief Clears the error stream.
-     *
-     * @param errStream The stream.
-     * @param prefix The header to print.
-     */
-    void clearErrorStream(HANDLE& handle, std::string prefix);
-
-    /*
-     * @brief Checks the stream for an int. Just like javas Scanner.hasNextInt;
-     *
-     * @param stream The stream
-     * @return true if next value is an integer, false if not
-     */
-    bool hasNextInt(HANDLE& handle);
-
-    /*
-     * @brief Checks the stream for any value. Just like javas Scanner.hasNext;
-     *
-     * @param stream The stream
-     * @return true if more exists in stram, false if stream is empty
-     */
-    bool hasNext(HANDLE& handle);
-
-    /*
-     * @brief Checks the stream for a line. Just like javas Scanner.hasNextLine;
-     *
-     * @param stream The stream
-     * @return true another line exists in stream, false if stream is empty
-     */
-    bool hasNextLine(HANDLE& handle);
-
-    /*
-     * @brief Converts a string to an integer.
-     *
-     * @param s The string.
-     * @return an integer
-     */
-    static int toInteger(std::string_view s);
-
-    /*
-     * @brief Converts a char to an integer.
-     *
-     * @param c The char.
-     * @return an integer
-     */
-    static int toInteger(char c);
-
-    /*
-     * @brief Splits a string at delimeter.
-     *
-     * @param str The string.
-     * @param delimeter The delimeter.
-     * @return a std::vector of the strings
-     */
-    static std::vector<std::string_view> splitString(std::string_view str, char delimiter);
-
-    template <typename T>
-    /*
-     * @brief Joins a std::vector<string> or std::vector<string_view> with a std::string or std::string_view delimeter (" " or ", " for example) 
-     *
-     * @param strings The string or string_view vector.
-     * @param begin std::vector<string or string_view>::iterator where to begin
-     * @param end std::vector<string or string_view>::iterator where to end
-     * @param delimeter The delimeter.
-     * @return a std::string or string_view
-     */
-     static T joinString(const std::vector<T>& strings, typename std::vector<T>::iterator begin, typename std::vector<T>::iterator end, T delimiter) {
-        T str{};
-
-        for (typename std::vector<T>::iterator& it = begin; it != end; ++it) {
-            str += *it;
-            if (it + 1 != end) str += delimiter;
-        }
-
-        return str;
-    }
-
-    /*
-     * @brief Adds a log to the logger.
-     *
-     * @param v The verbosity level of the log
-     * @param message the message to log
-     */
-    void log(Level v, std::string message);
-
-    /*
-     * @brief Calls start in Threadable base class to start the thread.
-     */
-    void start();
-    
-    /*
-     * @brief The run method from the Threadable base class we must overide.
-     */
-    virtual void run() = 0;
-
-public:
-    /*
-     * @brief Constructs a ThreadedGame object.
-     *
-     * @param id The id.
-     * @param refereeCmd The referee command line.
-     * @param playersCmd The vector of player command lines.
-     * @param count The shared count of games.
-     * @param playerStats The playerStats object.
-     * @param seeder the shared rng seeder object.
-     * @param swap Are we swapping player positions?
-     * @param verbose The verbosity to use for the logs.
-     */
-    ThreadedGame(int id, std::string refereeCmd, std::vector<std::string> playersCmd, Mutable<int>& count, Mutable<PlayerStats>& playerStats, Mutable<SeedGenerator>& seeder, int n, bool swap, Level verbose, std::string path, std::string file);
-
-    /*
-     * @brief Denstructs a ThreadedGame object.
-     */
-    ~ThreadedGame();
-
-    /*
-     * @brief Gets the log.
-     * 
-     * @return the log.
-     */
-    Logger& getLog();
-
-};
-
+#ifndef THREADEDGAME_H
+#define THREADEDGAME_H
+
+#include <vector>
+#include <string_view>
+#include <iostream>
+#include <stdexcept>
+#include <limits>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include "Threadable.h"
+#include "PlayerStats.h"
+#include "Process.h"
+#include "Logger.h"
+#include "Mutable.h"
+#include "SeedGenerator.h"
+#include "ResultsJournal.h"
+#include "ProcessGroup.h"
+#include "Reaper.h"
+#include "StringUtils.h"
+#include "ResultCache.h"
+#include "Scheduler.h"
+#include "Trace.h"
+#include "Metrics.h"
+#include "GameLogWriter.h"
+
+/*
+ * @brief Class describing a base ThreadedGame object. This combines the reused code from OldGameThread and GameThread reducing them to run functions.
+ */
+class ThreadedGame : public Threadable {
+    friend class GameThread;
+    friend class OldGameThread;
+    friend class PluginGameThread;
+private:
+    Mutable<PlayerStats>& playerStats;      //< Shared Player Stats.
+    Mutable<int>& count;                    //< Shared count of games played.
+    Mutable<SeedGenerator>& seeder;         //< Shared rng seeder.
+    ResultsJournal& journal;                //< Shared results journal.
+    Reaper& reaper;                         //< Shared teardown thread.
+    int playersCount;                       //< the number of players.
+    int n;                                  //< Number of games to play.
+    int rotate;                             //< Rotating the seeds.
+    int game;                               //< Game number we are on.
+    bool swap;                              //< Are we swapping player positions?
+    std::string path;                       //< logfile path 
+    std::string file;                       //< logfile name 
+    std::vector<int> seedRotate;            //< The seeds to rotate.
+
+    std::string logString;                  //< Temporary logString, string to add to the log.
+    Level verbose;                          //< The lowest level to log.
+    Logger logger;                          //< The log object.
+
+    std::string refereeCmd;                 //< The Referee command line.
+    std::vector<std::string> playersCmd;    //< The Players command lines.
+
+    ResourceProfile profile;                //< The resource limits put on each player.
+    bool sharedMemory;                      //< Offer the players a shared memory channel?
+    DWORD replyTimeout;                     //< ms a player gets to reply to a turn, it gets no more turns after missing one.
+
+    ResultCache* cache;                     //< Shared result cache, NULL if not used.
+    std::string cacheKey;                   //< This game's key in the cache, empty if the game cannot be cached.
+    bool cacheable;                         //< Cleared when something in this game depended on timing, ex. a player timing out.
+
+    Scheduler* scheduler;                   //< Shared scheduler picking the games, NULL to play the one lineup n times.
+    GameOrder order;                        //< The game the scheduler handed out.
+    bool ordered;                           //< Is there a game from the scheduler not reported yet?
+    TraceBuffer* trace;                     //< This thread's trace buffer, NULL if not traced.
+    Metrics* metrics;                       //< Shared live metrics, NULL if not served.
+    GameLogWriter* gameLogs;                //< Shared writer of the per game logs, NULL to keep them in the log.
+    std::vector<int> gameScores;            //< This game's scores in player order, empty until the result is in.
+
+    ProcessGroup group;                     //< The job object holding this game's processes.
+    int groupGame;                          //< The game the group belongs to.
+    std::atomic<bool> cancelled;            //< Set by cancel(), the game's outcome means nothing.
+    std::mutex m_group;                     //< Mutex protecting group and groupGame against cancel().
+    Process referee;                        //< The Referee Process.
+    std::vector<Process> players;           //< The Players Processes.
+        
+protected:
+    /*
+     * @brief Allows child classes access to setFinished in Threadable.
+     */
+    friend void Threadable::setFinished();
+
+    /*
+     * @brief Clears the error stream.
+     *
+     * @param errStream The stream.
+     * @param prefix The header to print.
+     */
+    void clearErrorStream(HANDLE& handle, std::string_view prefix);
+
+    /*
+     * @brief Checks the stream for an int. Just like javas Scanner.hasNextInt;
+     *
+     * @param stream The stream
+     * @return true if next value is an integer, false if not
+     */
+    bool hasNextInt(HANDLE& handle);
+
+    /*
+     * @brief Checks the stream for any value. Just like javas Scanner.hasNext;
+     *
+     * @param stream The stream
+     * @return true if more exists in stram, false if stream is empty
+     */
+    bool hasNext(HANDLE& handle);
+
+    /*
+     * @brief Checks the stream for a line. Just like javas Scanner.hasNextLine;
+     *
+     * @param stream The stream
+     * @return true another line exists in stream, false if stream is empty
+     */
+    bool hasNextLine(HANDLE& handle);
+
+    /*
+     * @brief Creates this game's group, the job object its processes go in.
+     *
+     * @return success true or false.
+     */
+    bool createGroup();
+
+    /*
+     * @brief Hands this game's referee, players and group over to the Reaper and returns right away.
+     */
+    void teardown();
+
+    /*
+     * @brief Collects the resource usage and broken limits of this game's players into the stats and the journal.
+     */
+    void collectUsage();
+
+    /*
+     * @brief Logs a block of lines at the VERBOSE level, one entry per line.
+     *
+     * @param prefix Put in front of every line.
+     * @param block The lines, each one ending with a line break.
+     */
+    void logBlock(const std::string& prefix, std::string_view block);
+
+    /*
+     * @brief Picks the next game, from the scheduler if there is one, else the next number under n.
+     * Reports the previous scheduled game first, with its scores or as failed.
+     *
+     * @return false if there is nothing left to play.
+     */
+    bool nextGame();
+
+    /*
+     * @brief Ends this thread's games early, ex. on a referee it cannot read. The current game counts as failed, its log
+     * is closed and the scheduler gets it back, and the thread no longer counts as running in the metrics.
+     */
+    void abandonGames();
+
+    /*
+     * @brief Looks this game up in the result cache and, on a hit, adds the stored outcome to the stats and the journal.
+     * Also sets the key storeResult() uses, so call it once per game, before spawning anything.
+     *
+     * @param seed the seed sent to the referee.
+     *
+     * @return true if the game was answered from the cache and must not be played.
+     */
+    bool loadCachedResult(long long seed);
+
+    /*
+     * @brief Stores this game's outcome in the result cache, unless the game cannot be cached.
+     *
+     * @param outcome the outcome as given to the stats, the "###End" line or the scores.
+     */
+    void storeResult(std::string_view outcome);
+
+    /*
+     * @brief Adds a log to the logger.
+     *
+     * @param v The verbosity level of the log
+     * @param message the message to log
+     */
+    void log(Level v, std::string message);
+
+    /*
+     * @brief Calls start in Threadable base class to start the thread.
+     */
+    void start();
+    
+    /*
+     * @brief The run method from the Threadable base class we must overide.
+     */
+    virtual void run() = 0;
+
+public:
+    /*
+     * @brief Constructs a ThreadedGame object.
+     *
+     * @param id The id.
+     * @param refereeCmd The referee command line.
+     * @param playersCmd The vector of player command lines.
+     * @param count The shared count of games.
+     * @param playerStats The playerStats object.
+     * @param seeder the shared rng seeder object.
+     * @param journal the shared results journal.
+     * @param reaper the shared teardown thread.
+     * @param swap Are we swapping player positions?
+     * @param verbose The verbosity to use for the logs.
+     */
+    ThreadedGame(int id, std::string refereeCmd, std::vector<std::string> playersCmd, Mutable<int>& count, Mutable<PlayerStats>& playerStats, Mutable<SeedGenerator>& seeder, ResultsJournal& journal, Reaper& reaper, int n, bool swap, Level verbose, std::string path, std::string file);
+
+    /*
+     * @brief Denstructs a ThreadedGame object.
+     */
+    ~ThreadedGame();
+
+    /*
+     * @brief Sets the resource limits to put on each player process.
+     *
+     * @param profile the limits.
+     */
+    void setResourceProfile(const ResourceProfile& profile);
+
+    /*
+     * @brief Offers each player process a shared memory channel instead of its pipes, see ShmChannel.h.
+     *
+     * @param enabled offer it or not.
+     */
+    void setSharedMemory(bool enabled);
+
+    /*
+     * @brief Sets how long a player gets to reply to a turn. Call before start().
+     *
+     * @param timeout the time in ms.
+     */
+    void setReplyTimeout(DWORD timeout);
+
+    /*
+     * @brief Sets the result cache to skip the games already played, see ResultCache.h.
+     *
+     * @param cache the shared cache, NULL to play every game.
+     */
+    void setResultCache(ResultCache* cache);
+
+    /*
+     * @brief Sets the scheduler picking the lineup, seed and rotation of each game, see Scheduler.h. Call before start().
+     *
+     * @param scheduler the shared scheduler, NULL to play the one lineup n times.
+     */
+    void setScheduler(Scheduler* scheduler);
+
+    /*
+     * @brief Sets the buffer this thread records its spans in, see Trace.h. Call before start().
+     *
+     * @param trace the buffer, only this thread may use it. NULL not to trace.
+     */
+    void setTrace(TraceBuffer* trace);
+
+    /*
+     * @brief Sets the live metrics this thread counts its games, spawns and turns in, see Metrics.h. Call before start().
+     *
+     * @param metrics the shared metrics, NULL not to count.
+     */
+    void setMetrics(Metrics* metrics);
+
+    /*
+     * @brief Sets the writer this thread's logs about a game go to, see GameLogWriter.h. Call before start().
+     *
+     * @param gameLogs the shared writer, NULL to keep every log in getLog().
+     */
+    void setGameLogs(GameLogWriter* gameLogs);
+
+    /*
+     * @brief Kills the processes of a game if this thread is still playing it. Thread safe.
+     * The game then ends as it would with crashed players, its outcome is neither cached nor worth reporting.
+     *
+     * @param game the game number.
+     */
+    void cancel(int game);
+
+    /*
+     * @brief Gets the log.
+     * 
+     * @return the log.
+     */
+    Logger& getLog();
+
+};
+
 #endif
\ No newline at end of file
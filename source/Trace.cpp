@@ -0,0 +1,66 @@
+#include "Trace.h"
+#include "ExePath.h"
+
+#include <filesystem>
+
+TraceBuffer::TraceBuffer(const std::string& name, int tid, std::chrono::steady_clock::time_point origin)
+    :name{ name }, tid{ tid }, origin{ origin }, dropped{ 0 } {
+    spans.reserve(4096);
+}
+
+void TraceBuffer::add(const char* name, std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end, int game, int player) {
+    if (spans.size() >= MAX_SPANS) {
+        dropped++;
+        return;
+    }
+    long long start = std::chrono::duration_cast<std::chrono::nanoseconds>(begin - origin).count();
+    long long duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count();
+    spans.push_back({ name, start, duration, game, player });
+}
+
+Tracer::Tracer() : origin{ std::chrono::steady_clock::now() } {}
+
+TraceBuffer* Tracer::openBuffer(const std::string& name) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (TraceBuffer& buffer : buffers) {
+        if (buffer.getName() == name) return &buffer;
+    }
+    buffers.emplace_back(name, (int)buffers.size() + 1, origin);
+    return &buffers.back();
+}
+
+bool Tracer::open(const std::string& dir, const std::string& file) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::filesystem::path path = ExePath::resolve(dir) / file;
+
+    out.open(path, std::ofstream::out | std::ofstream::trunc);
+    return !out.fail();
+}
+
+bool Tracer::write() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!out.is_open()) return false;
+
+    //complete events, "ph":"X", with the times in microseconds
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"new-cg-brutal-tester\"}}";
+    for (const TraceBuffer& buffer : buffers) {
+        out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer.getTid() << ",\"args\":{\"name\":\"" << buffer.getName() << "\"}}";
+        out << ",\n{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer.getTid() << ",\"args\":{\"sort_index\":" << buffer.getTid() << "}}";
+        for (const TraceBuffer::Span& span : buffer.getSpans()) {
+            out << ",\n{\"name\":\"" << span.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer.getTid();
+            out << ",\"ts\":" << span.begin / 1000 << '.' << (char)('0' + span.begin / 100 % 10);
+            out << ",\"dur\":" << span.duration / 1000 << '.' << (char)('0' + span.duration / 100 % 10);
+            out << ",\"args\":{\"game\":" << span.game;
+            if (span.player >= 0) out << ",\"player\":" << span.player;
+            out << "}}";
+        }
+        if (buffer.getDropped() > 0) {
+            out << ",\n{\"name\":\"spans dropped\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":" << buffer.getTid() << ",\"ts\":0,\"args\":{\"count\":" << buffer.getDropped() << "}}";
+        }
+    }
+    out << "\n]}\n";
+    out.flush();
+    return !out.fail();
+}
@@ -0,0 +1,176 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <chrono>
+#include <fstream>
+
+/*
+ * @brief Class describing the trace buffer of one thread: the spans it recorded, in the order they ended.
+ *
+ * Only its own thread writes to it, so recording takes no lock and no allocation past the vector's growth.
+ * Span names are string literals and are never copied. Past MAX_SPANS the spans are counted, not kept.
+ */
+class TraceBuffer {
+public:
+    /*
+     * @brief Struct describing one recorded span.
+     */
+    struct Span {
+        const char* name;           //< what was done, a string literal
+        long long begin;            //< ns since the tracer started
+        long long duration;         //< ns
+        int game;                   //< the game, 0 if none
+        int player;                 //< the player, -1 if none
+    };
+
+private:
+    std::string name;                                   //< the thread name shown in the timeline
+    int tid;                                            //< the thread id shown in the timeline
+    std::chrono::steady_clock::time_point origin;       //< when the tracer started
+    std::vector<Span> spans;                            //< the spans
+    long long dropped;                                  //< spans past the cap
+
+    const static size_t MAX_SPANS = 1 << 20;            //< 32 MB of spans per thread
+
+public:
+    /*
+     * @brief Constructs a TraceBuffer object.
+     *
+     * @param name the thread name.
+     * @param tid the thread id.
+     * @param origin when the tracer started.
+     */
+    TraceBuffer(const std::string& name, int tid, std::chrono::steady_clock::time_point origin);
+
+    /*
+     * @brief Records a span.
+     *
+     * @param name what was done, a string literal.
+     * @param begin when it began.
+     * @param end when it ended.
+     * @param game the game, 0 if none.
+     * @param player the player, -1 if none.
+     */
+    void add(const char* name, std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end, int game, int player);
+
+    /*
+     * @brief Gets the thread name.
+     *
+     * @return the name.
+     */
+    const std::string& getName() const { return name; }
+
+    /*
+     * @brief Gets the thread id shown in the timeline.
+     *
+     * @return the id.
+     */
+    int getTid() const { return tid; }
+
+    /*
+     * @brief Gets the spans, in the order they ended.
+     *
+     * @return the spans.
+     */
+    const std::vector<Span>& getSpans() const { return spans; }
+
+    /*
+     * @brief Gets the number of spans past the cap, counted but not kept.
+     *
+     * @return the number of spans.
+     */
+    long long getDropped() const { return dropped; }
+};
+
+/*
+ * @brief Class describing a span recorded from its construction to its destruction. Does nothing if the buffer is NULL,
+ * so code can be traced unconditionally and costs nothing when no trace is asked for.
+ */
+class TraceSpan {
+private:
+    TraceBuffer* buffer;                                //< where the span goes, NULL if not traced
+    const char* name;                                   //< what is done, a string literal
+    int game;                                           //< the game, 0 if none
+    int player;                                         //< the player, -1 if none
+    std::chrono::steady_clock::time_point begin;        //< when the span began
+
+public:
+    /*
+     * @brief Constructs a TraceSpan object and starts the span.
+     *
+     * @param buffer the trace buffer of this thread, NULL if not traced.
+     * @param name what is done, a string literal.
+     * @param game the game, 0 if none.
+     * @param player the player, -1 if none.
+     */
+    TraceSpan(TraceBuffer* buffer, const char* name, int game, int player = -1)
+        :buffer{ buffer }, name{ name }, game{ game }, player{ player } {
+        if (buffer != NULL) begin = std::chrono::steady_clock::now();
+    }
+
+    /*
+     * @brief Ends the span and records it, unless end() already did.
+     */
+    ~TraceSpan() { end(); }
+
+    /*
+     * @brief Ends the span early and records it.
+     */
+    void end() {
+        if (buffer != NULL) buffer->add(name, begin, std::chrono::steady_clock::now(), game, player);
+        buffer = NULL;
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+};
+
+/*
+ * @brief Class describing the trace recorder: one buffer per thread, written at exit as Chrome trace event JSON,
+ * which chrome://tracing and Perfetto open as a timeline with a row per thread.
+ */
+class Tracer {
+private:
+    std::chrono::steady_clock::time_point origin;       //< when the tracer started
+    std::deque<TraceBuffer> buffers;                    //< the buffers, a deque so they never move
+    std::ofstream out;                                  //< the trace file
+    std::mutex m_mutex;                                 //< Mutex protecting buffers.
+
+public:
+    /*
+     * @brief Constructs a Tracer object, the timeline starts now.
+     */
+    Tracer();
+
+    /*
+     * @brief Gets the buffer of a thread, opened on first use. Give each thread its own name.
+     *
+     * @param name the thread name.
+     *
+     * @return the buffer, it lives as long as the tracer.
+     */
+    TraceBuffer* openBuffer(const std::string& name);
+
+    /*
+     * @brief Opens the trace file next to the executable, it is written by write().
+     *
+     * @param dir the directory.
+     * @param file the file name.
+     *
+     * @return success true or false.
+     */
+    bool open(const std::string& dir, const std::string& file);
+
+    /*
+     * @brief Writes the trace. Call it once the traced threads are done.
+     *
+     * @return success true or false.
+     */
+    bool write();
+};
+
+#endif
@@ -0,0 +1,172 @@
+#include "TuneScheduler.h"
+#include "ExePath.h"
+
+#include <cmath>
+#include <format>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <filesystem>
+
+TuneScheduler::TuneScheduler(const std::string& templateCmd, const std::vector<Parameter>& parameters, Mutable<SeedGenerator>& seeder, int budget)
+    :templateCmd{ templateCmd }, parameters{ parameters }, seeder{ seeder }, flipper{ (unsigned int)seeder.get().nextSeed() }, budget{ budget },
+    issued{ 0 }, pairs{ 0 }, complete{ 0 }, dropped{ 0 }, stability{ 0.1 * budget / 2.0 } {}
+
+bool TuneScheduler::readParameters(const std::string& file, std::vector<Parameter>& parameters) {
+    std::vector<std::string> lines;
+    if (!readPool(file, lines)) return false;
+
+    for (const std::string& line : lines) {
+        std::istringstream fields(line);
+        Parameter parameter;
+        if (!(fields >> parameter.name >> parameter.start >> parameter.min >> parameter.max >> parameter.step)) return false;
+        fields >> parameter.rate;
+        if (parameter.min > parameter.max || parameter.step <= 0.0 || parameter.rate <= 0.0) return false;
+
+        parameter.value = std::clamp(parameter.start, parameter.min, parameter.max);
+        parameter.integer = true;
+        for (double number : { parameter.start, parameter.min, parameter.max, parameter.step }) {
+            if (number != std::floor(number)) parameter.integer = false;
+        }
+        parameters.push_back(parameter);
+    }
+    return !parameters.empty();
+}
+
+bool TuneScheduler::setTrajectory(const std::string& dir, const std::string& file) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::filesystem::path path = ExePath::resolve(dir) / file;
+
+    trajectory.open(path, std::ofstream::out | std::ofstream::trunc);
+    if (trajectory.fail()) return false;
+
+    trajectory << "pair,games,points";
+    for (const Parameter& parameter : parameters) trajectory << ',' << parameter.name;
+    trajectory << '\n';
+    trajectory.flush();
+    return true;
+}
+
+std::string TuneScheduler::instantiate(const std::vector<double>& values) const {
+    std::string cmd = templateCmd;
+    for (size_t i = 0; i < parameters.size(); ++i) {
+        std::string text = parameters[i].integer ? std::to_string(std::llround(values[i])) : std::format("{:.6g}", values[i]);
+        std::string placeholder = "{" + parameters[i].name + "}";
+        for (size_t at = cmd.find(placeholder); at != std::string::npos; at = cmd.find(placeholder, at + text.size())) {
+            cmd.replace(at, placeholder.size(), text);
+        }
+    }
+    return cmd;
+}
+
+void TuneScheduler::startPair() {
+    int id = pairs++;
+    Pair& pair = open[id];
+    pair.iteration = id;
+
+    //both ways from the current values, the shift shrinks as the run goes on
+    std::vector<double> up, down;
+    for (const Parameter& parameter : parameters) {
+        int flip = (flipper() & 1) ? 1 : -1;
+        double shift = parameter.step / std::pow(id + 1.0, 0.101);
+        pair.flips.push_back(flip);
+        pair.shifts.push_back(shift);
+        up.push_back(std::clamp(parameter.value + flip * shift, parameter.min, parameter.max));
+        down.push_back(std::clamp(parameter.value - flip * shift, parameter.min, parameter.max));
+    }
+    std::string upCmd = instantiate(up);
+    std::string downCmd = instantiate(down);
+
+    //getSeed hands the same seed out once per seat, counting the seats, the same as -s
+    for (int seat = 0; seat < 2; ++seat) {
+        std::vector<int> seedRotate = seeder.get().getSeed(2);
+        GameOrder order;
+        order.players = { upCmd, downCmd };
+        order.seed = seedRotate[0];
+        order.rotation = seedRotate[1] % 2;
+        order.tag = id;
+        queue.push_back(order);
+    }
+}
+
+bool TuneScheduler::next(GameOrder& order) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (queue.empty()) {
+        if (issued + 2 > budget) return false;
+        startPair();
+    }
+
+    order = queue.front();
+    queue.pop_front();
+    issued++;
+    order.game = issued;
+    return true;
+}
+
+void TuneScheduler::report(const GameOrder& order, const std::vector<int>& scores) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto found = open.find(order.tag);
+    if (found == open.end()) return;
+    Pair& pair = found->second;
+
+    pair.reported++;
+    if (scores.size() < 2) {
+        pair.failed = true;
+    }
+    else {
+        pair.points += scores[0] > scores[1] ? 1.0 : (scores[0] < scores[1] ? 0.0 : 0.5);
+    }
+    if (pair.reported < 2) return;
+
+    if (pair.failed) {
+        dropped++;
+    }
+    else {
+        //up won by this much, -1 to 1, every parameter moves the way its flip went
+        double result = pair.points - 1.0;
+        double gain = std::pow((stability + 1.0) / (stability + pair.iteration + 1.0), 0.602);
+        for (size_t i = 0; i < parameters.size(); ++i) {
+            Parameter& parameter = parameters[i];
+            parameter.value += parameter.rate * gain * pair.shifts[i] * result * pair.flips[i];
+            parameter.value = std::clamp(parameter.value, parameter.min, parameter.max);
+        }
+        complete++;
+
+        if (trajectory.is_open()) {
+            trajectory << pair.iteration << ',' << issued << ',' << pair.points;
+            for (const Parameter& parameter : parameters) trajectory << ',' << parameter.value;
+            trajectory << '\n';
+            trajectory.flush();
+        }
+    }
+    open.erase(found);
+}
+
+void TuneScheduler::print() {
+    /*
+    +----------------------+------------+------------+------------+------------+
+    | Parameter            | Start      | Tuned      | Min        | Max        |
+    +----------------------+------------+------------+------------+------------+
+    | c                    | 1.4        | 1.2731     | 0.5        | 3          |
+    +----------------------+------------+------------+------------+------------+
+    */
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::string separator = "+----------------------+------------+------------+------------+------------+";
+    std::cout << "Tuned " << templateCmd << " over " << complete << " pairs of games" << std::endl;
+    std::cout << separator << std::endl;
+    std::cout << "| Parameter            | Start      | Tuned      | Min        | Max        |" << std::endl;
+    std::cout << separator << std::endl;
+    std::vector<double> values;
+    for (const Parameter& parameter : parameters) {
+        values.push_back(parameter.value);
+        std::cout << std::format("| {:<21}| {:<11}| {:<11}| {:<11}| {:<11}|", parameter.name, std::format("{:.6g}", parameter.start),
+            std::format("{:.6g}", parameter.value), std::format("{:.6g}", parameter.min), std::format("{:.6g}", parameter.max)) << std::endl;
+        std::cout << separator << std::endl;
+    }
+    std::cout << "Tuned command line: " << instantiate(values) << std::endl;
+    if (dropped > 0) {
+        std::cout << dropped << " pairs were dropped, one of their games gave no result." << std::endl;
+    }
+}
@@ -0,0 +1,119 @@
+#ifndef TUNESCHEDULER_H
+#define TUNESCHEDULER_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <random>
+#include <fstream>
+#include "Scheduler.h"
+#include "SeedGenerator.h"
+#include "Mutable.h"
+
+/*
+ * @brief Class describing a SPSA tuner: the parameters of one bot, templated into its command line, tuned by self play.
+ *
+ * Each pair of games flips every parameter up or down at random, and the bot with the values shifted one way plays the
+ * bot shifted the other way, on one seed from both seats. The points won tell which way to move all the parameters
+ * at once. Pairs are handed out from the current values as soon as a thread is free, so many points are in flight
+ * at once, and each result is applied as it comes in. Step sizes shrink over the run as in Spall's SPSA, with
+ * gamma 0.101 and alpha 0.602.
+ */
+class TuneScheduler : public Scheduler {
+public:
+    /*
+     * @brief Struct describing one tuned parameter, a line "name start min max step [rate]" in the parameters file.
+     */
+    struct Parameter {
+        std::string name;           //< the name, the command line has {name} where the value goes
+        double value = 0.0;         //< the current value
+        double start = 0.0;         //< the value at the start
+        double min = 0.0;           //< the smallest value
+        double max = 0.0;           //< the largest value
+        double step = 1.0;          //< how far a game pair shifts the value at the start
+        double rate = 0.1;          //< how many steps a point won moves the value at the start
+        bool integer = false;       //< are all the numbers above whole? then so are the values given to the bot
+    };
+
+private:
+    /*
+     * @brief Struct describing a pair of games in flight.
+     */
+    struct Pair {
+        int iteration = 0;          //< the pair number, for the schedule
+        std::vector<int> flips;     //< +1 or -1 for each parameter
+        std::vector<double> shifts; //< how far each parameter was shifted each way
+        double points = 0.0;        //< the points of the bot shifted up
+        int reported = 0;           //< games reported so far
+        bool failed = false;        //< a game gave no result, the pair is dropped
+    };
+
+    std::string templateCmd;                //< the bot command line with the {name} placeholders
+    std::vector<Parameter> parameters;      //< the parameters
+    Mutable<SeedGenerator>& seeder;         //< Shared rng seeder.
+    std::mt19937 flipper;                   //< draws the flips
+    int budget;                             //< the most games to hand out
+    int issued;                             //< games handed out so far
+    int pairs;                              //< pairs started so far
+    int complete;                           //< pairs applied
+    int dropped;                            //< pairs with a failed game
+    double stability;                       //< Spall's A, a tenth of the pairs of the run
+
+    std::deque<GameOrder> queue;            //< games of the started pairs not handed out yet
+    std::map<int, Pair> open;               //< pairs not complete yet, by pair number
+    std::ofstream trajectory;               //< the values after every pair, as csv
+    std::mutex m_mutex;                     //< Mutex protecting everything above.
+
+    /*
+     * @brief Makes the bot command line for some values.
+     *
+     * @param values the value of each parameter.
+     *
+     * @return the command line.
+     */
+    std::string instantiate(const std::vector<double>& values) const;
+
+    /*
+     * @brief Starts the next pair from the current values, queueing its two games.
+     */
+    void startPair();
+
+public:
+    /*
+     * @brief Constructs a TuneScheduler object.
+     *
+     * @param templateCmd the bot command line with the {name} placeholders.
+     * @param parameters the parameters.
+     * @param seeder the shared rng seeder.
+     * @param budget the most games to play.
+     */
+    TuneScheduler(const std::string& templateCmd, const std::vector<Parameter>& parameters, Mutable<SeedGenerator>& seeder, int budget);
+
+    /*
+     * @brief Opens the trajectory file next to the executable, one csv line per applied pair.
+     *
+     * @param dir the directory.
+     * @param file the file name.
+     *
+     * @return success true or false.
+     */
+    bool setTrajectory(const std::string& dir, const std::string& file);
+
+    bool next(GameOrder& order) override;
+    void report(const GameOrder& order, const std::vector<int>& scores) override;
+    void print() override;
+
+    /*
+     * @brief Reads a parameters file, one "name start min max step [rate]" per line. Empty lines and lines starting with # are skipped.
+     *
+     * @param file the file.
+     * @param parameters Filled with the parameters.
+     *
+     * @return success true or false, false if a line is malformed.
+     */
+    static bool readParameters(const std::string& file, std::vector<Parameter>& parameters);
+};
+
+#endif
@@ -0,0 +1,129 @@
+#include "WatchScheduler.h"
+
+#include <format>
+#include <algorithm>
+#include <iostream>
+
+WatchScheduler::WatchScheduler(const std::vector<std::string>& playersCmd, Mutable<SeedGenerator>& seeder, int n, bool swap)
+    :playersCmd{ playersCmd }, build{ 1 }, games{ 0 }, played{ 0 }, points{ 0.0 }, paired{ 0 }, pairedPoints{ 0.0 }, pairedLast{ 0.0 },
+    failed{ 0 }, stopping{ false } {
+    int playersCount = (int)playersCmd.size();
+    for (int i = 0; i < n; ++i) {
+        Seat seat;
+        if (swap) {
+            std::vector<int> seedRotate = seeder.get().getSeed(playersCount);
+            seat.seed = seedRotate[0];
+            seat.rotation = seedRotate[1] % playersCount;
+        }
+        else {
+            seat.seed = seeder.get().nextSeed();
+        }
+        seats.push_back(seat);
+        queue.push_back(i);
+    }
+}
+
+std::vector<int> WatchScheduler::rebuild(const std::vector<std::string>& playersCmd) {
+    std::vector<int> outdated;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto& game : inFlight) {
+            outdated.push_back(game.first);
+        }
+        inFlight.clear();
+
+        for (Seat& seat : seats) {
+            if (seat.current >= 0.0) seat.last = seat.current;
+            seat.current = -1.0;
+        }
+
+        //what the last build lost first, then its draws, then what nothing played yet, then its wins
+        queue.clear();
+        for (double last : { 0.0, 0.5, -1.0, 1.0 }) {
+            for (int i = 0; i < (int)seats.size(); ++i) {
+                if (seats[i].last == last) queue.push_back(i);
+            }
+        }
+
+        this->playersCmd = playersCmd;
+        build++;
+        played = 0;
+        points = 0.0;
+        paired = 0;
+        pairedPoints = 0.0;
+        pairedLast = 0.0;
+        failed = 0;
+    }
+    m_cv.notify_all();
+    return outdated;
+}
+
+void WatchScheduler::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        stopping = true;
+    }
+    m_cv.notify_all();
+}
+
+bool WatchScheduler::next(GameOrder& order) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this] { return stopping || !queue.empty(); });
+    if (stopping) return false;
+
+    int index = queue.front();
+    queue.pop_front();
+    order.players = playersCmd;
+    order.seed = seats[index].seed;
+    order.rotation = seats[index].rotation;
+    order.tag = build;
+    order.game = ++games;
+    inFlight[order.game] = index;
+    return true;
+}
+
+void WatchScheduler::report(const GameOrder& order, const std::vector<int>& scores) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    //a game of an outdated build, cancelled or not, counts for nothing
+    auto found = inFlight.find(order.game);
+    if (order.tag != build || found == inFlight.end()) return;
+    Seat& seat = seats[found->second];
+    inFlight.erase(found);
+
+    if (scores.size() < 2) {
+        failed++;
+        progress();
+        return;
+    }
+
+    //the new mode scores a deactivated bot -1, so the best opponent starts from a real score, not 0
+    int best = scores[1];
+    for (size_t i = 2; i < scores.size(); ++i) {
+        best = std::max(best, scores[i]);
+    }
+    seat.current = scores[0] > best ? 1.0 : (scores[0] < best ? 0.0 : 0.5);
+    played++;
+    points += seat.current;
+    if (seat.last >= 0.0) {
+        paired++;
+        pairedPoints += seat.current;
+        pairedLast += seat.last;
+    }
+    progress();
+}
+
+void WatchScheduler::progress() const {
+    std::string line = std::format("Build {}: {}/{} seeds", build, played, seats.size());
+    if (played > 0) line += std::format(", -p1 {:.1f}%", 100.0 * points / played);
+    if (paired > 0) {
+        line += std::format(", {:+.1f}% on the {} seeds the previous builds played ({:.1f}% then)", 100.0 * (pairedPoints - pairedLast) / paired, paired, 100.0 * pairedLast / paired);
+    }
+    if (failed > 0) line += std::format(", {} failed", failed);
+    std::cout << line << "." << std::endl;
+}
+
+void WatchScheduler::print() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::cout << "Watched " << build << " builds, the last one:" << std::endl;
+    progress();
+}
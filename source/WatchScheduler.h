@@ -0,0 +1,85 @@
+#ifndef WATCHSCHEDULER_H
+#define WATCHSCHEDULER_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+#include "Scheduler.h"
+#include "SeedGenerator.h"
+#include "Mutable.h"
+
+/*
+ * @brief Class describing the watch mode's Scheduler: the one lineup on a fixed set of seeds, replayed for every new build of a bot.
+ *
+ * The seeds and seats are picked once at the start, like a plain run would. Each build plays them all, the seeds -p1
+ * lost with the previous build first, then its draws, then the rest, so a fix shows up within the first games. The
+ * score is compared to the previous build on the same seeds as they come in. Once a build has played every seed,
+ * next() waits for the next build.
+ */
+class WatchScheduler : public Scheduler {
+private:
+    /*
+     * @brief Struct describing one seed of the set.
+     */
+    struct Seat {
+        long long seed = 0;         //< the seed
+        int rotation = 0;           //< the rotation
+        double last = -1.0;         //< -p1's points with the last build that played it, -1 if none did
+        double current = -1.0;      //< -p1's points with the current build, -1 until played
+    };
+
+    std::vector<std::string> playersCmd;    //< the current build's command lines
+    std::vector<Seat> seats;                //< the seed set
+    std::deque<int> queue;                  //< the seeds the current build has left, by index
+    std::map<int, int> inFlight;            //< the seed index of each game of the current build handed out, by game number
+    int build;                              //< the current build, 1 for the one at the start
+    int games;                              //< games handed out so far, over all builds
+    int played;                             //< seeds the current build played
+    double points;                          //< -p1's points with the current build
+    int paired;                             //< seeds the current build played that an earlier build played too
+    double pairedPoints;                    //< -p1's points with the current build on those
+    double pairedLast;                      //< -p1's points with the earlier builds on those
+    int failed;                             //< games of the current build without a result
+    bool stopping;                          //< no more builds, end the threads
+    std::mutex m_mutex;                     //< Mutex protecting everything above.
+    std::condition_variable m_cv;           //< Wakes the threads when a build comes in or on shutdown.
+
+    /*
+     * @brief Prints the current build's progress against the previous one.
+     */
+    void progress() const;
+
+public:
+    /*
+     * @brief Constructs a WatchScheduler object, picking the seeds.
+     *
+     * @param playersCmd the players command lines of the first build.
+     * @param seeder the shared rng seeder.
+     * @param n the number of seeds.
+     * @param swap rotate the seats like -s.
+     */
+    WatchScheduler(const std::vector<std::string>& playersCmd, Mutable<SeedGenerator>& seeder, int n, bool swap);
+
+    /*
+     * @brief Starts a new build: its games replace whatever the previous build had left.
+     *
+     * @param playersCmd the players command lines of the new build.
+     *
+     * @return the game numbers of the previous build still in flight, to cancel.
+     */
+    std::vector<int> rebuild(const std::vector<std::string>& playersCmd);
+
+    /*
+     * @brief Takes no more builds, the threads end.
+     */
+    void shutdown();
+
+    bool next(GameOrder& order) override;
+    void report(const GameOrder& order, const std::vector<int>& scores) override;
+    void print() override;
+};
+
+#endif
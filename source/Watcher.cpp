@@ -0,0 +1,205 @@
+#include "Watcher.h"
+#include "ExePath.h"
+
+#include <sstream>
+#include <chrono>
+#include <algorithm>
+#include <conio.h>
+
+namespace {
+    /*
+     * @brief Struct describing a watched directory and its pending ReadDirectoryChangesW.
+     */
+    struct Directory {
+        std::filesystem::path path;         //< the directory
+        HANDLE handle = INVALID_HANDLE_VALUE;
+        OVERLAPPED overlapped = {};
+        DWORD buffer[4096];                 //< FILE_NOTIFY_INFORMATION records, DWORD aligned
+    };
+
+    /*
+     * @brief Asks for the next changes of a directory.
+     *
+     * @param directory the directory.
+     *
+     * @return success true or false.
+     */
+    bool arm(Directory& directory) {
+        ResetEvent(directory.overlapped.hEvent);
+        return ReadDirectoryChangesW(directory.handle, directory.buffer, sizeof(directory.buffer), FALSE,
+            FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE, NULL, &directory.overlapped, NULL);
+    }
+}
+
+Watcher::Watcher(const std::vector<std::string>& playersCmd, Level verbose)
+    :Threadable{ }, scheduler{ NULL }, cache{ NULL }, playersCmd{ playersCmd }, build{ 1 }, logger{ Logger(verbose) } {
+    //the same files ResultCache::hashCommand reads
+    std::filesystem::path base = ExePath::directory();
+    for (const std::string& cmd : playersCmd) {
+        std::istringstream tokens(cmd);
+        std::string token;
+        while (tokens >> token) {
+            std::error_code error;
+            std::filesystem::path file = base / token;
+            if (!std::filesystem::is_regular_file(file, error)) file = token;
+            if (!std::filesystem::is_regular_file(file, error)) continue;
+
+            file = std::filesystem::absolute(file, error);
+            if (std::find(files.begin(), files.end(), file) == files.end()) files.push_back(file);
+        }
+    }
+}
+
+Logger& Watcher::getLog() { return logger; }
+
+int Watcher::getFileCount() const {
+    return (int)files.size();
+}
+
+void Watcher::setScheduler(WatchScheduler* scheduler) {
+    this->scheduler = scheduler;
+}
+
+void Watcher::setResultCache(ResultCache* cache) {
+    this->cache = cache;
+}
+
+void Watcher::addThread(ThreadedGame* thread) {
+    std::lock_guard<std::mutex> lock(m_threads);
+    threads.push_back(thread);
+}
+
+bool Watcher::shadow(int build, std::vector<std::string>& commands) {
+    std::filesystem::path base = ExePath::directory();
+    std::filesystem::path relative = std::filesystem::path("watch") / std::to_string(build);
+    commands.clear();
+
+    for (const std::string& cmd : playersCmd) {
+        size_t start = cmd.find_first_not_of(' ');
+        size_t end = start == std::string::npos ? std::string::npos : cmd.find(' ', start);
+        std::string executable = start == std::string::npos ? "" : cmd.substr(start, end == std::string::npos ? std::string::npos : end - start);
+
+        //only the executable is locked while it runs, ex. python bot.py needs no copy
+        std::error_code error;
+        std::filesystem::path source = base / executable;
+        if (executable.empty() || !std::filesystem::is_regular_file(source, error)) {
+            commands.push_back(cmd);
+            continue;
+        }
+
+        std::filesystem::path copy = relative / source.filename();
+        std::filesystem::create_directories(base / relative, error);
+        std::filesystem::copy_file(source, base / copy, std::filesystem::copy_options::overwrite_existing, error);
+        if (error) {
+            logger.addLog(Level::VERBOSE, "Cannot copy " + source.string() + " yet: " + error.message() + ".");
+            return false;
+        }
+        commands.push_back(copy.string() + (end == std::string::npos ? "" : cmd.substr(end)));
+    }
+    return true;
+}
+
+bool Watcher::rebuild() {
+    std::vector<std::string> commands;
+    if (!shadow(build + 1, commands)) return false;
+    build++;
+
+    //the bots' hashes are from the previous build
+    if (cache != NULL) cache->refresh();
+
+    std::vector<int> outdated = scheduler->rebuild(commands);
+    {
+        std::lock_guard<std::mutex> lock(m_threads);
+        for (ThreadedGame* thread : threads) {
+            for (int game : outdated) {
+                thread->cancel(game);
+            }
+        }
+    }
+    logger.addLog(Level::INFO, "Build " + std::to_string(build) + ", " + std::to_string(outdated.size()) + " games of the previous build cancelled.");
+
+    //the cancelled processes of the previous build may still be in their grace period, the one before is gone
+    std::error_code error;
+    if (build > 2) std::filesystem::remove_all(ExePath::directory() / "watch" / std::to_string(build - 2), error);
+    return true;
+}
+
+void Watcher::run() {
+    //one ReadDirectoryChangesW per directory holding a watched file
+    std::vector<Directory> directories;
+    directories.reserve(files.size()); //the kernel writes into each one, it must not move
+    for (const std::filesystem::path& file : files) {
+        std::filesystem::path parent = file.parent_path();
+        bool known = false;
+        for (const Directory& directory : directories) {
+            if (directory.path == parent) known = true;
+        }
+        if (known) continue;
+
+        directories.emplace_back();
+        Directory& directory = directories.back();
+        directory.path = parent;
+        directory.handle = CreateFileW(parent.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL,
+            OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, NULL);
+        directory.overlapped.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+        if (directory.handle == INVALID_HANDLE_VALUE || directory.overlapped.hEvent == NULL || !arm(directory)) {
+            logger.addLog(Level::ERR, "Cannot watch " + parent.string() + ", error " + std::to_string(GetLastError()) + ".");
+        }
+    }
+
+    std::vector<HANDLE> events;
+    for (const Directory& directory : directories) {
+        if (directory.overlapped.hEvent != NULL) events.push_back(directory.overlapped.hEvent);
+    }
+
+    bool changed = false;
+    auto lastChange = std::chrono::steady_clock::now();
+    while (!shouldStop()) {
+        DWORD wait = events.empty() ? WAIT_TIMEOUT : WaitForMultipleObjects((DWORD)events.size(), events.data(), FALSE, 200);
+        if (events.empty()) Sleep(200);
+
+        if (wait >= WAIT_OBJECT_0 && wait < WAIT_OBJECT_0 + events.size()) {
+            for (Directory& directory : directories) {
+                if (directory.overlapped.hEvent != events[wait - WAIT_OBJECT_0]) continue;
+
+                DWORD bytes = 0;
+                GetOverlappedResult(directory.handle, &directory.overlapped, &bytes, FALSE);
+                //no bytes means the buffer overflowed, anything may have changed
+                bool hit = bytes == 0;
+                for (DWORD offset = 0; bytes > 0;) {
+                    FILE_NOTIFY_INFORMATION* record = (FILE_NOTIFY_INFORMATION*)((char*)directory.buffer + offset);
+                    std::filesystem::path file = directory.path / std::wstring(record->FileName, record->FileNameLength / sizeof(wchar_t));
+                    if (std::find(files.begin(), files.end(), file) != files.end()) hit = true;
+                    if (record->NextEntryOffset == 0) break;
+                    offset += record->NextEntryOffset;
+                }
+                if (hit) {
+                    changed = true;
+                    lastChange = std::chrono::steady_clock::now();
+                }
+                arm(directory);
+            }
+        }
+
+        if (_kbhit() && (_getch() | 0x20) == 'q') break;
+
+        //a build writes its output in several steps, wait until it is quiet
+        if (changed && std::chrono::steady_clock::now() - lastChange >= std::chrono::milliseconds(QUIET_MS)) {
+            if (rebuild()) changed = false;
+            else lastChange = std::chrono::steady_clock::now();
+        }
+    }
+
+    for (Directory& directory : directories) {
+        if (directory.handle != INVALID_HANDLE_VALUE) {
+            CancelIo(directory.handle);
+            CloseHandle(directory.handle);
+        }
+        if (directory.overlapped.hEvent != NULL) CloseHandle(directory.overlapped.hEvent);
+    }
+
+    //the games in flight finish, nothing new starts
+    scheduler->shutdown();
+    logger.addLog(Level::INFO, "Watch stopped after " + std::to_string(build) + " builds.");
+    setFinished();
+}
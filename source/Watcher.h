@@ -0,0 +1,106 @@
+#ifndef WATCHER_H
+#define WATCHER_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <filesystem>
+#include <windows.h>
+#include "Threadable.h"
+#include "ThreadedGame.h"
+#include "WatchScheduler.h"
+#include "ResultCache.h"
+#include "Logger.h"
+
+/*
+ * @brief Class describing the Watcher, starting a new build in the WatchScheduler whenever a file of a player changes.
+ *
+ * The files are the tokens of the players command lines naming a file, the same ones the result cache hashes. A change
+ * counts once the files have been quiet for a moment, so a build writing its output in several steps restarts the run
+ * once. The games of the outdated build still in flight are cancelled.
+ *
+ * Windows does not let a build overwrite a running executable, so each player's executable runs from a copy per build,
+ * watch\<build>\<file> next to the tester.
+ */
+class Watcher : public Threadable {
+private:
+    WatchScheduler* scheduler;                      //< The scheduler the builds go to.
+    ResultCache* cache;                             //< Shared result cache, NULL if not used.
+    std::vector<std::string> playersCmd;            //< the players command lines as given
+    std::vector<std::filesystem::path> files;       //< the watched files
+    std::vector<ThreadedGame*> threads;             //< the game threads, to cancel their games
+    std::mutex m_threads;                           //< Mutex protecting threads.
+    int build;                                      //< the current build
+    Logger logger;                                  //< The log object.
+
+    const static int QUIET_MS = 500;                //< how long the files must not change before a build counts
+
+    /*
+     * @brief Starts the next build: copies the executables, hands the build to the scheduler and cancels the outdated games.
+     *
+     * @return success true or false, false if a file cannot be copied yet.
+     */
+    bool rebuild();
+
+protected:
+    /*
+     * @brief The run method from the Threadable base class we must overide.
+     */
+    void run() override;
+
+public:
+    /*
+     * @brief Constructs a Watcher object, finding the files to watch.
+     *
+     * @param playersCmd the players command lines.
+     * @param verbose The verbosity to use for the logs.
+     */
+    Watcher(const std::vector<std::string>& playersCmd, Level verbose);
+
+    /*
+     * @brief Copies each player's executable for a build and gives the command lines running the copies.
+     *
+     * @param build the build.
+     * @param commands Set to the command lines.
+     *
+     * @return success true or false.
+     */
+    bool shadow(int build, std::vector<std::string>& commands);
+
+    /*
+     * @brief Sets the scheduler the builds go to. Call before start().
+     *
+     * @param scheduler the scheduler.
+     */
+    void setScheduler(WatchScheduler* scheduler);
+
+    /*
+     * @brief Sets the result cache, its hashes are refreshed for every build.
+     *
+     * @param cache the shared result cache, NULL if not used.
+     */
+    void setResultCache(ResultCache* cache);
+
+    /*
+     * @brief Adds a game thread whose games may need cancelling. Thread safe.
+     *
+     * @param thread the thread.
+     */
+    void addThread(ThreadedGame* thread);
+
+    /*
+     * @brief Gets the number of watched files.
+     *
+     * @return the number of files.
+     */
+    int getFileCount() const;
+
+    /*
+     * @brief Gets the log.
+     *
+     * @return the log.
+     */
+    Logger& getLog();
+};
+
+#endif
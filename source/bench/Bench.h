@@ -0,0 +1,46 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <chrono>
+#include <string>
+#include <iostream>
+#include <iomanip>
+
+/*
+ * @brief Keeps the compiler from optimizing away a result that is never used.
+ *
+ * @param value The result.
+ */
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    static volatile const void* sink;
+    sink = &value;
+}
+
+/*
+ * @brief Times a function called in a loop, after a warm up, and prints the time per call.
+ *
+ * @param name The name of the benchmark.
+ * @param iterations The number of calls to time.
+ * @param f The function, called with the iteration number.
+ *
+ * @return the time per call in ns.
+ */
+template <typename F>
+double runBenchmark(const std::string& name, long long iterations, F f) {
+    for (long long i = 0; i < iterations / 10; ++i) {
+        f(i);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (long long i = 0; i < iterations; ++i) {
+        f(i);
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    double perCall = (double)elapsed / (double)iterations;
+    std::cout << std::left << std::setw(40) << name << std::right << std::setw(12) << std::fixed << std::setprecision(1) << perCall << " ns/op\n";
+    return perCall;
+}
+
+#endif
@@ -0,0 +1,370 @@
+#include <vector>
+#include <string>
+#include <string_view>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <filesystem>
+#include <windows.h>
+
+/*
+ * The harness benchmark runs the real tester on synthetic games, so what it measures is the tester itself: the
+ * referee and the bots do nothing but move a payload around. Copies of this executable play them, told apart by
+ * their file name, and they get their settings from the environment, which the tester passes on to them.
+ *
+ * The old mode referee talks to the bots through the tester, so its turn time is the harness round trip.
+ * The new mode referee talks to the bots itself, so its turn time is the floor without the harness.
+ */
+namespace {
+    const int TURNS = 100;                                      //< turns per game, each player answers once per turn
+    const wchar_t* OLD_REFEREE = L"bench-old-referee.exe";      //< the copy playing the old mode referee
+    const wchar_t* NEW_REFEREE = L"bench-new-referee.exe";      //< the copy playing the new mode referee
+    const wchar_t* ECHO_BOT = L"bench-echo-bot.exe";            //< the copy playing the bots
+    const wchar_t* STATS = L"bench-harness.stats";              //< the referees append "round trips" "ns" per game here
+
+    /*
+     * @brief Struct describing a child process of the new mode referee, with its pipes.
+     */
+    struct Child {
+        HANDLE process = NULL;      //< the process
+        HANDLE in = NULL;           //< the write end of its stdin
+        HANDLE out = NULL;          //< the read end of its stdout
+        std::string buffer;         //< read from its stdout, not taken yet
+    };
+
+    std::filesystem::path exeDir() {
+        wchar_t path_exe[MAX_PATH];
+        GetModuleFileName(NULL, path_exe, MAX_PATH);
+        return std::filesystem::path(path_exe).parent_path();
+    }
+
+    long long environmentNumber(const char* name, long long fallback) {
+        char value[32];
+        DWORD size = GetEnvironmentVariableA(name, value, sizeof(value));
+        if (size == 0 || size >= sizeof(value)) return fallback;
+        return std::stoll(value);
+    }
+
+    bool writeAll(HANDLE handle, std::string_view data) {
+        while (!data.empty()) {
+            DWORD written = 0;
+            if (!WriteFile(handle, data.data(), (DWORD)data.size(), &written, NULL) || written == 0) return false;
+            data.remove_prefix(written);
+        }
+        return true;
+    }
+
+    bool readLine(HANDLE handle, std::string& buffer, std::string& line) {
+        size_t end;
+        while ((end = buffer.find('\n')) == std::string::npos) {
+            char chunk[4096];
+            DWORD read = 0;
+            if (!ReadFile(handle, chunk, sizeof(chunk), &read, NULL) || read == 0) return false;
+            buffer.append(chunk, read);
+        }
+        line.assign(buffer, 0, end);
+        if (line.ends_with('\r')) line.pop_back();
+        buffer.erase(0, end + 1);
+        return true;
+    }
+
+    bool startChild(const std::filesystem::path& path, Child& child) {
+        SECURITY_ATTRIBUTES saAttr;
+        saAttr.nLength = sizeof(SECURITY_ATTRIBUTES);
+        saAttr.bInheritHandle = TRUE;
+        saAttr.lpSecurityDescriptor = NULL;
+
+        HANDLE inRead, outWrite;
+        if (!CreatePipe(&inRead, &child.in, &saAttr, 0)) return false;
+        if (!CreatePipe(&child.out, &outWrite, &saAttr, 0)) return false;
+        SetHandleInformation(child.in, HANDLE_FLAG_INHERIT, 0);
+        SetHandleInformation(child.out, HANDLE_FLAG_INHERIT, 0);
+
+        STARTUPINFOW startup_info;
+        ZeroMemory(&startup_info, sizeof(STARTUPINFOW));
+        startup_info.cb = sizeof(STARTUPINFOW);
+        startup_info.dwFlags = STARTF_USESTDHANDLES;
+        startup_info.hStdInput = inRead;
+        startup_info.hStdOutput = outWrite;
+        startup_info.hStdError = GetStdHandle(STD_ERROR_HANDLE);
+
+        PROCESS_INFORMATION process_info;
+        std::wstring commandLine = L"\"" + path.wstring() + L"\"";
+        bool started = CreateProcessW(NULL, commandLine.data(), NULL, NULL, TRUE, 0, NULL, NULL, &startup_info, &process_info);
+        CloseHandle(inRead);
+        CloseHandle(outWrite);
+        if (!started) return false;
+
+        CloseHandle(process_info.hThread);
+        child.process = process_info.hProcess;
+        return true;
+    }
+
+    void appendStats(long long roundTrips, long long ns) {
+        //one short write with FILE_APPEND_DATA, so the referees of all the threads can share the file
+        HANDLE file = CreateFileW((exeDir() / STATS).c_str(), FILE_APPEND_DATA, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file == INVALID_HANDLE_VALUE) return;
+        writeAll(file, std::to_string(roundTrips) + " " + std::to_string(ns) + "\n");
+        CloseHandle(file);
+    }
+
+    int echoBot() {
+        HANDLE in = GetStdHandle(STD_INPUT_HANDLE);
+        HANDLE out = GetStdHandle(STD_OUTPUT_HANDLE);
+        std::string buffer, line;
+        while (readLine(in, buffer, line)) {
+            line += '\n';
+            if (!writeAll(out, line)) return 1;
+        }
+        return 0;
+    }
+
+    int oldReferee() {
+        HANDLE in = GetStdHandle(STD_INPUT_HANDLE);
+        HANDLE out = GetStdHandle(STD_OUTPUT_HANDLE);
+        std::string payload(environmentNumber("BENCH_PAYLOAD", 16), 'x');
+        int turns = (int)environmentNumber("BENCH_TURNS", TURNS);
+
+        //###Seed may come first
+        std::string buffer, line;
+        int players = 0;
+        while (players == 0) {
+            if (!readLine(in, buffer, line)) return 1;
+            if (line.starts_with("###Start ")) players = std::stoi(line.substr(9));
+        }
+
+        long long ns = 0;
+        for (int turn = 0; turn < turns; ++turn) {
+            for (int player = 0; player < players; ++player) {
+                std::string block = "###Input " + std::to_string(player) + "\n" + payload + "\n###Output " + std::to_string(player) + " 1\n";
+                auto start = std::chrono::steady_clock::now();
+                if (!writeAll(out, block) || !readLine(in, buffer, line)) return 1;
+                ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+            }
+        }
+
+        //the stats go first, the tester may end the referee as soon as it has the ranking
+        appendStats((long long)turns * players, ns);
+        std::string ranking = "###End ";
+        for (int player = 0; player < players; ++player) ranking += std::to_string(player);
+        writeAll(out, ranking + "\n");
+        return 0;
+    }
+
+    int newReferee(int argc, char** argv) {
+        HANDLE out = GetStdHandle(STD_OUTPUT_HANDLE);
+        std::string payload(environmentNumber("BENCH_PAYLOAD", 16), 'x');
+        payload += '\n';
+        int turns = (int)environmentNumber("BENCH_TURNS", TURNS);
+
+        //-p1 <bot> -p2 <bot> ..., -d and -l are ignored, the bots are found next to the referee like the tester finds them
+        std::vector<Child> bots;
+        for (int i = 1; i + 1 < argc; ++i) {
+            std::string_view arg = argv[i];
+            if (arg.size() > 2 && arg.starts_with("-p")) {
+                std::filesystem::path bot = argv[++i];
+                if (bot.is_relative()) bot = exeDir() / bot;
+                bots.emplace_back();
+                if (!startChild(bot, bots.back())) return 1;
+            }
+        }
+
+        long long ns = 0;
+        std::string line;
+        for (int turn = 0; turn < turns; ++turn) {
+            for (Child& bot : bots) {
+                auto start = std::chrono::steady_clock::now();
+                if (!writeAll(bot.in, payload) || !readLine(bot.out, bot.buffer, line)) return 1;
+                ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+            }
+        }
+
+        //closing stdin ends the bots, then every player gets the same score
+        for (Child& bot : bots) {
+            CloseHandle(bot.in);
+            WaitForSingleObject(bot.process, INFINITE);
+            CloseHandle(bot.out);
+            CloseHandle(bot.process);
+        }
+        appendStats((long long)turns * bots.size(), ns);
+        std::string scores;
+        for (size_t i = 0; i < bots.size(); ++i) scores += "0\n";
+        writeAll(out, scores);
+        return 0;
+    }
+
+    std::vector<int> parseList(const std::string& list) {
+        std::vector<int> values;
+        std::istringstream fields(list);
+        std::string field;
+        while (std::getline(fields, field, ',')) {
+            if (!field.empty()) values.push_back(std::stoi(field));
+        }
+        return values;
+    }
+
+    /*
+     * @brief Struct describing the measures of one run of the tester.
+     */
+    struct Measure {
+        std::string mode;           //< "new" or "old"
+        int threads = 0;            //< -t
+        int payload = 0;            //< bytes per line, each way
+        long long games = 0;        //< games the referees finished
+        long long roundTrips = 0;   //< player answers over all the games
+        double seconds = 0.0;       //< wall time of the tester
+        double turnNs = 0.0;        //< referee side time per answer
+        double cpuSeconds = 0.0;    //< user and kernel time of the tester's own threads
+        unsigned long long ioCalls = 0; //< read and write calls of the tester
+    };
+
+    bool runTester(const std::filesystem::path& tester, bool old, int threads, int payload, long long games, Measure& measure) {
+        std::filesystem::path stats = exeDir() / STATS;
+        std::filesystem::remove(stats);
+        SetEnvironmentVariableA("BENCH_PAYLOAD", std::to_string(payload).c_str());
+        SetEnvironmentVariableA("BENCH_TURNS", std::to_string(TURNS).c_str());
+
+        std::wstring commandLine = L"\"" + tester.wstring() + L"\" -r " + (old ? OLD_REFEREE : NEW_REFEREE);
+        commandLine += std::wstring(L" -p1 ") + ECHO_BOT + L" -p2 " + ECHO_BOT;
+        commandLine += L" -n " + std::to_wstring(games) + L" -t " + std::to_wstring(threads) + (old ? L" -o" : L"");
+
+        //the tester's report goes nowhere, only its cost is wanted
+        SECURITY_ATTRIBUTES saAttr;
+        saAttr.nLength = sizeof(SECURITY_ATTRIBUTES);
+        saAttr.bInheritHandle = TRUE;
+        saAttr.lpSecurityDescriptor = NULL;
+        HANDLE nul = CreateFileW(L"NUL", GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, &saAttr, OPEN_EXISTING, 0, NULL);
+
+        STARTUPINFOW startup_info;
+        ZeroMemory(&startup_info, sizeof(STARTUPINFOW));
+        startup_info.cb = sizeof(STARTUPINFOW);
+        startup_info.dwFlags = STARTF_USESTDHANDLES;
+        startup_info.hStdInput = nul;
+        startup_info.hStdOutput = nul;
+        startup_info.hStdError = nul;
+
+        PROCESS_INFORMATION process_info;
+        auto start = std::chrono::steady_clock::now();
+        bool started = CreateProcessW(NULL, commandLine.data(), NULL, NULL, TRUE, 0, NULL, exeDir().c_str(), &startup_info, &process_info);
+        CloseHandle(nul);
+        if (!started) return false;
+        WaitForSingleObject(process_info.hProcess, INFINITE);
+        measure.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        //the referees and the bots are processes of their own, so these are the tester's threads only
+        FILETIME created, exited, kernel, user;
+        GetProcessTimes(process_info.hProcess, &created, &exited, &kernel, &user);
+        auto ticks = [](const FILETIME& time) { return ((unsigned long long)time.dwHighDateTime << 32) | time.dwLowDateTime; };
+        measure.cpuSeconds = (ticks(kernel) + ticks(user)) / 1e7;
+
+        IO_COUNTERS io;
+        if (GetProcessIoCounters(process_info.hProcess, &io)) {
+            measure.ioCalls = io.ReadOperationCount + io.WriteOperationCount;
+        }
+        CloseHandle(process_info.hThread);
+        CloseHandle(process_info.hProcess);
+
+        measure.mode = old ? "old" : "new";
+        measure.threads = threads;
+        measure.payload = payload;
+        long long ns = 0;
+        std::ifstream lines(stats);
+        long long roundTrips, gameNs;
+        while (lines >> roundTrips >> gameNs) {
+            measure.games++;
+            measure.roundTrips += roundTrips;
+            ns += gameNs;
+        }
+        measure.turnNs = measure.roundTrips > 0 ? (double)ns / measure.roundTrips : 0.0;
+        return measure.games > 0;
+    }
+
+    void writeJson(std::ostream& out, const std::vector<Measure>& measures, long long games) {
+        out << std::fixed << std::setprecision(3);
+        out << "{\n  \"benchmark\": \"harness\",\n  \"gamesPerRun\": " << games << ",\n  \"turns\": " << TURNS << ",\n  \"players\": 2,\n  \"results\": [\n";
+        for (size_t i = 0; i < measures.size(); ++i) {
+            const Measure& m = measures[i];
+            double turns = m.roundTrips > 0 ? (double)m.roundTrips : 1.0;
+            out << "    {\"mode\": \"" << m.mode << "\", \"threads\": " << m.threads << ", \"payload\": " << m.payload
+                << ", \"games\": " << m.games << ", \"seconds\": " << m.seconds
+                << ", \"gamesPerSecond\": " << (m.seconds > 0.0 ? m.games / m.seconds : 0.0)
+                << ", \"turnLatencyUs\": " << m.turnNs / 1000.0
+                << ", \"ioCallsPerTurn\": " << m.ioCalls / turns
+                << ", \"harnessCpuSeconds\": " << m.cpuSeconds
+                << ", \"harnessCpuPerTurnUs\": " << m.cpuSeconds * 1e6 / turns
+                << ", \"harnessCpuUse\": " << (m.seconds > 0.0 ? m.cpuSeconds / m.seconds : 0.0) << "}"
+                << (i + 1 < measures.size() ? ",\n" : "\n");
+        }
+        out << "  ]\n}\n";
+    }
+}
+
+std::string harnessRole() {
+    wchar_t path_exe[MAX_PATH];
+    GetModuleFileName(NULL, path_exe, MAX_PATH);
+    std::filesystem::path name = std::filesystem::path(path_exe).filename();
+
+    if (name == OLD_REFEREE) return "old-referee";
+    if (name == NEW_REFEREE) return "new-referee";
+    if (name == ECHO_BOT) return "echo-bot";
+    return "";
+}
+
+int runHarnessRole(const std::string& role, int argc, char** argv) {
+    if (role == "old-referee") return oldReferee();
+    if (role == "new-referee") return newReferee(argc, argv);
+    return echoBot();
+}
+
+int runHarnessBench(long long games, const std::string& threadsList, const std::string& payloadsList, const std::string& output) {
+    std::filesystem::path tester = exeDir() / "new-cg-brutal-tester.exe";
+    if (!std::filesystem::exists(tester)) {
+        std::cerr << "Error: new-cg-brutal-tester.exe must be next to the bench executable." << std::endl;
+        return 1;
+    }
+
+    //the tester starts the referees and the bots from its own directory, so the copies go there
+    wchar_t path_exe[MAX_PATH];
+    GetModuleFileName(NULL, path_exe, MAX_PATH);
+    for (const wchar_t* copy : { OLD_REFEREE, NEW_REFEREE, ECHO_BOT }) {
+        if (!CopyFileW(path_exe, (exeDir() / copy).c_str(), FALSE)) {
+            std::cerr << "Error: could not copy the bench executable. Code:" << GetLastError() << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "Harness, " << games << " games of " << TURNS << " turns per run\n";
+    std::cout << std::left << std::setw(6) << "mode" << std::right << std::setw(8) << "threads" << std::setw(9) << "payload"
+        << std::setw(12) << "games/s" << std::setw(12) << "us/turn" << std::setw(12) << "io/turn" << std::setw(12) << "cpu use" << "\n";
+
+    std::vector<Measure> measures;
+    for (bool old : { false, true }) {
+        for (int threads : parseList(threadsList)) {
+            for (int payload : parseList(payloadsList)) {
+                Measure measure;
+                if (!runTester(tester, old, threads, payload, games, measure)) {
+                    std::cerr << "Error: the " << (old ? "old" : "new") << " mode run with " << threads << " threads and " << payload << " bytes gave no games." << std::endl;
+                    continue;
+                }
+                measures.push_back(measure);
+
+                double turns = measure.roundTrips > 0 ? (double)measure.roundTrips : 1.0;
+                std::cout << std::left << std::setw(6) << measure.mode << std::right << std::setw(8) << threads << std::setw(9) << payload
+                    << std::fixed << std::setprecision(1) << std::setw(12) << measure.games / measure.seconds
+                    << std::setw(12) << measure.turnNs / 1000.0 << std::setw(12) << measure.ioCalls / turns
+                    << std::setprecision(2) << std::setw(12) << measure.cpuSeconds / measure.seconds << "\n";
+            }
+        }
+    }
+
+    std::ofstream json(output, std::ofstream::out | std::ofstream::trunc);
+    if (json.fail()) {
+        std::cerr << "Error: could not write " << output << std::endl;
+        return 1;
+    }
+    writeJson(json, measures, games);
+    std::cout << "Results written to " << output << "\n";
+    return 0;
+}
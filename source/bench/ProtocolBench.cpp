@@ -0,0 +1,78 @@
+#include <vector>
+#include <string>
+#include <string_view>
+#include "Bench.h"
+#include "../OldProtocol.h"
+
+namespace {
+    //a turn of a typical 2 player game, as the referee writes it
+    const std::vector<std::string> lines = {
+        "###Input 0",
+        "###Output 0 1",
+        "###Input 1",
+        "###Output 1 1",
+        "###Error 1 Timeout: the player did not answer in time",
+        "###Output 12 3",
+        "###Seed -5842977612873263",
+        "###End 01 2",
+        "6 4 11 3 8",
+    };
+
+    //what the protocol loop did before OldProtocol, for comparison
+    std::vector<std::string_view> splitString(std::string_view str, char delimiter) {
+        std::vector<std::string_view> result;
+        std::size_t start = 0;
+        while (start < str.size()) {
+            std::size_t end = str.find(delimiter, start);
+            if (end == std::string_view::npos) {
+                result.emplace_back(str.substr(start));
+                break;
+            }
+            result.emplace_back(str.substr(start, end - start));
+            start = end + 1;
+        }
+        return result;
+    }
+
+    int toInteger(std::string_view s) {
+        int result = 0;
+        for (char c : s) {
+            result = result * 10 + static_cast<int>(c) - static_cast<int>('0');
+        }
+        return result;
+    }
+}
+
+int runProtocolBench(long long iterations) {
+    std::cout << "Old protocol parser, " << iterations << " lines per benchmark\n";
+
+    runBenchmark("OldProtocol::parse", iterations, [](long long i) {
+        OldCommand command;
+        bool valid = OldProtocol::parse(lines[i % lines.size()], command);
+        doNotOptimize(valid);
+        doNotOptimize(command);
+    });
+
+    runBenchmark("OldProtocol::parse ###Output", iterations, [](long long i) {
+        OldCommand command;
+        OldProtocol::parse(lines[1], command);
+        doNotOptimize(command);
+    });
+
+    runBenchmark("starts_with + splitString (before)", iterations, [](long long i) {
+        const std::string& line = lines[i % lines.size()];
+        int target = -1, count = 0;
+        if (line.starts_with("###Input")) {
+            target = toInteger(std::string_view(line).substr(9, 1));
+        }
+        else if (line.starts_with("###Output")) {
+            std::vector<std::string_view> parts = splitString(line, ' ');
+            target = toInteger(parts[1]);
+            count = toInteger(parts[2]);
+        }
+        doNotOptimize(target);
+        doNotOptimize(count);
+    });
+
+    return 0;
+}
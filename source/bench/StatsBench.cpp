@@ -0,0 +1,118 @@
+#include <vector>
+#include <string>
+#include <string_view>
+#include <random>
+#include <algorithm>
+#include "Bench.h"
+#include "../PlayerStats.h"
+#include "../SeedGenerator.h"
+#include "../StringUtils.h"
+#include "../RefereeCommand.h"
+
+namespace {
+    /*
+     * @brief Struct describing the inputs of a number of players, made once so the benchmarks time only the calls.
+     */
+    struct Inputs {
+        std::vector<std::vector<int> > scores;      //< new mode scores, some of them tied
+        std::vector<std::string> rankings;          //< old mode rankings, ex. "###End 0 12"
+        std::vector<std::string> outcomes;          //< cached outcomes, ex. "12 -3 7"
+        std::vector<std::string> playersCmd;        //< player command lines
+    };
+
+    const int SAMPLES = 64;     //< different inputs cycled through, so no branch is always taken
+
+    Inputs makeInputs(int players) {
+        Inputs inputs;
+        std::mt19937 rng(players);
+        for (int s = 0; s < SAMPLES; ++s) {
+            std::vector<int> scores;
+            std::string outcome;
+            for (int p = 0; p < players; ++p) {
+                scores.push_back((int)(rng() % 5) - 1);
+                outcome += (p > 0 ? " " : "") + std::to_string(scores.back() * 17);
+            }
+            inputs.scores.push_back(scores);
+            inputs.outcomes.push_back(outcome);
+
+            //a shuffled order, with the neighbours sometimes tied in one group
+            std::vector<int> order(players);
+            for (int p = 0; p < players; ++p) order[p] = p;
+            std::shuffle(order.begin(), order.end(), rng);
+            std::string ranking = "###End";
+            for (int p = 0; p < players; ++p) {
+                if (p == 0 || rng() % 4 != 0) ranking += ' ';
+                ranking += (char)('0' + order[p]);
+            }
+            inputs.rankings.push_back(ranking);
+        }
+        for (int p = 0; p < players; ++p) {
+            inputs.playersCmd.push_back("bots\\contender-v" + std::to_string(p + 10) + ".exe");
+        }
+        return inputs;
+    }
+
+    void benchPlayers(int players, long long iterations) {
+        Inputs inputs = makeInputs(players);
+        std::string suffix = " (" + std::to_string(players) + " players)";
+
+        PlayerStats stats(players);
+        runBenchmark("PlayerStats::add(scores)" + suffix, iterations, [&](long long i) {
+            stats.add(inputs.scores[i % SAMPLES]);
+        });
+        doNotOptimize(stats);
+
+        PlayerStats ranked(players);
+        runBenchmark("PlayerStats::add(ranking)" + suffix, iterations, [&](long long i) {
+            ranked.add(inputs.rankings[i % SAMPLES]);
+        });
+        doNotOptimize(ranked);
+
+        runBenchmark("PlayerStats::rankingToScores" + suffix, iterations, [&](long long i) {
+            std::vector<int> scores = PlayerStats::rankingToScores(inputs.rankings[i % SAMPLES], players);
+            doNotOptimize(scores);
+        });
+
+        SeedGenerator seeder;
+        seeder.initialSeed(42);
+        runBenchmark("SeedGenerator::getSeed" + suffix, iterations, [&](long long i) {
+            std::vector<int> seedRotate = seeder.getSeed(players);
+            doNotOptimize(seedRotate);
+        });
+
+        runBenchmark("splitString outcome" + suffix, iterations, [&](long long i) {
+            std::vector<std::string_view> parts = StringUtils::splitString(inputs.outcomes[i % SAMPLES], ' ');
+            doNotOptimize(parts);
+        });
+
+        //the referee arguments of GameThread: -p1 <cmd> ... -d seed=<seed> -l <log file>
+        RefereeCommand command(inputs.playersCmd, true, true);
+
+        runBenchmark("RefereeCommand::join" + suffix, iterations, [&](long long i) {
+            std::string args(command.join());
+            doNotOptimize(args);
+        });
+
+        //what GameThread::run does per game with -s: seed, rotate the seats, name the log, join
+        SeedGenerator swapSeeder;
+        swapSeeder.initialSeed(42);
+        runBenchmark("GameThread command assembly" + suffix, iterations, [&](long long i) {
+            std::vector<int> seedRotate = swapSeeder.getSeed(players);
+            command.setSeed(seedRotate[0]);
+            command.seat(inputs.playersCmd, seedRotate[1]);
+            command.setReplay("logs/Game" + std::to_string(i) + ".json");
+            std::string args(command.join());
+            doNotOptimize(args);
+        });
+    }
+}
+
+int runStatsBench(long long iterations) {
+    std::cout << "Per game stats, seed and string paths, " << iterations << " calls per benchmark\n";
+
+    for (int players : { 2, 3, 4, 8 }) {
+        benchPlayers(players, iterations);
+    }
+
+    return 0;
+}
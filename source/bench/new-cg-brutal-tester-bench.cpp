@@ -0,0 +1,60 @@
+#include <iostream>
+#include <string>
+
+int runProtocolBench(long long iterations);
+int runStatsBench(long long iterations);
+std::string harnessRole();
+int runHarnessRole(const std::string& role, int argc, char** argv);
+int runHarnessBench(long long games, const std::string& threads, const std::string& payloads, const std::string& output);
+
+/*
+ * @brief Prints the usage.
+ */
+void usage() {
+    std::cout << "Usage: new-cg-brutal-tester-bench <benchmark> [iterations]\n";
+    std::cout << "       new-cg-brutal-tester-bench harness [games] [threads] [payloads]\n";
+    std::cout << "Benchmarks:\n";
+    std::cout << "  protocol    the old protocol command parser\n";
+    std::cout << "  stats       PlayerStats, SeedGenerator and the per game command assembly, for 2, 3, 4 and 8 players\n";
+    std::cout << "  all         every benchmark above\n";
+    std::cout << "  harness     the tester itself, with synthetic referees and echo bots, in both modes. Needs\n";
+    std::cout << "              new-cg-brutal-tester.exe next to this one. Default 20 games per run, threads 1,2,4,8\n";
+    std::cout << "              and payloads 16,1024,16384 bytes. Writes HarnessBench.json\n";
+}
+
+int main(int argc, char** argv) {
+    //copies of this executable play the referees and the bots of the harness benchmark
+    std::string role = harnessRole();
+    if (role != "") {
+        return runHarnessRole(role, argc, argv);
+    }
+
+    if (argc < 2) {
+        usage();
+        return 1;
+    }
+
+    std::string benchmark = argv[1];
+    if (benchmark == "harness") {
+        return runHarnessBench(argc > 2 ? std::stoll(argv[2]) : 20, argc > 3 ? argv[3] : "1,2,4,8", argc > 4 ? argv[4] : "16,1024,16384", "HarnessBench.json");
+    }
+
+    long long iterations = argc > 2 ? std::stoll(argv[2]) : 10000000;
+
+    bool ran = false;
+    if (benchmark == "protocol" || benchmark == "all") {
+        runProtocolBench(iterations);
+        ran = true;
+    }
+    if (benchmark == "stats" || benchmark == "all") {
+        runStatsBench(iterations);
+        ran = true;
+    }
+
+    if (!ran) {
+        usage();
+        return 1;
+    }
+
+    return 0;
+}
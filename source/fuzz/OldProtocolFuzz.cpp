@@ -0,0 +1,39 @@
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <string_view>
+#include "../OldProtocol.h"
+
+/*
+ * @brief libFuzzer entry point for OldProtocol::parse. Any crash, or a view pointing outside the line, is a bug.
+ *
+ * Build and run, from a x64 Native Tools prompt in source/fuzz:
+ *   cl /std:c++20 /EHsc /Zi /fsanitize=address /fsanitize=fuzzer OldProtocolFuzz.cpp ..\OldProtocol.cpp
+ *   OldProtocolFuzz.exe corpus\old-protocol
+ */
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    std::string_view line(reinterpret_cast<const char*>(data), size);
+
+    OldCommand command;
+    bool valid = OldProtocol::parse(line, command);
+
+    //the text must be a slice of the line
+    if (!command.text.empty()
+        && (command.text.data() < line.data() || command.text.data() + command.text.size() > line.data() + line.size())) {
+        abort();
+    }
+
+    if (valid) {
+        //targets and counts are only ever valid indexes
+        if ((command.type == CMD_INPUT || command.type == CMD_OUTPUT) && command.player < 0) abort();
+        if (command.type == CMD_OUTPUT && command.count < 0) abort();
+        if (command.type == CMD_START && command.count <= 0) abort();
+    }
+
+    //only commands carry a payload
+    if (command.type == CMD_NONE && (command.player != -1 || command.count != 0 || command.seed != 0 || !command.text.empty())) {
+        abort();
+    }
+
+    return 0;
+}
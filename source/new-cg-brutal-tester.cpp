@@ -1,213 +1,808 @@
-#include "Mutable.h"
-#include "CommandCLI.h"
-#include "Logger.h"
-#include "SeedGenerator.h"
-#include "PlayerStats.h"
-#include "OldGameThread.h"
-#include "GameThread.h"
-
-LONG WINAPI GlobalSEHHandler(EXCEPTION_POINTERS* ExceptionInfo) {
-    std::cout << "Exception occurred" << std::endl;
-    return EXCEPTION_EXECUTE_HANDLER;
-}
-
-using namespace CommandCLI;
-
-void finished(PlayerStats stats, Logger log) {
-    stats.print();
-    bool saved = false;
-    if (log.getPath() != "" && log.getFile() != "") saved = log.SaveLogs();
-    if (!saved) {
-        std::cout << "Warning: Logs not Saved!" << std::endl;
-    }
-    exit(0);
-}
-
-int main(int argc, char* argv[]) {
-    SetUnhandledExceptionFilter(GlobalSEHHandler);
-
-    Options opt = Options();
-    opt.Add("-h", false, "Displays this help.");
-    opt.Add("-r", true, "Required. Referee command line.");
-    opt.Add("-p1", true, "Required. Player 1 command line.");
-    opt.Add("-p2", true, "Required. Player 2 command line.");
-    opt.Add("-P3", true, "Player 3 command line.");
-    opt.Add("-P4", true, "Player 4 command line.");
-    opt.Add("-v", true, "Visualizer command line. Not implemented, hard sets threads to 1.");
-    opt.Add("-t", true, "Number of threads to spawn for the games. Default 1.");
-    opt.Add("-n", true, "Number of games to play. Default 1.");
-    opt.Add("-s", false, "Swap player positions.");
-    opt.Add("-i", true, "Initial seed. For repetable tests");
-    opt.Add("-d", true, "Log directory.");
-    opt.Add("-l", true, "Log level. 0 verbose, 1 info, 2 warning (default), 3 error, and 4 fatal. Only logs that level and higher. ex. if set to 3, only error and fatal levels logs are created.");
-    opt.Add("-o", false, "Old mode");
-
-    DefaultParser cmd = DefaultParser(argc, argv, opt);
-
-    // Need help ?
-    if (cmd.hasOption("-h") || !cmd.hasOption("-r") || !cmd.hasOption("-p1") || !cmd.hasOption("-p2")) {
-        opt.PrintHelp(argv[0]);
-        exit(0);
-    }
-
-    //setup logging
-    Logger logger = cmd.hasOption("-l") ? Logger((Level)std::stoi(cmd.getOptionValue("-l"))) : Logger();
-
-    std::string level = Logger::levelToString(logger.getVerbosity());
-
-    std::string logString = "Logger set up with level ";
-    logString += level + " logging.";
-    logger.addLog(Level::INFO, logString);
-
-    std::string refereeCmd = cmd.getOptionValue("-r");
-
-    // Players command lines
-    std::vector<std::string> playersCmd;
-    std::string test = "";
-    for (int i = 1; i <= 4; ++i) {
-        test = "-p" + std::to_string(i);
-        if (cmd.hasOption(test)) {
-            playersCmd.push_back(cmd.getOptionValue(test));
-
-            logString = "Player ";
-            logString += std::to_string(i) + " file set to ";
-            logString += playersCmd.back() + ".";
-            logger.addLog(Level::INFO, logString);
-        }
-    }
-
-    // Games count
-    int n = cmd.hasOption("-n") ? std::stoi(cmd.getOptionValue("-n")) : 1;
-
-    logString = "Number of games to play: ";
-    logString += std::to_string(n) + ".";
-    logger.addLog(Level::INFO, logString);
-
-    //Visualizer File
-    std::string visualizerFile = cmd.hasOption("-v") ? cmd.getOptionValue("-v") : "";
-
-    if (visualizerFile != "") {
-        logString = "Visualizer File set to: ";
-        logString += visualizerFile + ". Visualizer use not implemented.";
-        logger.addLog(Level::WARN, logString);
-    }
-
-    // Thread count
-    int t = (cmd.hasOption("-n") && !cmd.hasOption("-v")) ? std::stoi(cmd.getOptionValue("-t")) : 1;
-
-    logString = "Number of threads to spawn: ";
-    logString = logString + std::to_string(t);
-    logString = logString + ".";
-    logger.addLog(Level::INFO, logString);
-
-    // Logs Directory
-    std::string dir = cmd.hasOption("-d") ? cmd.getOptionValue("-d") : "";
-
-    if (dir == "") {
-        logger.addLog(Level::WARN, "No output directory set, logs will not be saved");
-    }
-    else {
-        logger.setOutputPath(dir);
-        logger.setOutputFile("MasterLog.txt");
-        logString = "Log Directory: ";
-        logString = logString + dir;
-        logString = logString + ".";
-        logger.addLog(Level::INFO, logString);
-    }
-
-    // swap?
-    bool swap = cmd.hasOption("-s");
-
-    logString = "Swap flag set to: ";
-    logString = logString + ((swap) ? "true" : "false");
-    logString = logString + ".";
-    logger.addLog(Level::INFO, logString);
-
-    //Seed Initialization
-    Mutable<SeedGenerator> seeder = Mutable<SeedGenerator>(SeedGenerator());
-    SeedGenerator& mSeeder = seeder.get();
-    if (cmd.hasOption("-i")) {
-        long newSeed = std::stoi(cmd.getOptionValue("i"));
-        mSeeder.initialSeed(newSeed);
-
-        logString = "Initial seed: ";
-        logString = logString + std::to_string(newSeed);
-        logString = logString + ".";
-        logger.addLog(Level::INFO, logString);
-    }
-    else {
-        mSeeder.noInitialSeed();
-        logger.addLog(Level::INFO, "No initial seed");
-    }
-
-    //old mode?
-    bool old = cmd.hasOption("-o");
-
-    logString = "Old flag set to: ";
-    logString = logString + ((old) ? "true" : "false");
-    logString = logString + ".";
-    logger.addLog(Level::INFO, logString);
-
-    // Prepare stats objects
-    int size = (int)playersCmd.size();
-    Mutable<PlayerStats> playerStats = Mutable<PlayerStats>(PlayerStats(size));
-    Mutable<int> count = Mutable<int>(0);
-
-    logString = "Player Stats initialized with size: ";
-    logString = logString + std::to_string(size);
-    logString = logString + ".";
-    logger.addLog(Level::INFO, logString);
-
-    bool allDone = false;
-
-    if (old) {
-        std::vector<OldGameThread*> threads;
-        for (int i = 0; i < t; ++i) {
-            threads.push_back(new OldGameThread(i + 1, refereeCmd, playersCmd, count, playerStats, seeder, n, swap, logger.getVerbosity(), dir, "GameLog.txt"));
-        }
-        for (int i = 0; i < t; ++i) {
-            if (!threads[i]->start()) {
-                logger.addLog(Level::FATAL, "Unable to start game.");
-                finished(playerStats.get(), logger);
-            }
-        }
-        while (!allDone) {
-            bool done = true; //assume the threads are done
-            for (int i = 0; i < t; ++i) {
-                if (!threads[i]->isFinished()) done = false; //if one is not, we are not done. 
-            }
-            allDone = done; //set allDone flag
-        }
-        for (int i = 0; i < t; ++i) {
-            logger.appendLogs(threads[i]->getLog()); //append the logs from the threads
-            
-        }
-        for (int i = 0; i < t; ++i) {
-            delete threads[i]; //cleanup        
-        }
-        threads.clear();
-    }
-    else {
-        std::vector<GameThread*> threads;
-        for (int i = 0; i < t; ++i) {
-            threads.push_back(new GameThread(i + 1, refereeCmd, playersCmd, count, playerStats, seeder, n, swap, logger.getVerbosity(), dir, "GameLog.txt"));
-            threads[i]->start();
-            logger.addLog(Level::INFO, "Referee thread started started");
-        }
-        while (!allDone) {
-            bool done = true; //assume the threads are done
-            for (int i = 0; i < t; ++i) {
-                if (!threads[i]->isFinished()) done = false;  //if one is not, we are not done. 
-            }
-            allDone = done;  //set allDone flag
-        }
-        for (int i = 0; i < t; ++i) {
-            logger.appendLogs(threads[i]->getLog()); //append the logs from the threads
-        }
-        for (int i = 0; i < t; ++i) {
-            delete threads[i]; //cleanup
-        }
-        threads.clear();
-    }
-    finished(playerStats.get(), logger);
-}
+#include "Mutable.h"
+#include "CommandCLI.h"
+#include "Logger.h"
+#include "SeedGenerator.h"
+#include "PlayerStats.h"
+#include "ResultsJournal.h"
+#include "ResultCache.h"
+#include "Reaper.h"
+#include "OldGameThread.h"
+#include "GameThread.h"
+#include "PluginGameThread.h"
+#include "GauntletScheduler.h"
+#include "LeagueScheduler.h"
+#include "ABScheduler.h"
+#include "TuneScheduler.h"
+#include "FixedScheduler.h"
+#include "RemoteScheduler.h"
+#include "Coordinator.h"
+#include "JobScheduler.h"
+#include "Daemon.h"
+#include "WatchScheduler.h"
+#include "Watcher.h"
+#include "Trace.h"
+#include "MetricsServer.h"
+#include "GameLogWriter.h"
+#include "GameArchive.h"
+#include "ReplayMover.h"
+
+LONG WINAPI GlobalSEHHandler(EXCEPTION_POINTERS* ExceptionInfo) {
+    std::cout << "Exception occurred" << std::endl;
+    return EXCEPTION_EXECUTE_HANDLER;
+}
+
+using namespace CommandCLI;
+
+void finished(PlayerStats stats, Logger log, Tracer* tracer = NULL) {
+    stats.print();
+    stats.printUsage();
+    bool saved = false;
+    {
+        TraceSpan span(tracer != NULL ? tracer->openBuffer("Main") : NULL, "log flush", 0);
+        if (log.getPath() != "" && log.getFile() != "") saved = log.SaveLogs();
+    }
+    if (!saved) {
+        std::cout << "Warning: Logs not Saved!" << std::endl;
+    }
+    if (tracer != NULL && !tracer->write()) {
+        std::cout << "Warning: Trace not Saved!" << std::endl;
+    }
+    exit(0);
+}
+
+int main(int argc, char* argv[]) {
+    SetUnhandledExceptionFilter(GlobalSEHHandler);
+
+    Options opt = Options();
+    opt.Add("-h", false, "Displays this help.");
+    opt.Add("-r", true, "Required, except for a coordinator. Referee command line.");
+    opt.Add("-p1", true, "Required, except in league mode and for a worker. Player 1 command line.");
+    opt.Add("-p2", true, "Required, except in gauntlet, league and tune modes and for a worker. Player 2 command line.");
+    opt.Add("-P3", true, "Player 3 command line.");
+    opt.Add("-P4", true, "Player 4 command line.");
+    opt.Add("-v", true, "Visualizer command line. Not implemented, hard sets threads to 1.");
+    opt.Add("-t", true, "Number of threads to spawn for the games. Default 1.");
+    opt.Add("-n", true, "Number of games to play. Default 1.");
+    opt.Add("-s", false, "Swap player positions.");
+    opt.Add("-i", true, "Initial seed. For repetable tests");
+    opt.Add("-d", true, "Log directory. Per player resource usage is journaled in old mode and with -ip, only the referee's in new mode.");
+    opt.Add("-l", true, "Log level. 0 verbose, 1 info, 2 warning (default), 3 error, and 4 fatal. Only logs that level and higher. ex. if set to 3, only error and fatal levels logs are created.");
+    opt.Add("-o", false, "Old mode");
+    opt.Add("-ip", false, "In-process referee. -r is the path of a referee plugin DLL, see RefereePluginApi.h.");
+    opt.Add("-m", true, "Memory limit of each player in MB, ex. 768 like CodinGame. Old mode and -ip only.");
+    opt.Add("-c", true, "CPU time limit of each player in seconds per game. Old mode and -ip only.");
+    opt.Add("-mp", true, "Maximum number of processes each player may run, itself included. Old mode and -ip only.");
+    opt.Add("-shm", false, "Offer each player a shared memory channel instead of stdin/stdout, see ShmChannel.h. Old mode and in-process referee only.");
+    opt.Add("-timeout", true, "Time in ms a player gets to reply to each turn, it gets no more turns after missing one. Default 30000. Old mode and -ip only.");
+    opt.Add("-cache", true, "Result cache directory. Games already played with the same referee, players, seed and rotation are not played again. Needs -s or -i.");
+    opt.Add("-nd", false, "The bots are nondeterministic, do not use the result cache.");
+    opt.Add("-gauntlet", true, "Gauntlet mode. File of opponent command lines, one per line, -p1 plays each of them. -n is the most games to play.");
+    opt.Add("-ci", true, "Gauntlet mode. Stop once the 95% interval against every opponent is this many percent wide on each side, ex. 5.");
+    opt.Add("-league", true, "League mode. File of bot command lines, one per line, all rated against each other. -p1 to -P4 join them. -n is the number of games.");
+    opt.Add("-lineup", true, "League and daemon modes. Number of players per game, 2 to 4. Default 2.");
+    opt.Add("-ab", true, "A/B mode. File of opponent command lines, one per line. -p1 (A) and -p2 (B) play the same seeds and seats against them. -n is the most games to play.");
+    opt.Add("-sprt", true, "A/B mode. Stop once a sequential test decides if B beats A by this many percent, ex. 5.");
+    opt.Add("-tune", true, "Tune mode. File of parameters, one \"name start min max step [rate]\" per line. -p1 has {name} where each value goes and plays itself. -n is the number of games.");
+    opt.Add("-serve", true, "Coordinator mode. TCP port to hand the games out on, to workers instead of local threads.");
+    opt.Add("-worker", true, "Worker mode. host:port of a coordinator to play games for, with -t threads. The players come from the coordinator.");
+    opt.Add("-bind", true, "IPv4 address the coordinator listens on, ex. 0.0.0.0 for every interface. Default 127.0.0.1, this machine only.");
+    opt.Add("-token", true, "Shared secret a worker must give the coordinator before it gets any game. Needed with -serve and -worker.");
+    opt.Add("-daemon", true, "Daemon mode. Named pipe to take jobs on from -job, the threads and the cache stay up between jobs.");
+    opt.Add("-job", true, "Named pipe of a daemon to send this run to, instead of playing it here.");
+    opt.Add("-stop", false, "With -job, asks the daemon to finish its jobs and exit.");
+    opt.Add("-watch", false, "Watch mode. Replays the same seeds for every new build of a player's files, the seeds -p1 lost first, until q is pressed. -n is the number of seeds.");
+    opt.Add("-trace", true, "File in the log directory to write a timeline of the games to, spawns, exchanges and waits per thread. Open it in chrome://tracing or Perfetto.");
+    opt.Add("-metrics", true, "TCP port on localhost to serve live metrics on, in the Prometheus text format at /metrics.");
+    opt.Add("-logcap", true, "Size cap in KB of each game's log in the log directory, the lines over it are dropped. Default 1024.");
+    opt.Add("-archive", false, "Compress the game logs into Games<k>.archive in the log directory, instead of a file per game.");
+    opt.Add("-extract", true, "Writes the files of this game back to the log directory, from its archive. Nothing is played.");
+    opt.Add("-stage", true, "Directory the referee writes its replay to, ex. a RAM disk or %TEMP%, moved to the log directory once the referee is gone. New mode only.");
+    opt.Add("-fields", true, "Comma separated fields of the referee's replay to journal for each game, ex. scores.*,summaries.*. New mode only.");
+    opt.Add("-g", true, "Grace period in ms for a game's processes to exit once it is over, before they are killed. Default 100.");
+
+    DefaultParser cmd = DefaultParser(argc, argv, opt);
+
+    // Need help ?
+    bool league = cmd.hasOption("-league");
+    bool tune = cmd.hasOption("-tune");
+    bool serve = cmd.hasOption("-serve");
+    bool worker = cmd.hasOption("-worker");
+    bool daemon = cmd.hasOption("-daemon");
+    bool noRun = daemon || (cmd.hasOption("-job") && cmd.hasOption("-stop")) || cmd.hasOption("-extract"); //nothing to play of its own
+    if (cmd.hasOption("-h") || (!cmd.hasOption("-r") && !serve && !noRun) || (!cmd.hasOption("-p1") && !league && !worker && !noRun) || (!cmd.hasOption("-p2") && !cmd.hasOption("-gauntlet") && !league && !tune && !worker && !noRun)) {
+        opt.PrintHelp(argv[0]);
+        exit(0);
+    }
+
+    //setup logging
+    Logger logger = cmd.hasOption("-l") ? Logger((Level)std::stoi(cmd.getOptionValue("-l"))) : Logger();
+
+    std::string level = Logger::levelToString(logger.getVerbosity());
+
+    std::string logString = "Logger set up with level ";
+    logString += level + " logging.";
+    logger.addLog(Level::INFO, logString);
+
+    // Unpack a game from the archive, nothing else to do
+    if (cmd.hasOption("-extract")) {
+        std::string dir = cmd.hasOption("-d") ? cmd.getOptionValue("-d") : "";
+        int game = std::stoi(cmd.getOptionValue("-extract"));
+        int files = GameArchive::extract(dir, game, logger);
+        if (files == 0) {
+            std::cout << "Game " << game << " is not in the archive of " << (dir == "" ? "." : dir) << "." << std::endl;
+            exit(1);
+        }
+        std::cout << files << " files of game " << game << " extracted." << std::endl;
+        exit(0);
+    }
+
+    std::string refereeCmd = cmd.getOptionValue("-r");
+
+    // Players command lines
+    std::vector<std::string> playersCmd;
+    std::string test = "";
+    for (int i = 1; i <= 4; ++i) {
+        test = "-p" + std::to_string(i);
+        if (cmd.hasOption(test)) {
+            playersCmd.push_back(cmd.getOptionValue(test));
+
+            logString = "Player ";
+            logString += std::to_string(i) + " file set to ";
+            logString += playersCmd.back() + ".";
+            logger.addLog(Level::INFO, logString);
+        }
+    }
+
+    // Gauntlet, -p1 against a pool, the other players join the pool
+    std::unique_ptr<Scheduler> scheduler;
+    std::vector<std::string> pool;
+    if (cmd.hasOption("-gauntlet")) {
+        pool.assign(playersCmd.begin() + 1, playersCmd.end());
+        if (!Scheduler::readPool(cmd.getOptionValue("-gauntlet"), pool) || pool.empty()) {
+            logger.addLog(Level::FATAL, "Cannot read the opponents of the gauntlet from " + cmd.getOptionValue("-gauntlet") + ".");
+            finished(PlayerStats(), logger);
+        }
+        playersCmd.resize(1);
+        playersCmd.push_back(pool.front());
+
+        logString = "Gauntlet of " + playersCmd.front();
+        logString += " against " + std::to_string(pool.size()) + " opponents.";
+        logger.addLog(Level::INFO, logString);
+    }
+
+    // A/B, -p1 and -p2 against the same pool on the same games
+    bool ab = cmd.hasOption("-ab");
+    std::vector<std::string> candidates;
+    if (ab) {
+        candidates.assign(playersCmd.begin(), playersCmd.begin() + 2);
+        pool.assign(playersCmd.begin() + 2, playersCmd.end());
+        if (!Scheduler::readPool(cmd.getOptionValue("-ab"), pool) || pool.empty()) {
+            logger.addLog(Level::FATAL, "Cannot read the opponents of the A/B comparison from " + cmd.getOptionValue("-ab") + ".");
+            finished(PlayerStats(), logger);
+        }
+        playersCmd.assign({ candidates[0], pool.front() });
+
+        logString = "A/B comparison of " + candidates[0] + " and " + candidates[1];
+        logString += " against " + std::to_string(pool.size()) + " opponents.";
+        logger.addLog(Level::INFO, logString);
+    }
+
+    // League, every bot given rated against the others
+    int lineupSize = cmd.hasOption("-lineup") ? std::stoi(cmd.getOptionValue("-lineup")) : 2;
+    if (league) {
+        pool = playersCmd;
+        if (!Scheduler::readPool(cmd.getOptionValue("-league"), pool) || lineupSize < 2 || lineupSize > 4 || (int)pool.size() < lineupSize) {
+            logger.addLog(Level::FATAL, "Cannot read a league of at least " + std::to_string(lineupSize) + " bots from " + cmd.getOptionValue("-league") + ".");
+            finished(PlayerStats(), logger);
+        }
+        playersCmd.assign(pool.begin(), pool.begin() + lineupSize);
+
+        logString = "League of " + std::to_string(pool.size()) + " bots, ";
+        logString += std::to_string(lineupSize) + " per game.";
+        logger.addLog(Level::INFO, logString);
+    }
+
+    // Tune, -p1 with the parameters filled in against itself
+    std::vector<TuneScheduler::Parameter> parameters;
+    if (tune) {
+        if (!TuneScheduler::readParameters(cmd.getOptionValue("-tune"), parameters)) {
+            logger.addLog(Level::FATAL, "Cannot read the parameters to tune from " + cmd.getOptionValue("-tune") + ".");
+            finished(PlayerStats(), logger);
+        }
+        for (const TuneScheduler::Parameter& parameter : parameters) {
+            if (playersCmd.front().find("{" + parameter.name + "}") == std::string::npos) {
+                logger.addLog(Level::WARN, "Player 1 command line has no {" + parameter.name + "}, tuning it will change nothing.");
+            }
+        }
+        playersCmd.resize(1);
+        playersCmd.push_back(playersCmd.front());
+
+        logString = "Tuning " + std::to_string(parameters.size()) + " parameters of ";
+        logString += playersCmd.front() + ".";
+        logger.addLog(Level::INFO, logString);
+    }
+
+    // Worker, the coordinator hands out the games and their players
+    if (worker) {
+        std::string address = cmd.getOptionValue("-worker");
+        if (!cmd.hasOption("-token")) {
+            logger.addLog(Level::FATAL, "A worker needs the coordinator's -token.");
+            finished(PlayerStats(), logger);
+        }
+        size_t colon = address.rfind(':');
+        RemoteScheduler* remote = new RemoteScheduler();
+        scheduler.reset(remote);
+        if (colon == std::string::npos || !remote->connect(address.substr(0, colon), address.substr(colon + 1), cmd.getOptionValue("-token"))) {
+            logger.addLog(Level::FATAL, "Cannot reach the coordinator at " + address + ".");
+            finished(PlayerStats(), logger);
+        }
+        playersCmd.assign(remote->getPlayersCount(), "");
+
+        logString = "Worker for the coordinator at " + address + ", ";
+        logString += std::to_string(playersCmd.size()) + " players per game.";
+        logger.addLog(Level::INFO, logString);
+    }
+
+    // Games count
+    int n = cmd.hasOption("-n") ? std::stoi(cmd.getOptionValue("-n")) : 1;
+
+    logString = "Number of games to play: ";
+    logString += std::to_string(n) + ".";
+    logger.addLog(Level::INFO, logString);
+
+    //Visualizer File
+    std::string visualizerFile = cmd.hasOption("-v") ? cmd.getOptionValue("-v") : "";
+
+    if (visualizerFile != "") {
+        logString = "Visualizer File set to: ";
+        logString += visualizerFile + ". Visualizer use not implemented.";
+        logger.addLog(Level::WARN, logString);
+    }
+
+    // Thread count
+    int t = ((cmd.hasOption("-n") || worker || daemon) && !cmd.hasOption("-v")) ? std::stoi(cmd.getOptionValue("-t")) : 1;
+
+    logString = "Number of threads to spawn: ";
+    logString = logString + std::to_string(t);
+    logString = logString + ".";
+    logger.addLog(Level::INFO, logString);
+
+    // Logs Directory
+    std::string dir = cmd.hasOption("-d") ? cmd.getOptionValue("-d") : "";
+
+    if (dir == "") {
+        logger.addLog(Level::WARN, "No output directory set, logs will not be saved");
+    }
+    else {
+        logger.setOutputPath(dir);
+        logger.setOutputFile("MasterLog.txt");
+        logString = "Log Directory: ";
+        logString = logString + dir;
+        logString = logString + ".";
+        logger.addLog(Level::INFO, logString);
+    }
+
+    // swap?
+    bool swap = cmd.hasOption("-s");
+
+    logString = "Swap flag set to: ";
+    logString = logString + ((swap) ? "true" : "false");
+    logString = logString + ".";
+    logger.addLog(Level::INFO, logString);
+
+    //Seed Initialization
+    Mutable<SeedGenerator> seeder = Mutable<SeedGenerator>(SeedGenerator());
+    SeedGenerator& mSeeder = seeder.get();
+    if (cmd.hasOption("-i")) {
+        long newSeed = std::stoi(cmd.getOptionValue("i"));
+        mSeeder.initialSeed(newSeed);
+
+        logString = "Initial seed: ";
+        logString = logString + std::to_string(newSeed);
+        logString = logString + ".";
+        logger.addLog(Level::INFO, logString);
+    }
+    else {
+        mSeeder.noInitialSeed();
+        logger.addLog(Level::INFO, "No initial seed");
+    }
+
+    // Job, the run goes to a daemon, which plays it
+    if (cmd.hasOption("-job")) {
+        Job job;
+        job.referee = refereeCmd;
+        job.players = playersCmd;
+        job.n = n;
+        job.swap = swap;
+        job.seeded = cmd.hasOption("-i");
+        if (job.seeded) job.seed = std::stoi(cmd.getOptionValue("-i"));
+
+        PlayerStats stats = PlayerStats((int)playersCmd.size());
+        Daemon::submit(cmd.getOptionValue("-job"), cmd.hasOption("-stop") ? NULL : &job, stats, logger);
+        finished(stats, logger);
+    }
+
+    if (league) {
+        LeagueScheduler* ratings = new LeagueScheduler(pool, seeder, lineupSize, n);
+        if (dir != "") {
+            ratings->setTable(dir, "League.txt");
+            logger.addLog(Level::INFO, "Live league table: " + dir + "/League.txt.");
+        }
+        scheduler.reset(ratings);
+    }
+    else if (tune) {
+        TuneScheduler* tuner = new TuneScheduler(playersCmd.front(), parameters, seeder, n);
+        if (dir != "") {
+            if (tuner->setTrajectory(dir, "Tune.csv")) {
+                logger.addLog(Level::INFO, "Tuning trajectory: " + dir + "/Tune.csv.");
+            }
+            else {
+                logger.addLog(Level::WARN, "Could not open " + dir + "/Tune.csv, the trajectory is not kept.");
+            }
+        }
+        scheduler.reset(tuner);
+    }
+    else if (ab) {
+        double margin = cmd.hasOption("-sprt") ? std::stod(cmd.getOptionValue("-sprt")) / 100.0 : 0.0;
+        scheduler = std::make_unique<ABScheduler>(candidates[0], candidates[1], pool, seeder, n, margin);
+        if (margin > 0.0) {
+            logger.addLog(Level::INFO, std::format("A/B stops once a SPRT decides between B - A = 0 and B - A = {:.2f}%, or after {} games.", margin * 100.0, n));
+        }
+    }
+    else if (!pool.empty()) {
+        double precision = cmd.hasOption("-ci") ? std::stod(cmd.getOptionValue("-ci")) / 100.0 : 0.0;
+        scheduler = std::make_unique<GauntletScheduler>(playersCmd.front(), pool, seeder, n, precision);
+        if (precision > 0.0) {
+            logger.addLog(Level::INFO, std::format("Gauntlet stops at +/- {:.2f}% against every opponent, or after {} games.", precision * 100.0, n));
+        }
+    }
+
+    // Watch, the run is replayed for every new build of the bots
+    bool watch = cmd.hasOption("-watch");
+    std::unique_ptr<Watcher> watcher;
+    if (watch) {
+        watcher = std::make_unique<Watcher>(playersCmd, logger.getVerbosity());
+        std::vector<std::string> commands;
+        if (scheduler != NULL || !watcher->shadow(1, commands)) {
+            logger.addLog(Level::FATAL, "Watch mode replays one lineup, and needs to copy each player's executable next to the tester.");
+            finished(PlayerStats(), logger);
+        }
+        WatchScheduler* builds = new WatchScheduler(commands, seeder, n, swap);
+        scheduler.reset(builds);
+        watcher->setScheduler(builds);
+
+        logString = "Watching " + std::to_string(watcher->getFileCount()) + " files of the players, ";
+        logString += std::to_string(n) + " seeds per build. Press q to stop.";
+        logger.addLog(Level::INFO, logString);
+    }
+
+    // Coordinator, the plain run is handed out as units too
+    if (serve && scheduler == NULL) {
+        scheduler = std::make_unique<FixedScheduler>(playersCmd, seeder, n, swap);
+    }
+
+    //old mode?
+    bool old = cmd.hasOption("-o");
+
+    logString = "Old flag set to: ";
+    logString = logString + ((old) ? "true" : "false");
+    logString = logString + ".";
+    logger.addLog(Level::INFO, logString);
+
+    //in-process referee?
+    bool inProcess = cmd.hasOption("-ip");
+    RefereePlugin plugin;
+    if (inProcess) {
+        if (!plugin.load(refereeCmd)) {
+            logger.addLog(Level::FATAL, "Cannot load the referee plugin: " + plugin.getError());
+            finished(PlayerStats(), logger);
+        }
+        logger.addLog(Level::INFO, "Referee plugin loaded: " + refereeCmd + ".");
+        if (old) {
+            logger.addLog(Level::WARN, "The in-process referee ignores the old mode flag.");
+        }
+    }
+
+    // Resource limits
+    ResourceProfile profile;
+    if (cmd.hasOption("-m")) profile.memoryLimit = std::stoull(cmd.getOptionValue("-m")) * 1024 * 1024;
+    if (cmd.hasOption("-c")) profile.cpuTimeLimit = std::stoull(cmd.getOptionValue("-c")) * 1000;
+    if (cmd.hasOption("-mp")) profile.processLimit = std::stoi(cmd.getOptionValue("-mp"));
+
+    if (!profile.isEmpty()) {
+        logString = "Player limits: memory ";
+        logString += profile.memoryLimit > 0 ? std::to_string(profile.memoryLimit / (1024 * 1024)) + " MB" : "none";
+        logString += ", cpu ";
+        logString += profile.cpuTimeLimit > 0 ? std::to_string(profile.cpuTimeLimit / 1000) + " s" : "none";
+        logString += ", processes ";
+        logString += profile.processLimit > 0 ? std::to_string(profile.processLimit) : "none";
+        logString += ".";
+        logger.addLog(Level::INFO, logString);
+
+        if (!old && !inProcess) {
+            logger.addLog(Level::WARN, "Player limits only apply in old mode and with an in-process referee, the referee spawns the players in the new mode.");
+        }
+    }
+
+    // Shared memory channels
+    bool sharedMemory = cmd.hasOption("-shm");
+    if (sharedMemory) {
+        logger.addLog(Level::INFO, "Players are offered a shared memory channel.");
+        if (!old && !inProcess) {
+            logger.addLog(Level::WARN, "Shared memory channels only apply in old mode and with an in-process referee, the referee spawns the players in the new mode.");
+        }
+    }
+
+    // Reply timeout
+    DWORD replyTimeout = cmd.hasOption("-timeout") ? (DWORD)std::stoul(cmd.getOptionValue("-timeout")) : Process::TIMEOUT;
+    if (cmd.hasOption("-timeout")) {
+        logger.addLog(Level::INFO, "Players get " + std::to_string(replyTimeout) + " ms to reply to each turn.");
+        if (!old && !inProcess) {
+            logger.addLog(Level::WARN, "The reply timeout only applies in old mode and with an in-process referee, the referee times the players in the new mode.");
+        }
+    }
+
+    // Daemon, the game threads play the jobs of every client
+    std::unique_ptr<Daemon> daemonServer;
+    if (daemon) {
+        JobScheduler* queue = new JobScheduler();
+        scheduler.reset(queue);
+        playersCmd.assign(lineupSize, "");
+        daemonServer = std::make_unique<Daemon>(*queue, cmd.getOptionValue("-daemon"), lineupSize, inProcess, logger.getVerbosity());
+
+        logString = "Daemon taking jobs of " + std::to_string(lineupSize) + " players on \\\\.\\pipe\\";
+        logString += cmd.getOptionValue("-daemon") + ", stop it with -job " + cmd.getOptionValue("-daemon") + " -stop.";
+        logger.addLog(Level::INFO, logString);
+    }
+
+    // Result cache
+    ResultCache cache;
+    if (cmd.hasOption("-cache")) {
+        std::string cacheDir = cmd.getOptionValue("-cache");
+        if (cmd.hasOption("-nd")) {
+            logger.addLog(Level::INFO, "The bots are nondeterministic, the result cache is not used.");
+        }
+        else {
+            //anything besides the binaries and the seed that changes the outcome
+            std::string context = inProcess ? "plugin" : (old ? "old" : "new");
+            context += " memory " + std::to_string(profile.memoryLimit);
+            context += " cpu " + std::to_string(profile.cpuTimeLimit);
+            context += " processes " + std::to_string(profile.processLimit);
+
+            std::vector<std::string> bots = playersCmd;
+            if (!league) bots.insert(bots.end(), pool.begin(), pool.end());
+            bots.insert(bots.end(), candidates.begin(), candidates.end());
+            if (cache.open(cacheDir, refereeCmd, bots, context)) {
+                logger.addLog(Level::INFO, "Result cache: " + cacheDir + ".");
+            }
+            else {
+                logger.addLog(Level::WARN, "Could not open the result cache, every game will be played.");
+            }
+
+            if (!inProcess && !swap && !cmd.hasOption("-i") && scheduler == NULL) {
+                logger.addLog(Level::WARN, "Without -s or -i the referee picks the seeds, no game can be cached.");
+            }
+        }
+    }
+    ResultCache* sharedCache = cache.isOpen() ? &cache : NULL;
+    if (daemonServer != NULL) {
+        daemonServer->setResultCache(sharedCache);
+        daemonServer->start();
+    }
+    if (watcher != NULL) {
+        watcher->setResultCache(sharedCache);
+        watcher->start();
+    }
+
+    // Prepare stats objects
+    int size = (int)playersCmd.size();
+    Mutable<PlayerStats> playerStats = Mutable<PlayerStats>(PlayerStats(size));
+    Mutable<int> count = Mutable<int>(0);
+
+    // Results journal, one record per game and player next to the logs
+    ResultsJournal journal;
+    if (dir != "") {
+        if (journal.open(dir, "Results.journal")) {
+            logger.addLog(Level::INFO, "Results journal: " + dir + "/Results.journal.");
+        }
+        else {
+            logger.addLog(Level::WARN, "Could not open the results journal, results will not be journaled.");
+        }
+    }
+
+    // Each game's log in its own file, written while the games are played
+    std::unique_ptr<GameLogWriter> gameLogs;
+    std::unique_ptr<GameArchive> archive;
+    if (dir != "") {
+        int cap = cmd.hasOption("-logcap") ? std::stoi(cmd.getOptionValue("-logcap")) : 1024;
+        gameLogs = std::make_unique<GameLogWriter>((size_t)cap * 1024, logger.getVerbosity());
+        if (cmd.hasOption("-archive")) {
+            archive = std::make_unique<GameArchive>();
+            if (archive->open(dir)) {
+                gameLogs->setArchive(archive.get());
+            }
+            else {
+                logger.addLog(Level::WARN, "Could not open the game archive, each game's log gets its own file.");
+                archive.reset();
+            }
+        }
+        if (gameLogs->open(dir)) {
+            gameLogs->start();
+            if (archive != NULL) logger.addLog(Level::INFO, "Game logs: " + dir + "/Games<k>.archive, up to " + std::to_string(cap) + " KB per game before compression.");
+            else logger.addLog(Level::INFO, "Game logs: " + dir + "/Game<n>.log, up to " + std::to_string(cap) + " KB each.");
+        }
+        else {
+            logger.addLog(Level::WARN, "Could not find the log directory, the game logs are kept for the master log.");
+            gameLogs.reset();
+        }
+    }
+
+    // Timeline of the game threads, written at exit
+    std::unique_ptr<Tracer> tracer;
+    TraceBuffer* mainTrace = NULL;
+    if (cmd.hasOption("-trace")) {
+        tracer = std::make_unique<Tracer>();
+        if (tracer->open(dir, cmd.getOptionValue("-trace"))) {
+            mainTrace = tracer->openBuffer("Main");
+            logger.addLog(Level::INFO, "Trace: " + dir + "/" + cmd.getOptionValue("-trace") + ".");
+        }
+        else {
+            logger.addLog(Level::WARN, "Could not open the trace file, the run will not be traced.");
+            tracer.reset();
+        }
+    }
+
+    // Live metrics of the game threads, for a local collector to scrape
+    std::unique_ptr<Metrics> metrics;
+    std::unique_ptr<MetricsServer> metricsServer;
+    if (cmd.hasOption("-metrics")) {
+        int port = std::stoi(cmd.getOptionValue("-metrics"));
+        metrics = std::make_unique<Metrics>(size);
+        metricsServer = std::make_unique<MetricsServer>(*metrics, logger.getVerbosity());
+        if (metricsServer->listen(port)) {
+            metricsServer->start();
+            logger.addLog(Level::INFO, "Metrics: http://localhost:" + std::to_string(port) + "/metrics.");
+        }
+        else {
+            logger.addLog(Level::WARN, "Cannot serve the metrics on port " + std::to_string(port) + ", the run goes on without them.");
+            metricsServer.reset();
+            metrics.reset();
+        }
+    }
+
+    logString = "Player Stats initialized with size: ";
+    logString = logString + std::to_string(size);
+    logString = logString + ".";
+    logger.addLog(Level::INFO, logString);
+
+    // Teardown thread, shared by all games
+    int grace = cmd.hasOption("-g") ? std::stoi(cmd.getOptionValue("-g")) : 100;
+    Reaper reaper = Reaper(journal, grace, logger.getVerbosity());
+
+    // Referee replays staged on a fast disk, or next to the logs for the archive, and moved in the background
+    std::unique_ptr<ReplayMover> replays;
+    if (dir != "" && !old && !inProcess && (cmd.hasOption("-stage") || archive != NULL || cmd.hasOption("-fields"))) {
+        std::string staging = cmd.hasOption("-stage") ? cmd.getOptionValue("-stage") : dir;
+        //each thread may have one replay being written and one waiting for its referee to go
+        replays = std::make_unique<ReplayMover>(journal, (size_t)(t * 2), logger.getVerbosity());
+        if (replays->open(staging, dir)) {
+            replays->setGameLogs(gameLogs.get());
+            if (cmd.hasOption("-fields")) {
+                std::vector<std::string> fields;
+                std::stringstream list(cmd.getOptionValue("-fields"));
+                std::string field;
+                while (std::getline(list, field, ',')) fields.push_back(field);
+                replays->setFields(fields);
+                logger.addLog(Level::INFO, "Replay fields journaled: " + cmd.getOptionValue("-fields") + ".");
+            }
+            replays->start();
+            reaper.setReplayMover(replays.get());
+            logger.addLog(Level::INFO, "Replays staged in " + staging + ".");
+        }
+        else {
+            logger.addLog(Level::WARN, "Could not create the staging directory in " + staging + ", the referee writes its replay to the log directory.");
+            replays.reset();
+        }
+    }
+    else if (cmd.hasOption("-stage") || cmd.hasOption("-fields")) {
+        logger.addLog(Level::WARN, "Staging the replays and journaling their fields need -d and only apply in the new mode.");
+    }
+    reaper.start();
+
+    logString = "Teardown grace period: ";
+    logString += std::to_string(grace) + " ms.";
+    logger.addLog(Level::INFO, logString);
+
+    bool allDone = false;
+
+    if (serve) {
+        int port = std::stoi(cmd.getOptionValue("-serve"));
+        std::string bind = cmd.hasOption("-bind") ? cmd.getOptionValue("-bind") : "127.0.0.1";
+        if (!cmd.hasOption("-token") || cmd.getOptionValue("-token") == "") {
+            logger.addLog(Level::FATAL, "A coordinator needs a -token for its workers to give.");
+            finished(playerStats.get(), logger);
+        }
+        Coordinator coordinator = Coordinator(*scheduler, playerStats, size, cmd.getOptionValue("-token"), logger.getVerbosity());
+        if (!coordinator.listen(bind, port)) {
+            logger.addLog(Level::FATAL, "Cannot listen for workers on " + bind + ":" + std::to_string(port) + ".");
+            finished(playerStats.get(), logger);
+        }
+        logger.addLog(Level::INFO, "Coordinator listening on " + bind + ":" + std::to_string(port) + ", start the workers with -worker <host>:" + std::to_string(port) + " and the same -token.");
+        coordinator.start();
+        while (!coordinator.isFinished()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        logger.appendLogs(coordinator.getLog());
+    }
+    else if (inProcess) {
+        std::vector<PluginGameThread*> threads;
+        for (int i = 0; i < t; ++i) {
+            threads.push_back(new PluginGameThread(i + 1, plugin, refereeCmd, playersCmd, count, playerStats, seeder, journal, reaper, n, swap, logger.getVerbosity(), dir, "GameLog.txt"));
+            threads.back()->setResourceProfile(profile);
+            threads.back()->setSharedMemory(sharedMemory);
+            threads.back()->setReplyTimeout(replyTimeout);
+            threads.back()->setResultCache(sharedCache);
+            threads.back()->setScheduler(scheduler.get());
+            if (tracer != NULL) threads.back()->setTrace(tracer->openBuffer("Game thread " + std::to_string(i + 1)));
+            threads.back()->setMetrics(metrics.get());
+            threads.back()->setGameLogs(gameLogs.get());
+            if (watcher != NULL) watcher->addThread(threads.back());
+        }
+        for (int i = 0; i < t; ++i) {
+            if (!threads[i]->start()) {
+                logger.addLog(Level::FATAL, "Unable to start game.");
+                finished(playerStats.get(), logger);
+            }
+        }
+        while (!allDone) {
+            bool done = true; //assume the threads are done
+            for (int i = 0; i < t; ++i) {
+                if (!threads[i]->isFinished()) done = false; //if one is not, we are not done. 
+            }
+            allDone = done; //set allDone flag
+        }
+        TraceSpan merge(mainTrace, "log merge", 0);
+        for (int i = 0; i < t; ++i) {
+            logger.appendLogs(threads[i]->getLog()); //append the logs from the threads
+        }
+        merge.end();
+        for (int i = 0; i < t; ++i) {
+            delete threads[i]; //cleanup        
+        }
+        threads.clear();
+    }
+    else if (old) {
+        std::vector<OldGameThread*> threads;
+        for (int i = 0; i < t; ++i) {
+            threads.push_back(new OldGameThread(i + 1, refereeCmd, playersCmd, count, playerStats, seeder, journal, reaper, n, swap, logger.getVerbosity(), dir, "GameLog.txt"));
+            threads.back()->setResourceProfile(profile);
+            threads.back()->setSharedMemory(sharedMemory);
+            threads.back()->setReplyTimeout(replyTimeout);
+            threads.back()->setResultCache(sharedCache);
+            threads.back()->setScheduler(scheduler.get());
+            if (tracer != NULL) threads.back()->setTrace(tracer->openBuffer("Game thread " + std::to_string(i + 1)));
+            threads.back()->setMetrics(metrics.get());
+            threads.back()->setGameLogs(gameLogs.get());
+            if (watcher != NULL) watcher->addThread(threads.back());
+        }
+        for (int i = 0; i < t; ++i) {
+            if (!threads[i]->start()) {
+                logger.addLog(Level::FATAL, "Unable to start game.");
+                finished(playerStats.get(), logger);
+            }
+        }
+        while (!allDone) {
+            bool done = true; //assume the threads are done
+            for (int i = 0; i < t; ++i) {
+                if (!threads[i]->isFinished()) done = false; //if one is not, we are not done. 
+            }
+            allDone = done; //set allDone flag
+        }
+        TraceSpan merge(mainTrace, "log merge", 0);
+        for (int i = 0; i < t; ++i) {
+            logger.appendLogs(threads[i]->getLog()); //append the logs from the threads
+            
+        }
+        merge.end();
+        for (int i = 0; i < t; ++i) {
+            delete threads[i]; //cleanup        
+        }
+        threads.clear();
+    }
+    else {
+        std::vector<GameThread*> threads;
+        for (int i = 0; i < t; ++i) {
+            threads.push_back(new GameThread(i + 1, refereeCmd, playersCmd, count, playerStats, seeder, journal, reaper, n, swap, logger.getVerbosity(), dir, "GameLog.txt"));
+            threads[i]->setResultCache(sharedCache);
+            threads[i]->setScheduler(scheduler.get());
+            if (tracer != NULL) threads[i]->setTrace(tracer->openBuffer("Game thread " + std::to_string(i + 1)));
+            threads[i]->setMetrics(metrics.get());
+            threads[i]->setGameLogs(gameLogs.get());
+            threads[i]->setReplayMover(replays.get());
+            if (watcher != NULL) watcher->addThread(threads[i]);
+            threads[i]->start();
+            logger.addLog(Level::INFO, "Referee thread started started");
+        }
+        while (!allDone) {
+            bool done = true; //assume the threads are done
+            for (int i = 0; i < t; ++i) {
+                if (!threads[i]->isFinished()) done = false;  //if one is not, we are not done. 
+            }
+            allDone = done;  //set allDone flag
+        }
+        TraceSpan merge(mainTrace, "log merge", 0);
+        for (int i = 0; i < t; ++i) {
+            logger.appendLogs(threads[i]->getLog()); //append the logs from the threads
+        }
+        merge.end();
+        for (int i = 0; i < t; ++i) {
+            delete threads[i]; //cleanup
+        }
+        threads.clear();
+    }
+
+    if (daemonServer != NULL) {
+        //the threads only end once the daemon took its shutdown
+        while (!daemonServer->isFinished()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        logger.appendLogs(daemonServer->getLog());
+    }
+    if (watcher != NULL) {
+        while (!watcher->isFinished()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        logger.appendLogs(watcher->getLog());
+    }
+
+    // Let the last games' processes go
+    reaper.shutdown();
+    while (!reaper.isFinished()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    logger.appendLogs(reaper.getLog());
+
+    // The Reaper handed over every game, the last replays go before the archive closes
+    if (replays != NULL) {
+        replays->shutdown();
+        while (!replays->isFinished()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        logger.appendLogs(replays->getLog());
+    }
+
+    if (gameLogs != NULL) {
+        gameLogs->shutdown();
+        while (!gameLogs->isFinished()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        logger.appendLogs(gameLogs->getLog());
+    }
+    if (archive != NULL) {
+        //the index footer, finished() exits without running the destructors
+        archive->close();
+    }
+
+    if (metricsServer != NULL) {
+        metricsServer->stop();
+        while (!metricsServer->isFinished()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        logger.appendLogs(metricsServer->getLog());
+    }
+
+    if (cache.isOpen()) {
+        logString = "Result cache: " + std::to_string(cache.getHits()) + " games reused, ";
+        logString += std::to_string(cache.getMisses()) + " played.";
+        logger.addLog(Level::INFO, logString);
+    }
+
+    if (scheduler != NULL) {
+        scheduler->print();
+    }
+
+    //the league's lineups change every game, A/B mixes both candidates in player 1 and tune plays one bot against itself, a table by player would mean nothing
+    //a worker only saw its share of the games, the coordinator prints the table, and each client of a daemon its own
+    //watch mode mixes every build in the table, its own progress lines compare them
+    finished(league || ab || tune || worker || daemon || watch ? PlayerStats() : playerStats.get(), logger, tracer.get());
+}
@@ -0,0 +1,126 @@
+#define REFEREE_PLUGIN_EXPORTS
+#include <string>
+#include <vector>
+#include <random>
+#include <charconv>
+#include "../RefereePluginApi.h"
+
+/*
+ * A sample in-process referee: guess the number.
+ *
+ * The referee draws a number from 1 to 1000 with the game's seed. On each turn a player gets one line, "start" on its
+ * first turn, then "higher" or "lower" for its last guess, and answers one line with its next guess. Players play in
+ * turn until they found the number or MAX_TURNS is over. The sooner a player finds it, the higher its score; a player
+ * that timed out or answered something else than a number is out with a score of 0.
+ */
+
+namespace {
+    const int MAX_TURNS = 20;       //< guesses per player
+    const int MAX_NUMBER = 1000;    //< the number is from 1 to MAX_NUMBER
+}
+
+struct RefereeGame {
+    int players;                    //< the number of players
+    int target;                     //< the number to guess
+    int current;                    //< the player whose turn it is
+    int turn;                       //< the turn number, starting at 0
+    std::vector<int> foundAt;       //< the turn each player found the number, -1 if not yet
+    std::vector<bool> out;          //< has the player been disqualified?
+    std::vector<std::string> hint;  //< the next input of each player
+    std::string input;              //< the buffer handed out by referee_next_input
+};
+
+namespace {
+    bool isPlaying(const RefereeGame* game, int player) {
+        return game->foundAt[player] < 0 && !game->out[player];
+    }
+}
+
+extern "C" {
+
+REFEREE_API int referee_abi_version(void) {
+    return REFEREE_ABI_VERSION;
+}
+
+REFEREE_API RefereeGame* referee_init(long long seed, int players) {
+    if (players < 1 || players > 4) {
+        return NULL;
+    }
+
+    RefereeGame* game = new RefereeGame();
+    std::mt19937_64 rng((unsigned long long)seed);
+    game->players = players;
+    game->target = (int)(rng() % MAX_NUMBER) + 1;
+    game->current = 0;
+    game->turn = 0;
+    game->foundAt.assign(players, -1);
+    game->out.assign(players, false);
+    game->hint.assign(players, "start");
+    return game;
+}
+
+REFEREE_API int referee_next_player(RefereeGame* game) {
+    //round robin over the players still guessing
+    while (game->turn < MAX_TURNS) {
+        for (; game->current < game->players; ++game->current) {
+            if (isPlaying(game, game->current)) {
+                return game->current;
+            }
+        }
+        game->current = 0;
+        game->turn++;
+    }
+    return -1;
+}
+
+REFEREE_API int referee_next_input(RefereeGame* game, int player, const char** input, size_t* length) {
+    if (player < 0 || player >= game->players) {
+        return -1;
+    }
+    game->input = game->hint[player] + "\n";
+    *input = game->input.data();
+    *length = game->input.size();
+    return 1;
+}
+
+REFEREE_API int referee_submit_output(RefereeGame* game, int player, const char* output, size_t length) {
+    if (player < 0 || player >= game->players) {
+        return 1;
+    }
+    //the turn passes to the next player whatever the answer
+    game->current = player + 1;
+
+    int guess = 0;
+    if (output == NULL) {
+        game->out[player] = true;
+        return 1;
+    }
+    std::string_view line(output, length);
+    if (line.ends_with('\n')) line.remove_suffix(1);
+    auto [end, error] = std::from_chars(line.data(), line.data() + line.size(), guess);
+    if (error != std::errc() || end != line.data() + line.size()) {
+        game->out[player] = true;
+        return 1;
+    }
+
+    if (guess == game->target) {
+        game->foundAt[player] = game->turn;
+    }
+    else {
+        game->hint[player] = guess < game->target ? "higher" : "lower";
+    }
+    return 0;
+}
+
+REFEREE_API int referee_result(RefereeGame* game, int* scores, int players) {
+    for (int i = 0; i < players && i < game->players; ++i) {
+        scores[i] = game->foundAt[i] < 0 ? 0 : MAX_TURNS - game->foundAt[i];
+    }
+    return 0;
+}
+
+REFEREE_API void referee_free(RefereeGame* game) {
+    delete game;
+}
+
+}